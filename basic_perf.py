@@ -93,12 +93,13 @@ if __name__ == "__main__":
         nb_iter_solver = ls_solver.get_nb_iter()
         timers = ls_solver.get_timers_jacobian()
         (timer_Fx, timer_solve, timer_init, timer_check, 
-        timer_compute_dS, timer_fillJ, timer_compVa_Vm, timer_preproc, timer_total) = timers
+        timer_compute_dS, timer_fillJ, timer_compVa_Vm, timer_preproc, timer_total, nb_factorization) = timers
         print(f"Total time for the powerflow (=pre proc + NR + post proc): {env.backend._grid.timer_last_ac_pf:.2e}s")
         print(f"Total time spent in the Newton Raphson: {timer_total:.2e}s")
         print(f"Time to pre process input data: {timer_preproc:.2e}s")
         print(f"Time to intialize linear solver: {timer_init:.2e}s")
-        print(f"Then for all iterations (cumulated time over all {nb_iter_solver} iterations)")
+        print(f"Then for all iterations (cumulated time over all {nb_iter_solver} iterations, "
+              f"{nb_factorization} factorizations of the jacobian)")
         print(f"\ttotal time to compute dS/dVm and dS/dVa: {timer_compute_dS:.2e}s")
         print(f"\ttotal time fill jacobian matrix (from dS/dVm and dS/dVa): {timer_fillJ:.2e}s")
         print(f"\ttotal time to solve J.x = b: {timer_solve:.2e}s")
@@ -0,0 +1,52 @@
+# Copyright (c) 2024, RTE (https://www.rte-france.com)
+# See AUTHORS.txt
+# This Source Code Form is subject to the terms of the Mozilla Public License, version 2.0.
+# If a copy of the Mozilla Public License, version 2.0 was not distributed with this file,
+# you can obtain one at http://mozilla.org/MPL/2.0/.
+# SPDX-License-Identifier: MPL-2.0
+# This file is part of LightSim2grid, LightSim2grid a implements a c++ backend targeting the Grid2Op platform.
+
+# micro benchmark of the time spent to modify the Ybus (remove then put back the coefficients of the
+# disconnected branches) when performing a full N-1 contingency analysis on the case1888rte
+
+import numpy as np
+import pandapower as pp
+import pandapower.networks as pn
+
+from lightsim2grid.gridmodel import init_from_pandapower
+from lightsim2grid_cpp import ContingencyAnalysisCPP
+from benchmark_solvers import solver_names
+
+NB_RUN = 5
+MAX_ITER = 10
+TOL = 1e-8
+
+
+if __name__ == "__main__":
+    case = pn.case1888rte()
+    pp.runpp(case)
+    grid_model = init_from_pandapower(case)
+    Vinit = np.ones(grid_model.total_bus(), dtype=complex) * case.ext_grid["vm_pu"].values[0]
+    V = grid_model.ac_pf(Vinit, MAX_ITER, TOL)
+    if V.shape[0] == 0:
+        raise RuntimeError("The base powerflow diverged for the case1888rte")
+
+    SA = ContingencyAnalysisCPP(grid_model)
+    SA.add_all_n1()
+    modif_ybus_times = []
+    solver_times = []
+    total_times = []
+    for _ in range(NB_RUN):
+        SA.clear_results_only()
+        SA.compute(V, MAX_ITER, TOL)
+        modif_ybus_times.append(SA.modif_Ybus_time())
+        solver_times.append(SA.solver_time())
+        total_times.append(SA.total_time())
+
+    nb_cont = len(SA.my_defaults())
+    print(f"Solver used: {solver_names[SA.get_solver_type()]}")
+    print(f"Number of contingencies simulated: {nb_cont} ({SA.nb_solved()} powerflows)")
+    print(f"Time to modify Ybus: {1000. * np.median(modif_ybus_times):.2f} ms "
+          f"({1e6 * np.median(modif_ybus_times) / nb_cont:.2f} us / contingency)")
+    print(f"Time in the solver: {1000. * np.median(solver_times):.2f} ms")
+    print(f"Total time: {1000. * np.median(total_times):.2f} ms")
@@ -0,0 +1,60 @@
+# Copyright (c) 2025, RTE (https://www.rte-france.com)
+# See AUTHORS.txt
+# This Source Code Form is subject to the terms of the Mozilla Public License, version 2.0.
+# If a copy of the Mozilla Public License, version 2.0 was not distributed with this file,
+# you can obtain one at http://mozilla.org/MPL/2.0/.
+# SPDX-License-Identifier: MPL-2.0
+# This file is part of LightSim2grid, LightSim2grid a implements a c++ backend targeting the Grid2Op platform.
+
+# micro benchmark of the time spent to evaluate the mismatch (Ybus * V then the active and reactive
+# power mismatch at each bus) by the Newton Raphson solver, on the case300 and the case1888rte
+# (Ybus, Sbus, V0, pv and pq stored in lightsim2grid/tests)
+# It only uses the solver API, so it can be run as is on older versions of lightsim2grid to get a baseline.
+
+import os
+import zipfile
+import numpy as np
+from scipy import sparse
+
+from lightsim2grid_cpp import SparseLUSolver
+
+NB_RUN = 100
+MAX_ITER = 10
+TOL = 1e-8
+CASES = ["case300.zip", "case1888.zip"]
+DATA_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "lightsim2grid", "tests")
+
+
+def load_case(path):
+    res = {}
+    with zipfile.ZipFile(path) as myzip:
+        for nm in ["Ybus", "Sbus", "V0", "pv", "pq"]:
+            with myzip.open(f"{nm}.npy") as f:
+                res[nm] = np.load(f)
+    res["Ybus"] = sparse.csc_matrix(res["Ybus"])
+    return res
+
+
+if __name__ == "__main__":
+    for case_name in CASES:
+        data = load_case(os.path.join(DATA_DIR, case_name))
+        Ybus, Sbus, V0, pv, pq = data["Ybus"], data["Sbus"], data["V0"], data["pv"], data["pq"]
+        # all the buses that are neither pv nor pq are slack buses (same as lightsim2grid.newtonpf)
+        ref = np.array(sorted(set(range(Sbus.shape[0])) - set(pv) - set(pq)))
+        slack_weights = np.zeros(Sbus.shape[0])
+        slack_weights[ref] = 1.0 / ref.shape[0]
+
+        solver = SparseLUSolver()
+        fx_times = []
+        nb_eval = 0
+        for _ in range(NB_RUN):
+            solver.reset()
+            solver.compute_pf(Ybus, 1. * V0, Sbus, ref, slack_weights, pv, pq, MAX_ITER, TOL)
+            if not solver.converged():
+                raise RuntimeError(f"The powerflow diverged for {case_name}")
+            fx_times.append(solver.get_timers()[0])
+            # the mismatch is evaluated once before the first iteration and once after each iteration
+            nb_eval = solver.get_nb_iter() + 1
+        print(f"{case_name[:-4]} ({Sbus.shape[0]} buses, {Ybus.nnz} non zeros in Ybus): "
+              f"{1e6 * np.median(fx_times) / nb_eval:.2f} us / evaluation of the mismatch "
+              f"({nb_eval} evaluations per powerflow)")
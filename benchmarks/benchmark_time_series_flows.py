@@ -0,0 +1,59 @@
+# Copyright (c) 2025, RTE (https://www.rte-france.com)
+# See AUTHORS.txt
+# This Source Code Form is subject to the terms of the Mozilla Public License, version 2.0.
+# If a copy of the Mozilla Public License, version 2.0 was not distributed with this file,
+# you can obtain one at http://mozilla.org/MPL/2.0/.
+# SPDX-License-Identifier: MPL-2.0
+# This file is part of LightSim2grid, LightSim2grid a implements a c++ backend targeting the Grid2Op platform.
+
+# micro benchmark of the time spent to compute the flows (in amps and in MW, at the origin side of
+# each branch) once the voltages of a time series have been computed, on the case1888rte with 10k steps
+# It only uses the TimeSeriesCPP API, so it can be run as is on older versions of lightsim2grid to get a baseline
+# (before version 0.10.1 the flows are computed on a single thread whatever `set_nb_thread`).
+
+import numpy as np
+import pandapower as pp
+import pandapower.networks as pn
+
+from lightsim2grid.gridmodel import init_from_pandapower
+from lightsim2grid_cpp import TimeSeriesCPP
+
+NB_RUN = 5
+NB_STEP = 10_000
+MAX_ITER = 10
+TOL = 1e-8
+
+
+if __name__ == "__main__":
+    case = pn.case1888rte()
+    pp.runpp(case)
+    grid_model = init_from_pandapower(case)
+    Vinit = np.ones(grid_model.total_bus(), dtype=complex) * case.ext_grid["vm_pu"].values[0]
+
+    # small random variations around the initial injections
+    prng = np.random.default_rng(0)
+    gen_p_init = np.array([el.target_p_mw for el in grid_model.get_generators()])
+    sgen_p_init = np.array([el.target_p_mw for el in grid_model.get_static_generators()])
+    load_p_init = np.array([el.target_p_mw for el in grid_model.get_loads()])
+    load_q_init = np.array([el.target_q_mvar for el in grid_model.get_loads()])
+    def variations(init):
+        return init.reshape(1, -1) * prng.uniform(0.98, 1.02, size=(NB_STEP, init.shape[0]))
+    gen_p = variations(gen_p_init)
+    sgen_p = variations(sgen_p_init)
+    load_p = variations(load_p_init)
+    load_q = variations(load_q_init)
+
+    for nb_thread in [1, 2, 4]:
+        time_series = TimeSeriesCPP(grid_model)
+        time_series.set_nb_thread(nb_thread)
+        status = time_series.compute_Vs(gen_p, sgen_p, load_p, load_q, Vinit, MAX_ITER, TOL)
+        if status != 1:
+            raise RuntimeError("Some powerflows diverged, the flows cannot be compared")
+        amps_times = []
+        for _ in range(NB_RUN):
+            time_series.compute_flows()
+            amps_times.append(time_series.amps_computation_time())
+        print(f"{nb_thread} thread(s): time to compute the flows (kA) for {NB_STEP} steps: "
+              f"{1000. * np.median(amps_times):.2f} ms "
+              f"({1e6 * np.median(amps_times) / NB_STEP:.2f} us / step) "
+              f"[compute_Vs: {time_series.total_time():.2f} s]")
@@ -6,14 +6,20 @@
 # SPDX-License-Identifier: MPL-2.0
 # This file is part of LightSim2grid, LightSim2grid implements a c++ backend targeting the Grid2Op platform.
 
-__all__ = ["ContingencyAnalysisCPP"]
+__all__ = ["ContingencyAnalysisCPP",
+           "ContingencyCallbackSink",
+           "ContingencyQueueSink",
+           "ContingencyFileSink"]
 
 import copy
 import numpy as np
 from collections.abc import Iterable
 
 from lightsim2grid.solver import SolverType
-from lightsim2grid_cpp import ContingencyAnalysisCPP
+from lightsim2grid_cpp import (ContingencyAnalysisCPP,
+                               ContingencyCallbackSink,
+                               ContingencyQueueSink,
+                               ContingencyFileSink)
 
 try:
     from lightsim2grid.lightSimBackend import LightSimBackend
@@ -122,16 +128,67 @@ class __ContingencyAnalysis(object):
         raise RuntimeError("Impossible to add new topologies like this. Please use `add_single_contingency` "
                            "or `add_multiple_contingencies`.")
 
-    # TODO implement that !
-    def __update_grid(self, backend_act):
-        raise NotImplementedError("TODO !")
+    @property
+    def nb_thread(self):
+        """Number of threads used to simulate the contingencies (see :func:`ContingencyAnalysisCPP.set_nb_thread`)"""
+        return self.computer.get_nb_thread()
+
+    @nb_thread.setter
+    def nb_thread(self, val):
+        if self.__is_closed:
+            raise RuntimeError("This is closed, you cannot use it.")
+        self.computer.set_nb_thread(int(val))
+        self.clear(with_contlist=False)
+
+    def update_grid(self, backend_act):
+        """
+        Modify the grid from which the contingencies are simulated, without creating a new
+        :class:`ContingencyAnalysisCPP`: the list of contingencies is kept (as well as the 
+        factorization of the solver if the topology is not modified).
+
+        Parameters
+        ----------
+        backend_act: 
+            The grid2op "backend action" to apply (for example `env._backend_action` after a step)
+        """
+        if self.__is_closed:
+            raise RuntimeError("This is closed, you cannot use it.")
         self.clear(with_contlist=False)
+        # keep the backend (used for the initial voltages) in sync
         self._ls_backend.apply_action(backend_act)
-        # run the powerflow
-        self._ls_backend.runpf()
-        # update the computer
-        # self.computer = ContingencyAnalysisCPP(self._ls_backend._grid)
-        # self.computer.update_grid(...)  # not implemented
+        
+        # and now modify the internal grid of the computer the same way
+        topo__ = backend_act.current_topo
+        self.computer.update_topo(topo__.changed, topo__.values)
+        self.computer.update_gens_p(backend_act.prod_p.changed,
+                                    backend_act.prod_p.values)
+        self.computer.update_gens_v(backend_act.prod_v.changed,
+                                    backend_act.prod_v.values / self._ls_backend.prod_pu_to_kv)
+        self.computer.update_loads_p(backend_act.load_p.changed,
+                                     backend_act.load_p.values)
+        self.computer.update_loads_q(backend_act.load_q.changed,
+                                     backend_act.load_q.values)
+        if type(self._ls_backend).n_storage > 0:
+            try:
+                self.computer.update_storages_p(backend_act.storage_power.changed,
+                                                backend_act.storage_power.values)
+            except RuntimeError:
+                # modification of power of disconnected storage has no effect in lightsim2grid
+                pass
+        if type(self._ls_backend).shunts_data_available:
+            shunt_p, shunt_q, shunt_bus = backend_act.shunt_p, backend_act.shunt_q, backend_act.shunt_bus
+            for sh_id, new_bus in shunt_bus:
+                if new_bus == -1:
+                    self.computer.deactivate_shunt(sh_id)
+                else:
+                    self.computer.reactivate_shunt(sh_id)
+                    self.computer.change_bus_shunt(sh_id, self._ls_backend._grid.get_shunts()[sh_id].bus_id)
+            for sh_id, new_p in shunt_p:
+                self.computer.change_p_shunt(sh_id, new_p)
+            for sh_id, new_q in shunt_q:
+                self.computer.change_q_shunt(sh_id, new_q)
+        if self._ls_backend._dist_slack_non_renew:
+            self.computer.update_slack_weights(type(self._ls_backend).gen_redispatchable)
         
     def clear(self, with_contlist=True):
         """
@@ -365,6 +422,43 @@ class __ContingencyAnalysis(object):
         self.__computed = True
         return self._vs
 
+    def compute_V_screened(self, loading_threshold=0.9, max_nb_verified=-1):
+        """
+        Same as :func:`ContingencyAnalysis.compute_V` but the contingencies are first screened with the LODF (DC approximation)
+        and only the ones for which a branch is loaded above `loading_threshold` (with respect to the thermal limits
+        of the environment) are simulated with the solver, at most `max_nb_verified` of them (the most loaded ones).
+
+        The voltages of the contingencies that are not simulated are 0. See
+        :func:`lightsim2grid.contingencyAnalysis.ContingencyAnalysisCPP.compute_screened` for more information and use
+        :attr:`ContingencyAnalysis.verified` to know which contingencies have been simulated.
+
+        .. warning:: Order of the results
+
+            The order in which the results are returned is NOT necessarily the order in which the contingencies have
+            been entered. Please use `get_flows()` method for easier reading back of the results
+
+        """
+        if self.__is_closed:
+            raise RuntimeError("This is closed, you cannot use it.")
+        
+        v_init = 1. * self._ls_backend.V
+        thermal_limits = 1e-3 * np.asarray(self._ls_backend.get_thermal_limit(), dtype=float)  # A -> kA
+        self.computer.compute_screened(v_init,
+                                       self._ls_backend.max_it,
+                                       self._ls_backend.tol,
+                                       thermal_limits,
+                                       float(loading_threshold),
+                                       int(max_nb_verified))
+        self._vs = 1. * self.computer.get_voltages()
+        self.__computed = True
+        return self._vs
+
+    @property
+    def verified(self):
+        """for each contingency (in the same order as the results) whether it has been simulated with the solver 
+        (see :func:`ContingencyAnalysis.compute_V_screened`)"""
+        return self.computer.get_verified().astype(bool)
+
     def compute_A(self):
         """
         This function returns the current flows (in Amps, A) at the origin / high voltage side
@@ -1678,7 +1678,7 @@ class LightSimBackend(Backend):
 
         # handle the most complicated
         res._grid = mygrid.copy()
-        res.__me_at_init = __me_at_init.copy()  # this is const
+        res.__me_at_init = __me_at_init  # this is const (only ever copied from in "reset"), so it can be shared
         res.init_pp_backend = inippbackend  # this is const
         res._init_action_to_set = copy.deepcopy(self._init_action_to_set)
         res._backend_action_class = self._backend_action_class  # this is const
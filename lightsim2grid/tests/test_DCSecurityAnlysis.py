@@ -9,12 +9,15 @@
 import unittest
 import numpy as np
 import scipy
+import pandapower.networks as pn
 from pandapower.pypower.makeLODF import update_LODF_diag
 
 import grid2op
 
 from lightsim2grid.solver import SolverType
 from lightsim2grid import ContingencyAnalysis, LightSimBackend
+from lightsim2grid_cpp import ContingencyAnalysisCPP
+from lightsim2grid.gridmodel import init_from_pandapower
 import warnings
 import pdb
 
@@ -355,6 +358,84 @@ class TestDCSecurityAnalysis(unittest.TestCase):
 
         assert np.abs(por_lodf[has_conv] - res_p1[has_conv]).max() <= 1e-6
         
+    def test_compute_lodf(self):
+        """test the DC contingency analysis performed with the LODF (no powerflow) gives
+        the same results as the one performed with a powerflow for each contingency"""
+        sa = ContingencyAnalysisCPP(self.env.backend._grid)
+        sa.change_solver(SolverType.DC)
+        sa.add_all_n1()
+        sa.add_nk([0, 4])
+        sa.add_nk([5, 7])
+        sa.add_nk([2, 3, 6])
+        sa.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+        res_p_ref = 1. * sa.compute_power_flows()
+        has_conv = np.any(sa.get_voltages() != 0., axis=1)
+        
+        sa_lodf = ContingencyAnalysisCPP(self.env.backend._grid)
+        sa_lodf.add_all_n1()
+        sa_lodf.add_nk([0, 4])
+        sa_lodf.add_nk([5, 7])
+        sa_lodf.add_nk([2, 3, 6])
+        sa_lodf.compute_lodf()
+        res_p_lodf = 1. * sa_lodf.get_power_flows()
+        assert res_p_lodf.shape == res_p_ref.shape
+        # no powerflow is run for contingencies that do not split the grid
+        assert sa_lodf.nb_solved() == 0
+        assert np.all(np.isnan(res_p_lodf[~has_conv]))
+        assert np.abs(res_p_lodf[has_conv] - res_p_ref[has_conv]).max() <= 1e-6
+        
+        # force the use of a powerflow for all contingencies
+        sa_lodf.set_lodf_tol(1e3)
+        sa_lodf.compute_lodf()
+        res_p_explicit = 1. * sa_lodf.get_power_flows()
+        assert sa_lodf.nb_solved() == has_conv.sum()
+        assert np.all(np.isnan(res_p_explicit[~has_conv]))
+        assert np.abs(res_p_explicit[has_conv] - res_p_ref[has_conv]).max() <= 1e-6
+        
+    def test_compute_lodf_near_islanding(self):
+        """test the powerflow used when the LODF cannot be used (a bus is almost islanded by the contingency) 
+        is computed on the Ybus of the contingency, and not from the factorization of the base case"""
+        case = pn.case14()
+        # bus 2 is connected to the grid by 2 lines, one of them has a huge impedance
+        line_ids = np.where((case.line["from_bus"].values == 2) | (case.line["to_bus"].values == 2))[0]
+        assert len(line_ids) == 2
+        line_weak, line_cont = line_ids[1], line_ids[0]
+        case.line.loc[line_weak, "x_ohm_per_km"] *= 1e6
+        gridmodel = init_from_pandapower(case)
+        
+        sa_lodf = ContingencyAnalysisCPP(gridmodel)
+        sa_lodf.add_all_n1()
+        sa_lodf.set_lodf_tol(1e-12)
+        sa_lodf.compute_lodf()
+        nb_solved_lodf = sa_lodf.nb_solved()
+        sa_lodf.set_lodf_tol(1e-4)
+        sa_lodf.compute_lodf()
+        res_p_lodf = 1. * sa_lodf.get_power_flows()
+        # with this tolerance, the contingency of the other line is also computed with a powerflow
+        # (nb_solved counts the powerflows of both calls)
+        assert sa_lodf.nb_solved() - nb_solved_lodf == nb_solved_lodf + 1
+        
+        gridmodel_cont = gridmodel.copy()
+        gridmodel_cont.deactivate_powerline(line_cont)
+        V = gridmodel_cont.dc_pf(np.ones(gridmodel_cont.total_bus(), dtype=complex), 10, 1e-8)
+        assert V.shape[0] > 0
+        res_p_ref = np.concatenate((gridmodel_cont.get_lineor_res()[0], gridmodel_cont.get_trafohv_res()[0]))
+        assert np.abs(res_p_lodf[line_cont] - res_p_ref).max() <= 1e-6
+        
+    def test_compute_multithread(self):
+        """test the results do not depend on the number of threads (the factorization of 
+        the base case is reused for all contingencies)"""
+        res = []
+        for nb_thread in [1, 2]:
+            sa = ContingencyAnalysisCPP(self.env.backend._grid)
+            sa.change_solver(SolverType.DC)
+            sa.set_nb_thread(nb_thread)
+            sa.add_all_n1()
+            sa.add_nk([0, 4])
+            sa.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+            res.append(1. * sa.get_voltages())
+        assert np.array_equal(res[0], res[1])
+        
     def test_compare_lodf_topo(self):
         self.test_compare_lodf(act=self.env.action_space({"set_bus": {"substations_id": [(1, (1, 2, 1, 2, 1, 2))]}}))
     
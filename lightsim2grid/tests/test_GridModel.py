@@ -428,5 +428,366 @@ class MakeACTests(BaseTests, unittest.TestCase):
         pass
 
 
+class BaseCase118Tests:
+    """case118 converted (without running a pandapower powerflow) and the settings of the powerflows"""
+    def setUp(self):
+        self.net = pn.case118()
+        self.model = self.make_model()
+        self.max_it = 10
+        self.tol = 1e-8
+        self.V0 = np.full(self.model.total_bus(), 1.04, dtype=complex)
+
+    def make_model(self):
+        with warnings.catch_warnings():
+            warnings.filterwarnings("ignore")
+            return init_from_pandapower(self.net)
+
+
+class BusReorderingTests(BaseCase118Tests, unittest.TestCase):
+    def _bandwidth(self, mat):
+        mat = mat.tocoo()
+        return np.max(np.abs(mat.row - mat.col))
+
+    def test_same_results(self):
+        assert not self.model.get_bus_reordering()
+        V_ref = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        assert V_ref.shape[0] > 0, "powerflow diverged !"
+        Ybus_ref = self.model.get_Ybus()
+        bw_ref = self._bandwidth(self.model.get_Ybus_solver())
+        por_ref, *_ = self.model.get_lineor_res()
+
+        self.model.set_bus_reordering(True)
+        assert self.model.get_bus_reordering()
+        V = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        assert np.max(np.abs(V - V_ref)) <= 1e-8
+        assert np.max(np.abs(self.model.get_Ybus() - Ybus_ref)) <= 1e-12
+        por, *_ = self.model.get_lineor_res()
+        assert np.max(np.abs(por - por_ref)) <= 1e-6
+        assert self._bandwidth(self.model.get_Ybus_solver()) < bw_ref
+        id_solver_to_me = np.array(self.model.id_ac_solver_to_me())
+        assert np.all(np.sort(id_solver_to_me) == np.arange(self.model.nb_bus()))
+        assert np.any(id_solver_to_me != np.arange(self.model.nb_bus()))
+
+        # dc powerflow
+        self.model.set_bus_reordering(False)
+        Vdc_ref = self.model.dc_pf(self.V0, self.max_it, self.tol)
+        self.model.set_bus_reordering(True)
+        Vdc = self.model.dc_pf(self.V0, self.max_it, self.tol)
+        assert np.max(np.abs(Vdc - Vdc_ref)) <= 1e-8
+
+    def test_topo_change(self):
+        self.model.set_bus_reordering(True)
+        V = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        self.model.deactivate_powerline(0)
+        V = self.model.ac_pf(V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+
+        self.model.set_bus_reordering(False)
+        V_ref = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        assert V_ref.shape[0] > 0, "powerflow diverged !"
+        assert np.max(np.abs(V - V_ref)) <= 1e-7
+
+
+class ThreadingTests(BaseCase118Tests, unittest.TestCase):
+    def setUp(self):
+        super().setUp()
+        self.nb_thread = 4
+
+    def test_independent_models(self):
+        from concurrent.futures import ThreadPoolExecutor
+        V_ref = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        Vdc_ref = self.model.dc_pf(self.V0, self.max_it, self.tol)
+        ptdf_ref = self.model.get_ptdf()
+        lodf_ref = self.model.get_lodf()
+
+        def fun(model):
+            res = []
+            for _ in range(10):
+                model.tell_solver_need_reset()
+                V = model.ac_pf(self.V0, self.max_it, self.tol)
+                Vdc = model.dc_pf(self.V0, self.max_it, self.tol)
+                res.append((V, Vdc, model.get_ptdf(), model.get_lodf()))
+            return res
+
+        models = [self.model.copy() for _ in range(self.nb_thread)]
+        with ThreadPoolExecutor(max_workers=self.nb_thread) as executor:
+            all_res = list(executor.map(fun, models))
+        for res in all_res:
+            for V, Vdc, ptdf, lodf in res:
+                assert np.max(np.abs(V - V_ref)) <= 1e-12
+                assert np.max(np.abs(Vdc - Vdc_ref)) <= 1e-12
+                assert np.max(np.abs(ptdf - ptdf_ref)) <= 1e-12
+                assert np.allclose(lodf, lodf_ref, rtol=0., atol=1e-12, equal_nan=True)
+
+
+
+class YbusInPlaceUpdateTests(BaseCase118Tests, unittest.TestCase):
+    def setUp(self):
+        super().setUp()
+        self.model_ref = self.make_model()
+
+    def _check_same(self, V):
+        # the reference model computes everything from scratch
+        self.model_ref.tell_solver_need_reset()
+        V_ref = self.model_ref.ac_pf(self.V0, self.max_it, self.tol)
+        assert V_ref.shape[0] > 0, "powerflow diverged !"
+        assert np.max(np.abs(self.model.get_Ybus() - self.model_ref.get_Ybus())) <= 1e-12
+        assert np.max(np.abs(V - V_ref)) <= 1e-8
+
+    def test_shunt_change(self):
+        V = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        self.model.unset_changes()
+        nb_full, nb_in_place = self.model.get_ybus_fill_counters()
+        assert nb_in_place == 0
+
+        q_shunt = 1.1 * self.net.shunt.iloc[0]["q_mvar"] + 1.
+        self.model.change_q_shunt(0, q_shunt)
+        self.model_ref.change_q_shunt(0, q_shunt)
+        V = self.model.ac_pf(V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        assert self.model.get_ybus_fill_counters() == (nb_full, 1)
+        self._check_same(V)
+        self.model.unset_changes()
+
+        # status of the shunt
+        self.model.deactivate_shunt(1)
+        self.model_ref.deactivate_shunt(1)
+        V = self.model.ac_pf(V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        assert self.model.get_ybus_fill_counters() == (nb_full, 2)
+        self._check_same(V)
+        self.model.unset_changes()
+
+    def test_topo_change(self):
+        V = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        self.model.unset_changes()
+        nb_full, nb_in_place = self.model.get_ybus_fill_counters()
+
+        # sparsity pattern (might) change: Ybus is fully recomputed
+        self.model.deactivate_powerline(0)
+        self.model_ref.deactivate_powerline(0)
+        V = self.model.ac_pf(V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        assert self.model.get_ybus_fill_counters() == (nb_full + 1, nb_in_place)
+        self._check_same(V)
+        self.model.unset_changes()
+
+        # then in place again
+        self.model.change_q_shunt(0, 5.)
+        self.model_ref.change_q_shunt(0, 5.)
+        V = self.model.ac_pf(V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        assert self.model.get_ybus_fill_counters() == (nb_full + 1, nb_in_place + 1)
+        self._check_same(V)
+
+
+
+class SbusDeltaUpdateTests(BaseCase118Tests, unittest.TestCase):
+    def setUp(self):
+        super().setUp()
+        self.model_ref = self.make_model()
+
+    def _check_same(self, V, ac=True):
+        # the reference model computes everything from scratch
+        self.model_ref.tell_solver_need_reset()
+        if ac:
+            V_ref = self.model_ref.ac_pf(self.V0, self.max_it, self.tol)
+            Sbus, Sbus_ref = self.model.get_Sbus(), self.model_ref.get_Sbus()
+        else:
+            V_ref = self.model_ref.dc_pf(self.V0, self.max_it, self.tol)
+            Sbus, Sbus_ref = self.model.get_dcSbus(), self.model_ref.get_dcSbus()
+        assert V_ref.shape[0] > 0, "powerflow diverged !"
+        assert np.max(np.abs(Sbus - Sbus_ref)) <= 1e-12
+        assert np.max(np.abs(V - V_ref)) <= 1e-8
+
+    def test_injection_change(self):
+        V = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        self.model.unset_changes()
+        nb_full, nb_delta, _ = self.model.get_sbus_fill_counters()
+
+        for model in [self.model, self.model_ref]:
+            model.change_p_load(0, self.net.load.iloc[0]["p_mw"] + 1.)
+            model.change_q_load(0, self.net.load.iloc[0]["q_mvar"] + 1.)
+            model.change_p_load(3, self.net.load.iloc[3]["p_mw"] - 1.)
+            model.change_p_gen(1, self.net.gen.iloc[1]["p_mw"] + 1.)
+        V = self.model.ac_pf(V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        assert self.model.get_sbus_fill_counters() == (nb_full, nb_delta + 1, 3)
+        self._check_same(V)
+
+        # calling the powerflow again does not change Sbus
+        V = self.model.ac_pf(V, self.max_it, self.tol)
+        assert self.model.get_sbus_fill_counters() == (nb_full, nb_delta + 2, 0)
+        self._check_same(V)
+        self.model.unset_changes()
+
+        # disconnection of a load
+        for model in [self.model, self.model_ref]:
+            model.deactivate_load(2)
+        V = self.model.ac_pf(V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        assert self.model.get_sbus_fill_counters() == (nb_full, nb_delta + 3, 1)
+        self._check_same(V)
+        self.model.unset_changes()
+
+    def test_dc(self):
+        V = self.model.dc_pf(self.V0, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        self.model.unset_changes()
+        nb_full, nb_delta, _ = self.model.get_sbus_fill_counters()
+        for model in [self.model, self.model_ref]:
+            model.change_p_load(0, self.net.load.iloc[0]["p_mw"] + 1.)
+        V = self.model.dc_pf(V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        assert self.model.get_sbus_fill_counters() == (nb_full, nb_delta + 1, 1)
+        self._check_same(V, ac=False)
+
+    def test_dc_then_ac(self):
+        # the changes seen only by the dc powerflow should not be missed by the next ac powerflow
+        V = self.model.dc_pf(self.V0, self.max_it, self.tol)
+        V = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        self.model.unset_changes()
+        for model in [self.model, self.model_ref]:
+            model.change_p_load(0, self.net.load.iloc[0]["p_mw"] + 10.)
+        Vdc = self.model.dc_pf(V, self.max_it, self.tol)
+        assert Vdc.shape[0] > 0, "powerflow diverged !"
+        self.model.unset_changes()
+        nb_full, nb_delta, _ = self.model.get_sbus_fill_counters()
+        for model in [self.model, self.model_ref]:
+            model.change_p_load(1, self.net.load.iloc[1]["p_mw"] + 5.)
+        Vdc = self.model.dc_pf(V, self.max_it, self.tol)
+        assert Vdc.shape[0] > 0, "powerflow diverged !"
+        self._check_same(Vdc, ac=False)
+        V = self.model.ac_pf(V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        # the dc Sbus is updated, the ac one is fully recomputed
+        assert self.model.get_sbus_fill_counters()[:2] == (nb_full + 1, nb_delta + 1)
+        self._check_same(V)
+
+    def test_topo_change(self):
+        V = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        self.model.unset_changes()
+        nb_full, nb_delta, _ = self.model.get_sbus_fill_counters()
+        for model in [self.model, self.model_ref]:
+            model.deactivate_powerline(0)
+            model.change_p_load(0, self.net.load.iloc[0]["p_mw"] + 1.)
+        V = self.model.ac_pf(V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        nb_full_after, nb_delta_after, _ = self.model.get_sbus_fill_counters()
+        assert nb_full_after == nb_full + 1
+        assert nb_delta_after == nb_delta
+        self._check_same(V)
+
+
+class CopyTests(BaseCase118Tests, unittest.TestCase):
+    """the parameters of the branches are shared between the copies of a GridModel"""
+    def test_same_results(self):
+        V_ref = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        model = self.model.copy()
+        model_copy = model.copy()  # copy of a copy
+        for mod in [model, model_copy]:
+            mod.tell_solver_need_reset()
+            V = mod.ac_pf(self.V0, self.max_it, self.tol)
+            assert np.max(np.abs(V - V_ref)) <= 1e-12
+            assert mod.get_state() == self.model.get_state()
+
+    def test_independent(self):
+        V_ref = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        lines_or_ref = self.model.get_lineor_res()
+        names_ref = [el.name for el in self.model.get_lines()]
+        model = self.model.copy()
+
+        # modifications of the copy are not seen by the original model
+        model.set_line_names([f"line_{i}" for i in range(len(names_ref))])
+        model.deactivate_powerline(0)
+        model.deactivate_trafo(0)
+        V = model.ac_pf(V_ref, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        assert np.max(np.abs(V - V_ref)) > 1e-6
+        assert [el.name for el in model.get_lines()][0] == "line_0"
+        assert [el.name for el in self.model.get_lines()] == names_ref
+
+        self.model.tell_solver_need_reset()
+        V_ref2 = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        assert np.max(np.abs(V_ref2 - V_ref)) <= 1e-12
+        for arr, arr_ref in zip(self.model.get_lineor_res(), lines_or_ref):
+            assert np.max(np.abs(arr - arr_ref)) <= 1e-12
+
+
+class SaveRestoreStateTests(BaseCase118Tests, unittest.TestCase):
+    def setUp(self):
+        super().setUp()
+        self.V = self.model.ac_pf(self.V0, self.max_it, self.tol)
+        assert self.V.shape[0] > 0, "powerflow diverged !"
+        self.model.unset_changes()
+
+    def test_restore(self):
+        state_ref = self.model.get_state()
+        token = self.model.save_state()
+        assert self.model.nb_saved_states() == 1
+        self.model.deactivate_powerline(0)
+        self.model.change_p_load(0, self.net.load.iloc[0]["p_mw"] + 10.)
+        self.model.change_p_gen(1, self.net.gen.iloc[1]["p_mw"] + 10.)
+        self.model.deactivate_trafo(0)
+        V = self.model.ac_pf(self.V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        assert np.max(np.abs(V - self.V)) > 1e-6
+        self.model.restore_state(token)
+        assert self.model.nb_saved_states() == 0
+        assert self.model.get_state() == state_ref
+        # the results of the last powerflow are restored too
+        assert np.max(np.abs(self.model.get_V() - self.V)) <= 1e-12
+        V = self.model.ac_pf(self.V, self.max_it, self.tol)
+        assert np.max(np.abs(V - self.V)) <= 1e-8
+
+    def test_nested(self):
+        state_ref = self.model.get_state()
+        token0 = self.model.save_state()
+        self.model.deactivate_powerline(0)
+        state_1 = self.model.get_state()
+        token1 = self.model.save_state()
+        self.model.deactivate_powerline(1)
+        self.model.change_p_load(0, self.net.load.iloc[0]["p_mw"] + 10.)
+        self.model.restore_state(token1)
+        assert self.model.get_state() == state_1
+        assert self.model.nb_saved_states() == 1
+        token1 = self.model.save_state()
+        self.model.deactivate_powerline(2)
+        # restoring the first state removes the second one
+        self.model.restore_state(token0)
+        assert self.model.get_state() == state_ref
+        assert self.model.nb_saved_states() == 0
+        with self.assertRaises(IndexError):
+            self.model.restore_state(token1)
+
+    def test_forget(self):
+        token = self.model.save_state()
+        self.model.deactivate_powerline(0)
+        state = self.model.get_state()
+        self.model.forget_state(token)
+        assert self.model.nb_saved_states() == 0
+        assert self.model.get_state() == state
+        assert not self.model.get_lines_status()[0]
+
+    def test_keep_ybus(self):
+        # nothing computed between the save and the restore: Ybus is not recomputed
+        nb_full, nb_inplace = self.model.get_ybus_fill_counters()
+        token = self.model.save_state()
+        self.model.deactivate_powerline(0)
+        self.model.change_bus_load(0, 5)
+        self.model.restore_state(token)
+        V = self.model.ac_pf(self.V, self.max_it, self.tol)
+        assert V.shape[0] > 0, "powerflow diverged !"
+        assert self.model.get_ybus_fill_counters() == (nb_full, nb_inplace)
+        assert np.max(np.abs(V - self.V)) <= 1e-8
+
+
 if __name__ == "__main__":
     unittest.main()
\ No newline at end of file
@@ -230,6 +230,239 @@ class TestSecurityAnalysisCPP(unittest.TestCase):
                 assert np.max(np.abs(res_SA[cont_id, :nb_sub])) <= 1e-6, f"error in V when disconnecting line {l_id} (contingency nb {cont_id})"
                 assert np.all(np.isnan(res_flows[cont_id])) , f"error in flows when disconnecting line {l_id} (contingency nb {cont_id})"
 
+    def test_compute_multithread(self):
+        SA = ContingencyAnalysisCPP(self.env.backend._grid)
+        SA.add_all_n1()
+        SA.add_nk([0, 1])
+        SA.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+        res_SA = 1. * SA.get_voltages()
+
+        SA_mt = ContingencyAnalysisCPP(self.env.backend._grid)
+        assert SA_mt.get_nb_thread() == 1
+        with self.assertRaises(RuntimeError):
+            SA_mt.set_nb_thread(0)
+        SA_mt.set_nb_thread(3)
+        assert SA_mt.get_nb_thread() == 3
+        SA_mt.add_all_n1()
+        SA_mt.add_nk([0, 1])
+        SA_mt.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+        res_SA_mt = SA_mt.get_voltages()
+        assert res_SA_mt.shape == res_SA.shape
+        assert SA_mt.nb_solved() == SA.nb_solved()
+        # results are the same (bit for bit) as the single threaded ones
+        assert np.array_equal(res_SA_mt, res_SA)
+
+    def test_is_grid_connected(self):
+        from scipy.sparse import coo_matrix
+        from scipy.sparse.csgraph import connected_components
+        SA = ContingencyAnalysisCPP(self.env.backend._grid)
+        SA.add_all_n1()
+        SA.add_nk([0, 1])
+        SA.add_nk([2, 3, 4])
+        SA.add_nk([15, 16, 17])
+        SA.add_nk([16, 19])
+        conn = SA.is_grid_connected_after_contingency()
+        all_conts = SA.my_defaults()
+        assert conn.shape == (len(all_conts), )
+        # all elements are on bus 1 of their substation: the graph of the substations is used as reference
+        n_sub = type(self.env).n_sub
+        line_or = type(self.env).line_or_to_subid
+        line_ex = type(self.env).line_ex_to_subid
+        for cont, is_conn in zip(all_conts, conn):
+            keep = np.ones(line_or.shape[0], dtype=bool)
+            keep[list(cont)] = False
+            graph = coo_matrix((np.ones(keep.sum()), (line_or[keep], line_ex[keep])), shape=(n_sub, n_sub))
+            nb_comp, _ = connected_components(graph, directed=False)
+            assert (nb_comp == 1) == (is_conn == 1), f"error for contingency {cont}"
+        # a contingency that splits the grid is not simulated
+        SA.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+        assert SA.nb_solved() == conn.sum()
+        assert np.all(SA.get_voltages()[conn == 0] == 0.)
+
+    def test_compute_screened(self):
+        SA = ContingencyAnalysisCPP(self.env.backend._grid)
+        SA.add_all_n1()
+        SA.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+        res_SA = 1. * SA.get_voltages()
+        assert np.all(SA.get_verified() == 1)
+        
+        thermal_limits = 1e-3 * self.env.get_thermal_limit()
+        SA_scr = ContingencyAnalysisCPP(self.env.backend._grid)
+        SA_scr.add_all_n1()
+        with self.assertRaises(RuntimeError):
+            # wrong size for the thermal limits
+            SA_scr.compute_screened(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol,
+                                    thermal_limits[1:], 0., -1)
+        SA_scr.compute_screened(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol,
+                                thermal_limits, 0., 5)
+        loading = SA_scr.get_screening_loading()
+        verified = SA_scr.get_verified() == 1
+        assert loading.shape == (res_SA.shape[0], )
+        assert verified.sum() == 5
+        # the 5 most loaded (among the ones that do not split the grid) are simulated
+        finite_loading = loading[np.isfinite(loading)]
+        assert np.all(loading[verified] >= np.sort(finite_loading)[-5])
+        res_scr = SA_scr.get_voltages()
+        assert np.array_equal(res_scr[verified], res_SA[verified])
+        assert np.all(res_scr[~verified] == 0.)
+        
+        # threshold only
+        threshold = np.median(finite_loading)
+        SA_scr.compute_screened(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol,
+                                thermal_limits, threshold, -1)
+        verified = SA_scr.get_verified() == 1
+        assert np.array_equal(verified, np.isfinite(loading) & (loading >= threshold))
+
+    def test_result_sink(self):
+        import os
+        import tempfile
+        import threading
+        from lightsim2grid_cpp import ContingencyCallbackSink, ContingencyQueueSink, ContingencyFileSink
+        SA = ContingencyAnalysisCPP(self.env.backend._grid)
+        SA.add_all_n1()
+        SA.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+        res_V = 1. * SA.get_voltages()
+        res_flows = 1. * SA.compute_flows()
+        nb_cont, nb_bus = res_V.shape
+        nb_branch = res_flows.shape[1]
+
+        # callback (multiple threads)
+        res_cb = {}
+        def callback(cont_id, converged, V, amps_flows):
+            res_cb[cont_id] = (converged, V, amps_flows)
+        SA.set_nb_thread(2)
+        SA.set_result_sink(ContingencyCallbackSink(callback), True)
+        assert SA.has_result_sink()
+        SA.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+        assert SA.get_voltages().shape[0] == 0
+        assert sorted(res_cb.keys()) == list(range(nb_cont))
+        for cont_id, (converged, V, amps_flows) in res_cb.items():
+            assert converged == np.any(res_V[cont_id] != 0.)
+            assert np.array_equal(V, res_V[cont_id])
+            assert np.array_equal(amps_flows, res_flows[cont_id], equal_nan=True)
+        
+        # bounded queue, consumed from another thread
+        sink = ContingencyQueueSink(2)
+        SA.set_result_sink(sink, False)
+        th = threading.Thread(target=SA.compute, args=(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol))
+        th.start()
+        res_queue = {}
+        while True:
+            res = sink.pop()
+            if res is None:
+                break
+            cont_id, converged, V, amps_flows = res
+            assert amps_flows.shape == (0, )
+            res_queue[cont_id] = V
+        th.join()
+        assert sorted(res_queue.keys()) == list(range(nb_cont))
+        for cont_id, V in res_queue.items():
+            assert np.array_equal(V, res_V[cont_id])
+        
+        # binary file
+        SA.set_nb_thread(1)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, "res.bin")
+            sink = ContingencyFileSink(path)
+            SA.set_result_sink(sink, True)
+            SA.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+            dtype = np.dtype([("cont_id", np.int64), ("converged", np.int64),
+                              ("V", np.complex128, nb_bus), ("amps_flows", np.float64, nb_branch)])
+            assert sink.record_size() == dtype.itemsize
+            res_file = np.fromfile(path, dtype=dtype)
+            
+            # the file is overwritten by the next computation (with another record layout)
+            SA.set_result_sink(sink, False)
+            SA.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+            dtype_no_flow = np.dtype([("cont_id", np.int64), ("converged", np.int64), ("V", np.complex128, nb_bus)])
+            assert sink.record_size() == dtype_no_flow.itemsize
+            assert os.path.getsize(path) == nb_cont * dtype_no_flow.itemsize
+            res_file_no_flow = np.fromfile(path, dtype=dtype_no_flow)
+        assert np.array_equal(res_file["cont_id"], np.arange(nb_cont))
+        assert np.array_equal(res_file["V"], res_V)
+        assert np.array_equal(res_file["amps_flows"], res_flows, equal_nan=True)
+        assert np.array_equal(res_file_no_flow["cont_id"], np.arange(nb_cont))
+        assert np.array_equal(res_file_no_flow["V"], res_V)
+        
+        SA.clear_result_sink()
+        SA.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+        assert np.array_equal(SA.get_voltages(), res_V)
+
+    def test_aggregation(self):
+        SA = ContingencyAnalysisCPP(self.env.backend._grid)
+        SA.add_all_n1()
+        SA.add_nk([0, 1])
+        SA.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+        res_V = 1. * SA.get_voltages()
+        res_flows = 1. * SA.compute_flows()
+        converged = np.any(res_V != 0., axis=1)
+        
+        thermal_limits = 1e-3 * self.env.get_thermal_limit()
+        thermal_limits = np.concatenate((thermal_limits, np.zeros(res_flows.shape[1] - thermal_limits.shape[0])))
+        threshold = 0.5
+        with self.assertRaises(RuntimeError):
+            SA.set_aggregation(thermal_limits[1:], threshold)
+        SA.set_aggregation(thermal_limits, threshold)
+        assert SA.has_aggregation()
+        for nb_thread in [1, 3]:
+            SA.set_nb_thread(nb_thread)
+            SA.compute(self.env.backend.V, self.env.backend.max_it, self.env.backend.tol)
+            flows = res_flows[converged]
+            assert np.array_equal(SA.get_max_flows(), np.max(flows, axis=0))
+            argmax = np.flatnonzero(converged)[np.argmax(flows, axis=0)]
+            argmax[np.max(flows, axis=0) == 0.] = -1
+            assert np.array_equal(SA.get_max_flows_cont(), argmax)
+            has_limit = thermal_limits > 0.
+            nb_viol = np.sum(flows > threshold * thermal_limits, axis=0)
+            assert np.array_equal(SA.get_nb_violations()[has_limit], nb_viol[has_limit])
+            assert np.all(SA.get_nb_violations()[~has_limit] == 0)
+            vm = np.abs(res_V[converged])
+            used = np.all(vm != 0., axis=0)
+            assert np.array_equal(SA.get_min_vm()[used], np.min(vm[:, used], axis=0))
+            assert np.array_equal(SA.get_max_vm()[used], np.max(vm[:, used], axis=0))
+            assert np.all(np.isnan(SA.get_min_vm()[~np.any(vm != 0., axis=0)]))
+        SA.clear_aggregation()
+        assert not SA.has_aggregation()
+
+    def test_update_grid(self):
+        grid = self.env.backend._grid
+        V, max_it, tol = self.env.backend.V, self.env.backend.max_it, self.env.backend.tol
+        SA = ContingencyAnalysisCPP(grid)
+        SA.add_all_n1()
+        SA.compute(V, max_it, tol)
+        nb_cont = len(SA.my_defaults())
+
+        # injections only
+        changed = np.ones(self.env.n_load, dtype=bool)
+        new_load_p = (1.05 * self.env.backend.load_p).astype(np.float32)
+        SA.update_loads_p(changed, new_load_p)
+        SA.compute(V, max_it, tol)
+        assert len(SA.my_defaults()) == nb_cont
+        grid_ref = grid.copy()
+        grid_ref.update_loads_p(changed, new_load_p)
+        SA_ref = ContingencyAnalysisCPP(grid_ref)
+        SA_ref.add_all_n1()
+        SA_ref.compute(V, max_it, tol)
+        assert np.max(np.abs(SA.get_voltages() - SA_ref.get_voltages())) <= 1e-6
+        assert SA.nb_solved() == SA_ref.nb_solved()
+        
+        # topology (disconnection of a powerline)
+        l_id = 3
+        topo_changed = np.zeros(self.env.dim_topo, dtype=bool)
+        topo_values = np.ones(self.env.dim_topo, dtype=np.int32)
+        for pos in [type(self.env).line_or_pos_topo_vect[l_id], type(self.env).line_ex_pos_topo_vect[l_id]]:
+            topo_changed[pos] = True
+            topo_values[pos] = -1
+        SA.update_topo(topo_changed, topo_values)
+        SA.compute(V, max_it, tol)
+        grid_ref.update_topo(topo_changed, topo_values)
+        SA_ref = ContingencyAnalysisCPP(grid_ref)
+        SA_ref.add_all_n1()
+        SA_ref.compute(V, max_it, tol)
+        assert np.max(np.abs(SA.get_voltages() - SA_ref.get_voltages())) <= 1e-6
+        assert SA.nb_solved() == SA_ref.nb_solved()
+        assert np.all(SA.is_grid_connected_after_contingency() == SA_ref.is_grid_connected_after_contingency())
+
 
 if __name__ == "__main__":
     unittest.main()
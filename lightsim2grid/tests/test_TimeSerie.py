@@ -8,9 +8,10 @@
 
 import unittest
 import warnings
-from lightsim2grid import TimeSerie
+from lightsim2grid import TimeSerie, ErrorType
 import grid2op
 from lightsim2grid.lightSimBackend import LightSimBackend
+from lightsim2grid_cpp import PredictorType
 import numpy as np
 
 class TimeSerieTester(unittest.TestCase):
@@ -36,6 +37,252 @@ class TimeSerieTester(unittest.TestCase):
             if np.max(np.abs(Ps[1 + it_num] - obs.p_or))  > 1e-3:
                 raise RuntimeError(f"error at it {it_num} for P")
 
+    def test_multithread(self):
+        env_name = "l2rpn_case14_sandbox"
+        with warnings.catch_warnings():
+            warnings.filterwarnings("ignore")
+            env = grid2op.make(env_name, backend=LightSimBackend(), test=True)
+
+        time_series = TimeSerie(env)
+        Vs = 1.0 * time_series.compute_V(scenario_id=0)
+        status = 1 * time_series.computer.get_steps_status()
+        assert np.all(status == 1)
+        assert status.shape[0] == Vs.shape[0]
+
+        time_series.nb_thread = 3
+        assert time_series.nb_thread == 3
+        Vs_mt = 1.0 * time_series.compute_V(scenario_id=0)
+        status_mt = 1 * time_series.computer.get_steps_status()
+        assert np.all(status_mt == 1)
+        assert time_series.computer.nb_solved() == Vs.shape[0]
+        # the chunks do not start from the same point, results are equal up to the solver tolerance
+        assert np.allclose(Vs_mt, Vs, atol=1e-6)
+        # the first chunk is computed exactly as in the single thread case
+        nb_first = Vs.shape[0] // 3
+        assert np.array_equal(Vs_mt[:nb_first], Vs[:nb_first])
+
+        with self.assertRaises(RuntimeError):
+            time_series.nb_thread = 0
+        time_series.close()
+        env.close()
+
+    def test_compute_results(self):
+        env_name = "l2rpn_case14_sandbox"
+        with warnings.catch_warnings():
+            warnings.filterwarnings("ignore")
+            env = grid2op.make(env_name, backend=LightSimBackend(), test=True)
+
+        time_series = TimeSerie(env)
+        prod_p, load_p, load_q = time_series.get_injections(scenario_id=0)
+        Vs = time_series.compute_V_from_inj(prod_p, load_p, load_q)
+        computer = time_series.computer
+        computer.compute_results(branch_results=True, gen_results=True, shunt_results=False, bus_results=True)
+        p_or = 1.0 * computer.get_p_or()
+        q_ex = 1.0 * computer.get_q_ex()
+        a_ex = 1.0 * computer.get_a_ex()
+        gen_q = 1.0 * computer.get_gen_q()
+        gen_p_slack = 1.0 * computer.get_gen_p_slack()
+        assert p_or.shape == (Vs.shape[0], env.n_line)
+        assert gen_q.shape == (Vs.shape[0], env.n_gen)
+        assert computer.get_bus_v_kv().shape == Vs.shape
+        assert computer.get_shunt_q().shape[0] == 0  # not requested
+        # same as the flows computed with the "historical" functions
+        assert np.allclose(p_or, time_series.compute_P())
+        assert np.allclose(1000. * computer.get_a_or(), time_series.compute_A())
+        
+        env.set_id(0)
+        env.reset()
+        for it_num in range(100):
+            obs, *_ = env.step(env.action_space())
+            assert np.max(np.abs(p_or[1 + it_num] - obs.p_or)) <= 1e-3, f"error at it {it_num} for p_or"
+            assert np.max(np.abs(q_ex[1 + it_num] - obs.q_ex)) <= 1e-3, f"error at it {it_num} for q_ex"
+            assert np.max(np.abs(1000. * a_ex[1 + it_num] - obs.a_ex)) <= 1e-3, f"error at it {it_num} for a_ex"
+            assert np.max(np.abs(gen_q[1 + it_num] - obs.gen_q)) <= 1e-3, f"error at it {it_num} for gen_q"
+            gen_p = prod_p[1 + it_num] + gen_p_slack[1 + it_num]
+            assert np.max(np.abs(gen_p - obs.gen_p)) <= 1e-3, f"error at it {it_num} for gen_p_slack"
+        time_series.close()
+        env.close()
+
+    def test_topology_events(self):
+        env_name = "l2rpn_case14_sandbox"
+        with warnings.catch_warnings():
+            warnings.filterwarnings("ignore")
+            env = grid2op.make(env_name, backend=LightSimBackend(), test=True)
+
+        time_series = TimeSerie(env)
+        prod_p, load_p, load_q = time_series.get_injections(scenario_id=0)
+        computer = time_series.computer
+        l_id = 3
+        computer.add_branch_status_event(10, l_id, False)
+        computer.add_branch_status_event(20, l_id, True)
+        assert computer.nb_topo_events() == 2
+        Vs = time_series.compute_V_from_inj(prod_p, load_p, load_q)
+        assert computer.nb_topologies() == 2
+        steps_topo = 1 * computer.get_steps_topology()
+        assert np.all(steps_topo[10:20] == 1)
+        assert np.all(steps_topo[:10] == 0)
+        assert np.all(steps_topo[20:] == 0)
+        As = time_series.compute_A()
+        assert np.all(As[10:20, l_id] == 0.)
+        with self.assertRaises(RuntimeError):
+            computer.compute_results()
+
+        env.set_id(0)
+        env.reset()
+        for it_num in range(30):
+            if it_num + 1 == 10:
+                act = env.action_space({"set_line_status": [(l_id, -1)]})
+            elif it_num + 1 == 20:
+                act = env.action_space({"set_line_status": [(l_id, +1)]})
+            else:
+                act = env.action_space()
+            obs, reward, done, info = env.step(act)
+            assert not done, f"episode over at it {it_num}"
+            assert np.max(np.abs(As[1 + it_num] - obs.a_or)) <= 1e-3, f"error at it {it_num} for a_or"
+
+        # without the events the topology of the grid model is used again
+        computer.clear_topo_events()
+        Vs_no_event = time_series.compute_V_from_inj(prod_p, load_p, load_q)
+        assert computer.nb_topologies() == 1
+        assert np.allclose(Vs_no_event[:10], Vs[:10])
+        assert not np.allclose(Vs_no_event[10:20], Vs[10:20])
+        time_series.close()
+        env.close()
+
+    def test_topology_events_empty_bus(self):
+        env_name = "l2rpn_case14_sandbox"
+        with warnings.catch_warnings():
+            warnings.filterwarnings("ignore")
+            env = grid2op.make(env_name, backend=LightSimBackend(), test=True)
+
+        time_series = TimeSerie(env)
+        prod_p, load_p, load_q = time_series.get_injections(scenario_id=0)
+        Vs_ref = time_series.compute_V_from_inj(prod_p, load_p, load_q)
+
+        # all the branches of this substation are moved to its second bus: its first bus is left empty
+        sub_id = 6
+        n_sub = env.n_sub
+        assert not np.any(env.load_to_subid == sub_id)
+        assert not np.any(env.gen_to_subid == sub_id)
+        gridmodel = env.backend._grid
+        n_line = len(gridmodel.get_lines())
+        computer = time_series.computer
+        for line_id, el in enumerate(gridmodel.get_lines()):
+            if el.bus_or_id == sub_id:
+                computer.add_branch_bus_event(10, line_id, 0, sub_id + n_sub)
+            if el.bus_ex_id == sub_id:
+                computer.add_branch_bus_event(10, line_id, 1, sub_id + n_sub)
+        for trafo_id, el in enumerate(gridmodel.get_trafos()):
+            if el.bus_hv_id == sub_id:
+                computer.add_branch_bus_event(10, n_line + trafo_id, 0, sub_id + n_sub)
+            if el.bus_lv_id == sub_id:
+                computer.add_branch_bus_event(10, n_line + trafo_id, 1, sub_id + n_sub)
+        assert computer.nb_topo_events() >= 2
+        Vs = time_series.compute_V_from_inj(prod_p, load_p, load_q)
+        assert np.all(1 * computer.get_steps_status() == 1)
+        assert np.allclose(Vs[:10], Vs_ref[:10])
+        assert np.allclose(Vs[10:, sub_id + n_sub], Vs_ref[10:, sub_id], atol=1e-6)
+        assert np.all(Vs[10:, sub_id] == 0.)
+        other_buses = [bus_id for bus_id in range(n_sub) if bus_id != sub_id]
+        assert np.allclose(Vs[10:, other_buses], Vs_ref[10:, other_buses], atol=1e-6)
+
+        # the grid model is restored
+        computer.clear_topo_events()
+        Vs_no_event = time_series.compute_V_from_inj(prod_p, load_p, load_q)
+        assert np.allclose(Vs_no_event, Vs_ref)
+        time_series.close()
+        env.close()
+
+    def test_continue_on_divergence(self):
+        env_name = "l2rpn_case14_sandbox"
+        with warnings.catch_warnings():
+            warnings.filterwarnings("ignore")
+            env = grid2op.make(env_name, backend=LightSimBackend(), test=True)
+
+        time_series = TimeSerie(env)
+        prod_p, load_p, load_q = time_series.get_injections(scenario_id=0)
+        Vs_ref = time_series.compute_V_from_inj(prod_p, load_p, load_q)
+        # the powerflow cannot converge for these steps
+        prod_p[10:12] *= 20.
+        load_p[10:12] *= 20.
+        load_q[10:12] *= 20.
+        with warnings.catch_warnings():
+            warnings.filterwarnings("ignore")
+            time_series.compute_V_from_inj(prod_p, load_p, load_q, ignore_errors=True)
+        status = 1 * time_series.computer.get_steps_status()
+        assert np.all(status[:10] == 1)
+        assert status[10] == 0
+        assert np.all(status[11:] == -1)
+
+        assert not time_series.continue_on_divergence
+        time_series.continue_on_divergence = True
+        with warnings.catch_warnings():
+            warnings.filterwarnings("ignore")
+            Vs = time_series.compute_V_from_inj(prod_p, load_p, load_q, ignore_errors=True)
+        computer = time_series.computer
+        status = 1 * computer.get_steps_status()
+        nb_iter = 1 * computer.get_steps_nb_iter()
+        error = 1 * computer.get_steps_error()
+        assert np.all(status[10:12] == 0)
+        assert np.all(status[:10] == 1)
+        assert np.all(status[12:] == 1)
+        assert np.all(error[10:12] != int(ErrorType.NoError))
+        assert np.all(error[status == 1] == int(ErrorType.NoError))
+        assert np.all(nb_iter >= 1)
+        # the steps after the divergence are the same as without it
+        assert np.allclose(Vs[12:], Vs_ref[12:], atol=1e-6)
+        time_series.close()
+        env.close()
+
+    def test_predictor(self):
+        env_name = "l2rpn_case14_sandbox"
+        with warnings.catch_warnings():
+            warnings.filterwarnings("ignore")
+            env = grid2op.make(env_name, backend=LightSimBackend(), test=True)
+
+        time_series = TimeSerie(env)
+        prod_p, load_p, load_q = time_series.get_injections(scenario_id=0)
+        assert time_series.predictor == PredictorType.NoPredictor
+        Vs_ref = time_series.compute_V_from_inj(prod_p, load_p, load_q)
+        nb_iter_ref = time_series.computer.total_nb_iter()
+        assert nb_iter_ref == time_series.computer.get_steps_nb_iter().sum()
+        for predictor in [PredictorType.Linear, PredictorType.Quadratic, PredictorType.Jacobian]:
+            time_series.predictor = predictor
+            assert time_series.predictor == predictor
+            Vs = time_series.compute_V_from_inj(prod_p, load_p, load_q)
+            computer = time_series.computer
+            assert computer.get_status() == 1, f"error for {predictor}"
+            assert computer.total_nb_iter() == computer.get_steps_nb_iter().sum()
+            # only the initial guess changes, not the solution
+            assert np.allclose(Vs, Vs_ref, atol=1e-6), f"error for {predictor}"
+        time_series.close()
+        env.close()
+
+    def test_jacobian_reuse(self):
+        env_name = "l2rpn_case14_sandbox"
+        with warnings.catch_warnings():
+            warnings.filterwarnings("ignore")
+            env = grid2op.make(env_name, backend=LightSimBackend(), test=True)
+
+        time_series = TimeSerie(env)
+        prod_p, load_p, load_q = time_series.get_injections(scenario_id=0)
+        Vs_ref = time_series.compute_V_from_inj(prod_p, load_p, load_q)
+        computer = time_series.computer
+        assert computer.get_refactor_every() == 1
+        with self.assertRaises(RuntimeError):
+            computer.set_jacobian_reuse(0, 0.1)
+        with self.assertRaises(RuntimeError):
+            computer.set_jacobian_reuse(5, 1.5)
+        computer.set_jacobian_reuse(5, 0.5)
+        assert computer.get_refactor_every() == 5
+        assert abs(computer.get_refactor_ratio() - 0.5) <= 1e-8
+        Vs = time_series.compute_V_from_inj(prod_p, load_p, load_q)
+        assert computer.get_status() == 1
+        # only the path to the solution changes
+        assert np.allclose(Vs, Vs_ref, atol=1e-6)
+        time_series.close()
+        env.close()
+
 
 if __name__ == "__main__":
     unittest.main()
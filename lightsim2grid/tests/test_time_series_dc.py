@@ -52,6 +52,9 @@ class TestTSDC_14(unittest.TestCase):
                                                           seed=self.seed,
                                                           v_init=V_init)
         assert self.ts.computer.get_solver_type() == SolverType.DC
+        # all the steps are solved at once in DC
+        assert np.all(self.ts.computer.get_steps_status() == 1)
+        assert self.ts.computer.nb_solved() == self.ts.load_p.shape[0]
         assert np.any(res_p != res_p_dc)
         assert np.any(res_a != res_a_dc)
         assert np.any(res_v != res_v_dc)
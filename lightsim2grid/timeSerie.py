@@ -24,7 +24,7 @@ except ImportError as exc_:
     GRID2OP_INSTALLED = False
 
 from lightsim2grid.solver import SolverType
-from lightsim2grid_cpp import TimeSeriesCPP
+from lightsim2grid_cpp import TimeSeriesCPP, PredictorType
 
 # deprecated
 Computers = TimeSeriesCPP
@@ -109,6 +109,34 @@ class ___TimeSerie:
             # use the faster KLU if available
             self.computer.change_solver(SolverType.KLU)
     
+    @property
+    def nb_thread(self):
+        """Number of threads used to compute the time series (see :func:`TimeSeriesCPP.set_nb_thread`)"""
+        return self.computer.get_nb_thread()
+
+    @nb_thread.setter
+    def nb_thread(self, val):
+        self.computer.set_nb_thread(int(val))
+        self.clear()
+
+    @property
+    def continue_on_divergence(self):
+        """Whether the computation goes on after a step diverged (see :func:`TimeSeriesCPP.set_continue_on_divergence`)"""
+        return self.computer.get_continue_on_divergence()
+
+    @continue_on_divergence.setter
+    def continue_on_divergence(self, val):
+        self.computer.set_continue_on_divergence(bool(val))
+
+    @property
+    def predictor(self):
+        """How the initial voltages of each step are guessed (see :func:`TimeSeriesCPP.set_predictor`)"""
+        return self.computer.get_predictor()
+
+    @predictor.setter
+    def predictor(self, val):
+        self.computer.set_predictor(PredictorType(val))
+
     def get_injections(self, scenario_id=None, seed=None):
         """
         This function allows to retrieve the injection of the given scenario, for the given seed
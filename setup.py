@@ -152,6 +152,7 @@ src_files = ['src/main.cpp',
              "src/batch_algorithm/BaseBatchSolverSynch.cpp",
              "src/batch_algorithm/TimeSeries.cpp",
              "src/batch_algorithm/ContingencyAnalysis.cpp",
+             "src/batch_algorithm/ContingencyResultSink.cpp",
              "src/element_container/LineContainer.cpp",
              "src/element_container/GenericContainer.cpp",
              "src/element_container/ShuntContainer.cpp",
@@ -123,6 +123,44 @@ class ChooseSolver
             #endif  // CKTSO_SOLVER_AVAILABLE
         }
 
+        // jacobian reuse of all the Newton Raphson based solvers (see BaseNRAlgo::set_jacobian_reuse)
+        void set_jacobian_reuse(int refactor_every, real_type refactor_ratio){
+            _solver_lu.set_jacobian_reuse(refactor_every, refactor_ratio);  // checks the inputs
+            _solver_lu_single.set_jacobian_reuse(refactor_every, refactor_ratio);
+            #ifdef KLU_SOLVER_AVAILABLE
+                _solver_klu.set_jacobian_reuse(refactor_every, refactor_ratio);
+                _solver_klu_single.set_jacobian_reuse(refactor_every, refactor_ratio);
+            #endif  // KLU_SOLVER_AVAILABLE
+            #ifdef NICSLU_SOLVER_AVAILABLE
+                _solver_nicslu.set_jacobian_reuse(refactor_every, refactor_ratio);
+                _solver_nicslu_single.set_jacobian_reuse(refactor_every, refactor_ratio);
+            #endif  // NICSLU_SOLVER_AVAILABLE
+            #ifdef CKTSO_SOLVER_AVAILABLE
+                _solver_cktso.set_jacobian_reuse(refactor_every, refactor_ratio);
+                _solver_cktso_single.set_jacobian_reuse(refactor_every, refactor_ratio);
+            #endif  // CKTSO_SOLVER_AVAILABLE
+        }
+        // the values of Ybus were modified in place: the Newton Raphson based solvers cannot reuse
+        // the factorization of their jacobian (see BaseNRAlgo::tell_ybus_values_changed)
+        void tell_ybus_values_changed(){
+            _solver_lu.tell_ybus_values_changed();
+            _solver_lu_single.tell_ybus_values_changed();
+            #ifdef KLU_SOLVER_AVAILABLE
+                _solver_klu.tell_ybus_values_changed();
+                _solver_klu_single.tell_ybus_values_changed();
+            #endif  // KLU_SOLVER_AVAILABLE
+            #ifdef NICSLU_SOLVER_AVAILABLE
+                _solver_nicslu.tell_ybus_values_changed();
+                _solver_nicslu_single.tell_ybus_values_changed();
+            #endif  // NICSLU_SOLVER_AVAILABLE
+            #ifdef CKTSO_SOLVER_AVAILABLE
+                _solver_cktso.tell_ybus_values_changed();
+                _solver_cktso_single.tell_ybus_values_changed();
+            #endif  // CKTSO_SOLVER_AVAILABLE
+        }
+        int get_refactor_every() const {return _solver_lu.get_refactor_every();}
+        real_type get_refactor_ratio() const {return _solver_lu.get_refactor_ratio();}
+
         bool ac_solver_used() const{
             auto p_solver = get_prt_solver("ac_solver_used", false);
             return p_solver->IS_AC;
@@ -203,12 +241,38 @@ class ChooseSolver
             return p_solver -> compute_pf(Ybus, V, Sbus, slack_ids, slack_weights, pv, pq, max_iter, tol);
         }
 
+        bool predict_V(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                       CplxVect & V,
+                       const CplxVect & Sbus,
+                       const Eigen::VectorXi & slack_ids,
+                       const RealVect & slack_weights,
+                       const Eigen::VectorXi & pv,
+                       const Eigen::VectorXi & pq)
+        {
+            auto p_solver = get_prt_solver("predict_V", true);
+            return p_solver -> predict_V(Ybus, V, Sbus, slack_ids, slack_weights, pv, pq);
+        }
+
         Eigen::Ref<const CplxVect> get_V() const
         {
             auto p_solver = get_prt_solver("get_V", true);
             return p_solver -> get_V();
         }
 
+        // a powerflow has been computed with the current solver, and it converged
+        bool has_converged() const
+        {
+            if(_solver_type != _type_used_for_nr) return false;
+            auto p_solver = get_prt_solver("has_converged", false);
+            return p_solver -> converged();
+        }
+
+        void set_V(const CplxVect & V, const RealVect & Vm, const RealVect & Va)
+        {
+            auto p_solver = get_prt_solver("set_V", false);
+            p_solver -> set_V(V, Vm, Va);
+        }
+
         Eigen::Ref<const RealVect> get_Va() const
         {
             auto p_solver = get_prt_solver( "get_Va", true);
@@ -300,6 +364,25 @@ class ChooseSolver
             p_solver -> update_internal_Ybus(new_coeffs, add);
         }
 
+        bool compute_pf_multi(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                              const CplxVect & V,
+                              const RealMat & Sbuses,
+                              const Eigen::VectorXi & slack_ids,
+                              const RealVect & slack_weights,
+                              const Eigen::VectorXi & pv,
+                              const Eigen::VectorXi & pq,
+                              RealMat & Va){
+                if(_solver_type != SolverType::DC && 
+                   _solver_type != SolverType::KLUDC && 
+                   _solver_type != SolverType::NICSLUDC &&
+                   _solver_type != SolverType::CKTSODC){
+                throw std::runtime_error("ChooseSolver::compute_pf_multi: cannot solve multiple powerflows at once for a solver that is not DC.");
+                }
+            _type_used_for_nr = _solver_type;
+            auto p_solver = get_prt_solver("compute_pf_multi", true);
+            return p_solver -> compute_pf_multi(Ybus, V, Sbuses, slack_ids, slack_weights, pv, pq, Va);
+        }
+
         void tell_solver_control(const SolverControl & solver_control){
             auto p_solver = get_prt_solver("tell_solver_control", false);
             p_solver -> tell_solver_control(solver_control);
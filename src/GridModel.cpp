@@ -9,6 +9,7 @@
 #include "GridModel.h"
 #include "ChooseSolver.h"  // to avoid circular references
 #include <queue>
+#include <algorithm>
 
 
 GridModel::GridModel(const GridModel & other)
@@ -19,6 +20,14 @@ GridModel::GridModel(const GridModel & other)
     init_vm_pu_ = other.init_vm_pu_;
     sn_mva_ = other.sn_mva_;
     compute_results_ = other.compute_results_;
+    bus_reordering_ = other.bus_reordering_;
+    nb_ybus_full_fill_ = 0;
+    nb_ybus_inplace_fill_ = 0;
+    nb_sbus_full_fill_ = 0;
+    nb_sbus_delta_fill_ = 0;
+    nb_sbus_el_touched_ = 0;
+    nb_saved_states_ = 0;  // the snapshots (and the journal) are not copied
+    solver_setup_count_ = 0;
 
     // copy the powersystem representation
     // 1. bus
@@ -322,6 +331,7 @@ void GridModel::reset(bool reset_solver, bool reset_ac, bool reset_dc)
         id_ac_solver_to_me_ = std::vector<int>();
         slack_bus_id_ac_solver_ = Eigen::VectorXi();
         Ybus_ac_ = Eigen::SparseMatrix<cplx_type>();
+        ybus_fill_cache_ac_.clear();
     }
 
     if(reset_dc){
@@ -329,6 +339,7 @@ void GridModel::reset(bool reset_solver, bool reset_ac, bool reset_dc)
         id_dc_solver_to_me_ = std::vector<int>();
         slack_bus_id_dc_solver_ = Eigen::VectorXi();
         Ybus_dc_ = Eigen::SparseMatrix<cplx_type>();
+        ybus_fill_cache_dc_.clear();
     }
 
     timer_last_ac_pf_= 0.;
@@ -336,6 +347,8 @@ void GridModel::reset(bool reset_solver, bool reset_ac, bool reset_dc)
 
     acSbus_ = CplxVect();
     dcSbus_ = CplxVect();
+    sbus_fill_cache_ac_.clear();
+    sbus_fill_cache_dc_.clear();
     bus_pv_ = Eigen::VectorXi();
     bus_pq_ = Eigen::VectorXi();
     solver_control_.tell_all_changed();
@@ -345,6 +358,7 @@ void GridModel::reset(bool reset_solver, bool reset_ac, bool reset_dc)
     slack_bus_id_dc_me_ = Eigen::VectorXi();
     slack_bus_id_dc_solver_ = Eigen::VectorXi();
     slack_weights_ = RealVect();
+    ++solver_setup_count_;
 
     // reset the solvers
     if (reset_solver){
@@ -482,9 +496,9 @@ CplxVect GridModel::check_solution(const CplxVect & V_proposed, bool check_q_lim
                                     is_ac, reset_solver);
 
     // compute the mismatch
-    CplxVect tmp = Ybus_ac_ * V;  // this is a vector
-    tmp = tmp.array().conjugate();  // i take the conjugate
-    auto mis = V.array() * tmp.array() - acSbus_.array();  // TODO ac or dc here
+    CplxVect tmp;
+    BaseAlgo::compute_Ibus(Ybus_ac_, V, tmp);  // this is a vector
+    auto mis = V.array() * tmp.array().conjugate() - acSbus_.array();  // TODO ac or dc here
 
     // store results
     CplxVect res = _get_results_back_to_orig_nodes(mis,
@@ -516,6 +530,7 @@ CplxVect GridModel::pre_process_solver(const CplxVect & Vinit,
                                        const SolverControl & solver_control)
 {
     // TODO get rid of the "is_ac" argument: this info is available in the _solver already
+    ++solver_setup_count_;  // Ybus, Sbus and the solver are (possibly) modified, see restore_state
     if(is_ac){
         _solver.tell_solver_control(solver_control);
         if(solver_control.need_reset_solver()){   
@@ -540,13 +555,16 @@ CplxVect GridModel::pre_process_solver(const CplxVect & Vinit,
     if (solver_control.need_reset_solver() ||
         solver_control.ybus_change_sparsity_pattern() || 
         solver_control.has_dimension_changed()){
-            init_Ybus(Ybus, id_me_to_solver, id_solver_to_me);
+            init_Ybus(Ybus, id_me_to_solver, id_solver_to_me,
+                      solver_control.need_reset_solver() || solver_control.has_dimension_changed());
         }
     if (solver_control.need_reset_solver() ||
         solver_control.ybus_change_sparsity_pattern() || 
-        solver_control.has_dimension_changed() || 
-        solver_control.need_recompute_ybus()){
+        solver_control.has_dimension_changed()){
             fillYbus(Ybus, is_ac, id_me_to_solver);
+        } else if (solver_control.need_recompute_ybus()){
+            // only some coefficients changed
+            if(!updateYbus(Ybus, is_ac, id_me_to_solver)) fillYbus(Ybus, is_ac, id_me_to_solver);
         }
     if (solver_control.need_reset_solver() || 
         solver_control.has_dimension_changed()) {
@@ -578,9 +596,11 @@ CplxVect GridModel::pre_process_solver(const CplxVect & Vinit,
     if (solver_control.need_reset_solver() || 
         solver_control.has_dimension_changed() ||
         solver_control.has_slack_participate_changed() || 
-        solver_control.has_pq_changed() ||
-        solver_control.need_recompute_sbus()) {
+        solver_control.has_pq_changed()) {
             fillSbus_me(Sbus, is_ac, id_me_to_solver);
+        } else if (solver_control.need_recompute_sbus()){
+            // only some injections changed
+            if(!updateSbus(Sbus, is_ac, id_me_to_solver)) fillSbus_me(Sbus, is_ac, id_me_to_solver);
         }
     const int nb_bus_solver = static_cast<int>(id_solver_to_me.size());
     CplxVect V = CplxVect::Constant(nb_bus_solver, init_vm_pu_);
@@ -644,10 +664,15 @@ void GridModel::process_results(bool conv,
 
 void GridModel::init_Ybus(Eigen::SparseMatrix<cplx_type> & Ybus,
                           std::vector<int>& id_me_to_solver,
-                          std::vector<int>& id_solver_to_me){
+                          std::vector<int>& id_solver_to_me,
+                          bool recompute_bus_order){
     //TODO get disconnected bus !!! (and have some conversion for it)
     //1. init the conversion bus
     const int nb_bus_init = static_cast<int>(bus_vn_kv_.size());
+    // previous ordering, kept if the buses are reordered and the set of connected buses did not change
+    // (Sbus, pv, pq etc. are not recomputed in this case, they would not match a new ordering)
+    std::vector<int> prev_id_me_to_solver;
+    if(bus_reordering_ && !recompute_bus_order) prev_id_me_to_solver = id_me_to_solver;
     id_me_to_solver = std::vector<int>(nb_bus_init, _deactivated_bus_id);  // by default, if a bus is disconnected, then it has a -1 there
     id_solver_to_me = std::vector<int>();
     id_solver_to_me.reserve(nb_bus_init);
@@ -662,10 +687,135 @@ void GridModel::init_Ybus(Eigen::SparseMatrix<cplx_type> & Ybus,
     }
     const int nb_bus_solver = static_cast<int>(id_solver_to_me.size());
 
+    //2. reduce the bandwidth of Ybus (and of the jacobian) if asked
+    if(bus_reordering_){
+        bool same_buses = prev_id_me_to_solver.size() == id_me_to_solver.size();
+        for(int bus_id_me=0; same_buses && bus_id_me < nb_bus_init; ++bus_id_me){
+            const int prev_id = prev_id_me_to_solver[bus_id_me];
+            same_buses = (prev_id == _deactivated_bus_id) == (id_me_to_solver[bus_id_me] == _deactivated_bus_id);
+            same_buses = same_buses && (prev_id < nb_bus_solver);
+        }
+        if(same_buses){
+            id_me_to_solver = prev_id_me_to_solver;
+            for(int bus_id_me=0; bus_id_me < nb_bus_init; ++bus_id_me){
+                const int bus_id_solver = id_me_to_solver[bus_id_me];
+                if(bus_id_solver != _deactivated_bus_id) id_solver_to_me[bus_id_solver] = bus_id_me;
+            }
+        }else{
+            reorder_buses_rcm(id_me_to_solver, id_solver_to_me);
+        }
+    }
+
     Ybus = Eigen::SparseMatrix<cplx_type>(nb_bus_solver, nb_bus_solver);
     Ybus.reserve(nb_bus_solver + 2*powerlines_.nb() + 2*trafos_.nb());
 }
 
+void GridModel::reorder_buses_rcm(std::vector<int>& id_me_to_solver,
+                                  std::vector<int>& id_solver_to_me) const{
+    const int nb_bus_solver = static_cast<int>(id_solver_to_me.size());
+    if(nb_bus_solver <= 2) return;
+
+    // 1. the graph of Ybus (without the diagonal), with the solver labelling
+    std::vector<Eigen::Triplet<real_type> > tripletList_me;
+    tripletList_me.reserve(2 * powerlines_.nb() + 2 * trafos_.nb());
+    powerlines_.get_graph(tripletList_me);
+    trafos_.get_graph(tripletList_me);
+    std::vector<Eigen::Triplet<real_type> > tripletList;
+    tripletList.reserve(tripletList_me.size());
+    for(const auto & el : tripletList_me){
+        const int row = id_me_to_solver[el.row()];
+        const int col = id_me_to_solver[el.col()];
+        if((row == _deactivated_bus_id) || (col == _deactivated_bus_id) || (row == col)) continue;
+        tripletList.push_back(Eigen::Triplet<real_type>(row, col, 1.));
+    }
+    Eigen::SparseMatrix<real_type> graph = Eigen::SparseMatrix<real_type>(nb_bus_solver, nb_bus_solver);
+    graph.setFromTriplets(tripletList.begin(), tripletList.end());  // parallel branches are summed
+    graph.makeCompressed();
+    const int * outer = graph.outerIndexPtr();
+    const int * inner = graph.innerIndexPtr();
+    auto degree = [outer](int bus){return outer[bus + 1] - outer[bus];};
+
+    // breadth first search from "root" (restricted to the buses not already ordered), returns the depth
+    // of the tree and the bus of minimum degree in its last level
+    std::vector<int> level(nb_bus_solver, -1);
+    std::vector<int> touched;
+    touched.reserve(nb_bus_solver);
+    std::vector<bool> ordered(nb_bus_solver, false);
+    auto bfs = [&](int root, int & last_level_bus){
+        touched.clear();
+        touched.push_back(root);
+        level[root] = 0;
+        for(std::size_t head = 0; head < touched.size(); ++head){
+            const int bus = touched[head];
+            for(int k = outer[bus]; k < outer[bus + 1]; ++k){
+                const int other = inner[k];
+                if(ordered[other] || level[other] != -1) continue;
+                level[other] = level[bus] + 1;
+                touched.push_back(other);
+            }
+        }
+        const int depth = level[touched.back()];
+        last_level_bus = touched.back();
+        for(auto bus : touched){
+            if((level[bus] == depth) && (degree(bus) < degree(last_level_bus))) last_level_bus = bus;
+        }
+        for(auto bus : touched) level[bus] = -1;
+        return depth;
+    };
+
+    // 2. Cuthill McKee, one connected component at a time
+    std::vector<int> order;
+    order.reserve(nb_bus_solver);
+    std::vector<int> neighbors;
+    for(int first_bus = 0; first_bus < nb_bus_solver; ++first_bus){
+        if(ordered[first_bus]) continue;
+
+        // start from a pseudo peripheral bus (George and Liu): min degree bus of the component then
+        // min degree bus of the last level as long as it increases the depth of the tree
+        int root = first_bus;
+        int candidate;
+        bfs(root, candidate);
+        for(auto bus : touched){
+            if(degree(bus) < degree(root)) root = bus;
+        }
+        int depth = bfs(root, candidate);
+        for(int nb_try = 0; nb_try < nb_bus_solver; ++nb_try){
+            int next_candidate;
+            const int new_depth = bfs(candidate, next_candidate);
+            if(new_depth <= depth) break;
+            root = candidate;
+            depth = new_depth;
+            candidate = next_candidate;
+        }
+
+        // neighbors are added by increasing degree
+        std::size_t head = order.size();
+        order.push_back(root);
+        ordered[root] = true;
+        for(; head < order.size(); ++head){
+            const int bus = order[head];
+            neighbors.clear();
+            for(int k = outer[bus]; k < outer[bus + 1]; ++k){
+                const int other = inner[k];
+                if(ordered[other]) continue;
+                ordered[other] = true;
+                neighbors.push_back(other);
+            }
+            std::sort(neighbors.begin(), neighbors.end(),
+                      [&degree](int a, int b){return (degree(a) < degree(b)) || ((degree(a) == degree(b)) && (a < b));});
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+
+    // 3. reverse the ordering and relabel the buses
+    const std::vector<int> prev_id_solver_to_me = id_solver_to_me;
+    for(int bus_id_solver = 0; bus_id_solver < nb_bus_solver; ++bus_id_solver){
+        const int bus_id_me = prev_id_solver_to_me[order[nb_bus_solver - 1 - bus_id_solver]];
+        id_solver_to_me[bus_id_solver] = bus_id_me;
+        id_me_to_solver[bus_id_me] = bus_id_solver;
+    }
+}
+
 void GridModel::init_slack_bus(const CplxVect & Sbus,
                                const std::vector<int>& id_me_to_solver,
                                const std::vector<int>& id_solver_to_me,
@@ -719,18 +869,96 @@ void GridModel::fillYbus(Eigen::SparseMatrix<cplx_type> & res, bool ac, const st
 
     // init the Ybus matrix
     res.setZero();  // it should not be needed but might not hurt too much either.
-    std::vector<Eigen::Triplet<cplx_type> > tripletList;
+    YbusFillCache & cache = ac ? ybus_fill_cache_ac_ : ybus_fill_cache_dc_;
+    cache.clear();
+    std::vector<Eigen::Triplet<cplx_type> > & tripletList = cache.triplets;
     tripletList.reserve(bus_vn_kv_.size() + 4*powerlines_.nb() + 4*trafos_.nb() + shunts_.nb());
-    powerlines_.fillYbus(tripletList, ac, id_me_to_solver, sn_mva_);  // TODO have a function to dispatch that to all type of elements
-    shunts_.fillYbus(tripletList, ac, id_me_to_solver, sn_mva_);
-    trafos_.fillYbus(tripletList, ac, id_me_to_solver, sn_mva_);
-    loads_.fillYbus(tripletList, ac, id_me_to_solver, sn_mva_);
-    sgens_.fillYbus(tripletList, ac, id_me_to_solver, sn_mva_);
-    storages_.fillYbus(tripletList, ac, id_me_to_solver, sn_mva_);
-    generators_.fillYbus(tripletList, ac, id_me_to_solver, sn_mva_);
-    dc_lines_.fillYbus(tripletList, ac, id_me_to_solver, sn_mva_);
+    for(auto container : ybus_containers()){
+        container->fillYbus(tripletList, ac, id_me_to_solver, sn_mva_);
+        cache.container_end.push_back(tripletList.size());
+    }
     res.setFromTriplets(tripletList.begin(), tripletList.end());  // works because  "The initial contents of *this is destroyed"
     res.makeCompressed();
+    ++nb_ybus_full_fill_;
+}
+
+bool GridModel::updateYbus(Eigen::SparseMatrix<cplx_type> & res, bool ac, const std::vector<int>& id_me_to_solver){
+    YbusFillCache & cache = ac ? ybus_fill_cache_ac_ : ybus_fill_cache_dc_;
+    if(cache.container_end.empty() || !res.isCompressed()) return false;
+    const auto containers = ybus_containers();
+    bool has_changed = false;
+    for(auto container : containers) has_changed |= !container->get_ybus_changed().empty();
+    if(!has_changed) return false;  // the reason why Ybus should be recomputed is not known
+
+    // 1. position of each triplet in Ybus (once per sparsity pattern)
+    const int nnz = static_cast<int>(res.nonZeros());
+    const int * outer = res.outerIndexPtr();
+    const int * inner = res.innerIndexPtr();
+    if(cache.triplet_to_nnz.empty()){
+        const int nb_triplet = static_cast<int>(cache.triplets.size());
+        cache.triplet_to_nnz.resize(nb_triplet);
+        cache.nnz_triplets_ptr.assign(nnz + 1, 0);
+        for(int triplet_id = 0; triplet_id < nb_triplet; ++triplet_id){
+            const auto & triplet = cache.triplets[triplet_id];
+            const int * col_beg = inner + outer[triplet.col()];
+            const int * col_end = inner + outer[triplet.col() + 1];
+            const int * pos = std::lower_bound(col_beg, col_end, triplet.row());
+            const int nnz_id = static_cast<int>(pos - inner);
+            cache.triplet_to_nnz[triplet_id] = nnz_id;
+            ++cache.nnz_triplets_ptr[nnz_id + 1];
+        }
+        for(int nnz_id = 0; nnz_id < nnz; ++nnz_id) cache.nnz_triplets_ptr[nnz_id + 1] += cache.nnz_triplets_ptr[nnz_id];
+        // triplets are summed in their order by "setFromTriplets", the same order is kept here
+        std::vector<int> next = cache.nnz_triplets_ptr;
+        cache.nnz_triplets.resize(nb_triplet);
+        for(int triplet_id = 0; triplet_id < nb_triplet; ++triplet_id){
+            cache.nnz_triplets[next[cache.triplet_to_nnz[triplet_id]]++] = triplet_id;
+        }
+        cache.nnz_changed.assign(nnz, false);
+    }
+
+    // 2. new coefficients of the elements that changed
+    std::vector<Eigen::Triplet<cplx_type> > tripletList;
+    std::vector<int> nnz_changed;
+    std::size_t container_beg = 0;
+    for(std::size_t container_id = 0; container_id < containers.size(); ++container_id){
+        const std::size_t container_end = cache.container_end[container_id];
+        if(!containers[container_id]->get_ybus_changed().empty()){
+            tripletList.clear();
+            containers[container_id]->fillYbus(tripletList, ac, id_me_to_solver, sn_mva_);
+            if(tripletList.size() != container_end - container_beg){
+                // an element has been connected / disconnected: the triplets are not the same
+                cache.clear();
+                return false;
+            }
+            for(std::size_t i = 0; i < tripletList.size(); ++i){
+                auto & triplet = cache.triplets[container_beg + i];
+                if((tripletList[i].row() != triplet.row()) || (tripletList[i].col() != triplet.col())){
+                    cache.clear();
+                    return false;
+                }
+                if(tripletList[i].value() == triplet.value()) continue;
+                triplet = tripletList[i];
+                const int nnz_id = cache.triplet_to_nnz[container_beg + i];
+                if(cache.nnz_changed[nnz_id]) continue;
+                cache.nnz_changed[nnz_id] = true;
+                nnz_changed.push_back(nnz_id);
+            }
+        }
+        container_beg = container_end;
+    }
+
+    // 3. sum again the coefficients that changed
+    cplx_type * values = res.valuePtr();
+    for(auto nnz_id : nnz_changed){
+        int k = cache.nnz_triplets_ptr[nnz_id];
+        cplx_type tmp = cache.triplets[cache.nnz_triplets[k]].value();
+        for(++k; k < cache.nnz_triplets_ptr[nnz_id + 1]; ++k) tmp += cache.triplets[cache.nnz_triplets[k]].value();
+        values[nnz_id] = tmp;
+        cache.nnz_changed[nnz_id] = false;
+    }
+    ++nb_ybus_inplace_fill_;
+    return true;
 }
 
 void GridModel::fillSbus_me(CplxVect & Sbus, bool ac, const std::vector<int>& id_me_to_solver)
@@ -739,15 +967,412 @@ void GridModel::fillSbus_me(CplxVect & Sbus, bool ac, const std::vector<int>& id
     Sbus.array() = 0.;  // reset to 0.
     powerlines_.fillSbus(Sbus, id_me_to_solver, ac);  // TODO have a function to dispatch that to all type of elements
     trafos_.fillSbus(Sbus, id_me_to_solver, ac);
-    shunts_.fillSbus(Sbus, id_me_to_solver, ac);
-    loads_.fillSbus(Sbus, id_me_to_solver, ac);
-    sgens_.fillSbus(Sbus, id_me_to_solver, ac);
-    storages_.fillSbus(Sbus, id_me_to_solver, ac);
-    generators_.fillSbus(Sbus, id_me_to_solver, ac);
+
+    // the contributions of the elements are kept to be able to update Sbus when only some of them change
+    SbusFillCache & cache = ac ? sbus_fill_cache_ac_ : sbus_fill_cache_dc_;
+    const auto containers = sbus_containers();  // shunts, loads, sgens, storages and generators
+    const auto containers_nb = sbus_containers_nb();
+    cache.bus_id_solver.resize(containers.size());
+    cache.contribution.resize(containers.size());
+    cplx_type tmp;
+    for(std::size_t container_id = 0; container_id < containers.size(); ++container_id){
+        const int nb_el = containers_nb[container_id];
+        std::vector<int> & bus_id_solver = cache.bus_id_solver[container_id];
+        std::vector<cplx_type> & contribution = cache.contribution[container_id];
+        bus_id_solver.resize(nb_el);
+        contribution.resize(nb_el);
+        for(int el_id = 0; el_id < nb_el; ++el_id){
+            tmp = 0.;
+            bus_id_solver[el_id] = containers[container_id]->get_sbus_contribution(el_id, id_me_to_solver, ac, tmp);
+            contribution[el_id] = tmp;
+            if(bus_id_solver[el_id] != _deactivated_bus_id) Sbus.coeffRef(bus_id_solver[el_id]) += tmp;
+        }
+    }
     dc_lines_.fillSbus(Sbus, id_me_to_solver, ac);
     if (sn_mva_ != 1.0) Sbus /= sn_mva_;
     // in dc mode, this is used for the phase shifter, this should not be divided by sn_mva_ !
     trafos_.hack_Sbus_for_dc_phase_shifter(Sbus, ac, id_me_to_solver);
+    cache.change_serial = sbus_change_serial();
+    ++nb_sbus_full_fill_;
+    nb_sbus_el_touched_ = 2 * dc_lines_.nb();
+    for(auto nb_el : containers_nb) nb_sbus_el_touched_ += nb_el;
+}
+
+bool GridModel::updateSbus(CplxVect & Sbus, bool ac, const std::vector<int>& id_me_to_solver)
+{
+    SbusFillCache & cache = ac ? sbus_fill_cache_ac_ : sbus_fill_cache_dc_;
+    if(cache.bus_id_solver.empty()) return false;
+    // dc lines are made of two generators, they are not handled here
+    if(!dc_lines_.get_sbus_changed().empty()) return false;
+    const auto containers = sbus_containers();
+    const auto containers_nb = sbus_containers_nb();
+    bool has_changed = false;
+    for(std::size_t container_id = 0; container_id < containers.size(); ++container_id){
+        if(static_cast<int>(cache.bus_id_solver[container_id].size()) != containers_nb[container_id]){
+            // elements have been added or removed
+            cache.clear();
+            return false;
+        }
+        has_changed |= !containers[container_id]->get_sbus_changed().empty();
+    }
+    if(!has_changed) return false;  // the reason why Sbus should be recomputed is not known
+
+    int nb_touched = 0;
+    cplx_type tmp;
+    int bus_id_solver;
+    for(std::size_t container_id = 0; container_id < containers.size(); ++container_id){
+        std::vector<int> & prev_bus_id_solver = cache.bus_id_solver[container_id];
+        std::vector<cplx_type> & prev_contribution = cache.contribution[container_id];
+        for(auto el_id : containers[container_id]->get_sbus_changed()){
+            tmp = 0.;
+            bus_id_solver = containers[container_id]->get_sbus_contribution(el_id, id_me_to_solver, ac, tmp);
+            if((bus_id_solver == prev_bus_id_solver[el_id]) && (tmp == prev_contribution[el_id])) continue;  // already up to date
+            if(bus_id_solver == prev_bus_id_solver[el_id]){
+                Sbus.coeffRef(bus_id_solver) += (tmp - prev_contribution[el_id]) / sn_mva_;
+            }else{
+                // element connected / disconnected
+                if(prev_bus_id_solver[el_id] != _deactivated_bus_id) Sbus.coeffRef(prev_bus_id_solver[el_id]) -= prev_contribution[el_id] / sn_mva_;
+                if(bus_id_solver != _deactivated_bus_id) Sbus.coeffRef(bus_id_solver) += tmp / sn_mva_;
+            }
+            prev_bus_id_solver[el_id] = bus_id_solver;
+            prev_contribution[el_id] = tmp;
+            ++nb_touched;
+        }
+    }
+    cache.change_serial = sbus_change_serial();
+    ++nb_sbus_delta_fill_;
+    nb_sbus_el_touched_ = nb_touched;
+    return true;
+}
+
+int GridModel::save_state()
+{
+    if(nb_saved_states_ == static_cast<int>(saved_states_.size())) saved_states_.emplace_back();
+    SavedState & state = saved_states_[nb_saved_states_];
+    state.journal_size = journal_.size();
+    state.bus_status = bus_status_;
+    state.solver_control = solver_control_;
+    state.solver_setup_count = solver_setup_count_;
+    state.has_V = _solver.has_converged();
+    if(state.has_V){
+        state.V = _solver.get_V();
+        state.Vm = _solver.get_Vm();
+        state.Va = _solver.get_Va();
+        state.id_solver_to_me = id_ac_solver_to_me_;
+    }
+    return nb_saved_states_++;
+}
+
+void GridModel::forget_state(int token)
+{
+    if((token < 0) || (token >= nb_saved_states_))
+    {
+        std::ostringstream exc_;
+        exc_ << "GridModel::forget_state: there is no saved state with id " << token;
+        exc_ << " (there are " << nb_saved_states_ << " saved states).";
+        throw std::out_of_range(exc_.str());
+    }
+    nb_saved_states_ = token;
+    // the journal is still needed by the previous snapshots (if any)
+    if(nb_saved_states_ == 0) journal_.clear();
+}
+
+void GridModel::restore_state(int token)
+{
+    if((token < 0) || (token >= nb_saved_states_))
+    {
+        std::ostringstream exc_;
+        exc_ << "GridModel::restore_state: there is no saved state with id " << token;
+        exc_ << " (there are " << nb_saved_states_ << " saved states).";
+        throw std::out_of_range(exc_.str());
+    }
+    const SavedState & state = saved_states_[token];
+
+    // undo the modifications, last one first
+    while(journal_.size() > state.journal_size){
+        _journal_undo(journal_.back());
+        journal_.pop_back();
+    }
+    bus_status_ = state.bus_status;
+
+    if((solver_setup_count_ == state.solver_setup_count) && !solver_control_.need_reset_solver()){
+        // Ybus and the solver have not been touched since the state was saved, and the topology is now
+        // the same as it was at that time: they are still valid. Only the flags set by the modifications 
+        // that do not concern the topology are kept.
+        SolverControl restored = state.solver_control;
+        if(solver_control_.has_pv_changed()) restored.tell_pv_changed();
+        if(solver_control_.has_pq_changed()) restored.tell_pq_changed();
+        if(solver_control_.has_slack_participate_changed()) restored.tell_slack_participate_changed();
+        if(solver_control_.need_recompute_sbus()) restored.tell_recompute_sbus();
+        if(solver_control_.has_v_changed()) restored.tell_v_changed();
+        if(solver_control_.has_slack_weight_changed()) restored.tell_slack_weight_changed();
+        solver_control_ = restored;
+    }
+
+    if(state.has_V && (state.id_solver_to_me == id_ac_solver_to_me_)){
+        // the buses of the ac solver are the same: the results of the powerflow can be restored
+        _solver.set_V(state.V, state.Vm, state.Va);
+    }
+
+    nb_saved_states_ = token;
+    if(nb_saved_states_ == 0) journal_.clear();
+}
+
+void GridModel::_journal_record(JournalField field, int el_id)
+{
+    // the previous value is recorded, out of range ids are not (the modification will throw anyway)
+    JournalEntry entry = {field, el_id, 0, 0.};
+    switch(field)
+    {
+    case JournalField::LineStatus:
+        if((el_id < 0) || (el_id >= powerlines_.nb())) return;
+        entry.int_value = powerlines_.get_status()[el_id] ? 1 : 0;
+        break;
+    case JournalField::LineBusOr:
+        if((el_id < 0) || (el_id >= powerlines_.nb())) return;
+        entry.int_value = powerlines_.get_bus_from()(el_id);
+        break;
+    case JournalField::LineBusEx:
+        if((el_id < 0) || (el_id >= powerlines_.nb())) return;
+        entry.int_value = powerlines_.get_bus_to()(el_id);
+        break;
+    case JournalField::TrafoStatus:
+        if((el_id < 0) || (el_id >= trafos_.nb())) return;
+        entry.int_value = trafos_.get_status()[el_id] ? 1 : 0;
+        break;
+    case JournalField::TrafoBusHv:
+        if((el_id < 0) || (el_id >= trafos_.nb())) return;
+        entry.int_value = trafos_.get_bus_from()(el_id);
+        break;
+    case JournalField::TrafoBusLv:
+        if((el_id < 0) || (el_id >= trafos_.nb())) return;
+        entry.int_value = trafos_.get_bus_to()(el_id);
+        break;
+    case JournalField::LoadStatus:
+        if((el_id < 0) || (el_id >= loads_.nb())) return;
+        entry.int_value = loads_.get_status()[el_id] ? 1 : 0;
+        break;
+    case JournalField::LoadBus:
+        if((el_id < 0) || (el_id >= loads_.nb())) return;
+        entry.int_value = loads_.get_bus_id()(el_id);
+        break;
+    case JournalField::LoadP:
+        if((el_id < 0) || (el_id >= loads_.nb())) return;
+        entry.real_value = loads_.get_p_mw(el_id);
+        break;
+    case JournalField::LoadQ:
+        if((el_id < 0) || (el_id >= loads_.nb())) return;
+        entry.real_value = loads_.get_q_mvar(el_id);
+        break;
+    case JournalField::GenStatus:
+        if((el_id < 0) || (el_id >= generators_.nb())) return;
+        entry.int_value = generators_.get_status()[el_id] ? 1 : 0;
+        break;
+    case JournalField::GenBus:
+        if((el_id < 0) || (el_id >= generators_.nb())) return;
+        entry.int_value = generators_.get_bus_id()(el_id);
+        break;
+    case JournalField::GenP:
+        if((el_id < 0) || (el_id >= generators_.nb())) return;
+        entry.real_value = generators_.get_p_mw(el_id);
+        break;
+    case JournalField::GenV:
+        if((el_id < 0) || (el_id >= generators_.nb())) return;
+        entry.real_value = generators_.get_vm_pu(el_id);
+        break;
+    case JournalField::ShuntStatus:
+        if((el_id < 0) || (el_id >= shunts_.nb())) return;
+        entry.int_value = shunts_.get_status()[el_id] ? 1 : 0;
+        break;
+    case JournalField::ShuntBus:
+        if((el_id < 0) || (el_id >= shunts_.nb())) return;
+        entry.int_value = shunts_.get_bus_id()(el_id);
+        break;
+    case JournalField::ShuntP:
+        if((el_id < 0) || (el_id >= shunts_.nb())) return;
+        entry.real_value = shunts_.get_p_mw()(el_id);
+        break;
+    case JournalField::ShuntQ:
+        if((el_id < 0) || (el_id >= shunts_.nb())) return;
+        entry.real_value = shunts_.get_q_mvar()(el_id);
+        break;
+    case JournalField::SGenStatus:
+        if((el_id < 0) || (el_id >= sgens_.nb())) return;
+        entry.int_value = sgens_.get_status()[el_id] ? 1 : 0;
+        break;
+    case JournalField::SGenBus:
+        if((el_id < 0) || (el_id >= sgens_.nb())) return;
+        entry.int_value = sgens_.get_bus_id()(el_id);
+        break;
+    case JournalField::SGenP:
+        if((el_id < 0) || (el_id >= sgens_.nb())) return;
+        entry.real_value = sgens_.get_p_mw(el_id);
+        break;
+    case JournalField::SGenQ:
+        if((el_id < 0) || (el_id >= sgens_.nb())) return;
+        entry.real_value = sgens_.get_q_mvar(el_id);
+        break;
+    case JournalField::StorageStatus:
+        if((el_id < 0) || (el_id >= storages_.nb())) return;
+        entry.int_value = storages_.get_status()[el_id] ? 1 : 0;
+        break;
+    case JournalField::StorageBus:
+        if((el_id < 0) || (el_id >= storages_.nb())) return;
+        entry.int_value = storages_.get_bus_id()(el_id);
+        break;
+    case JournalField::StorageP:
+        if((el_id < 0) || (el_id >= storages_.nb())) return;
+        entry.real_value = storages_.get_p_mw(el_id);
+        break;
+    case JournalField::StorageQ:
+        if((el_id < 0) || (el_id >= storages_.nb())) return;
+        entry.real_value = storages_.get_q_mvar(el_id);
+        break;
+    case JournalField::DCLineStatus:
+        if((el_id < 0) || (el_id >= dc_lines_.nb())) return;
+        entry.int_value = dc_lines_.get_status()[el_id] ? 1 : 0;
+        break;
+    case JournalField::DCLineP:
+        if((el_id < 0) || (el_id >= dc_lines_.nb())) return;
+        entry.real_value = dc_lines_.get_p_mw(el_id);
+        break;
+    case JournalField::DCLineVOr:
+        if((el_id < 0) || (el_id >= dc_lines_.nb())) return;
+        entry.real_value = dc_lines_.get_vm_or_pu(el_id);
+        break;
+    case JournalField::DCLineVEx:
+        if((el_id < 0) || (el_id >= dc_lines_.nb())) return;
+        entry.real_value = dc_lines_.get_vm_ex_pu(el_id);
+        break;
+    case JournalField::DCLineBusOr:
+        if((el_id < 0) || (el_id >= dc_lines_.nb())) return;
+        entry.int_value = dc_lines_.get_bus_from()(el_id);
+        break;
+    case JournalField::DCLineBusEx:
+        if((el_id < 0) || (el_id >= dc_lines_.nb())) return;
+        entry.int_value = dc_lines_.get_bus_to()(el_id);
+        break;
+    }
+    journal_.push_back(entry);
+}
+
+void GridModel::_journal_undo(const JournalEntry & entry)
+{
+    // the modifications are undone with the methods of the containers (and not the ones of the GridModel)
+    // so that they are not recorded again. The setpoints are only set back if they changed: the modification 
+    // might have failed (eg. element disconnected) in which case the "undo" could fail too.
+    const int el_id = entry.el_id;
+    const int nb_bus = static_cast<int>(bus_vn_kv_.size());
+    const bool status = entry.int_value != 0;
+    const int bus_id = entry.int_value;
+    const real_type value = entry.real_value;
+    switch(entry.field)
+    {
+    case JournalField::LineStatus:
+        if(status) powerlines_.reactivate(el_id, solver_control_);
+        else powerlines_.deactivate(el_id, solver_control_);
+        break;
+    case JournalField::LineBusOr:
+        if(bus_id >= 0) powerlines_.change_bus_or(el_id, bus_id, solver_control_, nb_bus);
+        break;
+    case JournalField::LineBusEx:
+        if(bus_id >= 0) powerlines_.change_bus_ex(el_id, bus_id, solver_control_, nb_bus);
+        break;
+    case JournalField::TrafoStatus:
+        if(status) trafos_.reactivate(el_id, solver_control_);
+        else trafos_.deactivate(el_id, solver_control_);
+        break;
+    case JournalField::TrafoBusHv:
+        if(bus_id >= 0) trafos_.change_bus_hv(el_id, bus_id, solver_control_, nb_bus);
+        break;
+    case JournalField::TrafoBusLv:
+        if(bus_id >= 0) trafos_.change_bus_lv(el_id, bus_id, solver_control_, nb_bus);
+        break;
+    case JournalField::LoadStatus:
+        if(status) loads_.reactivate(el_id, solver_control_);
+        else loads_.deactivate(el_id, solver_control_);
+        break;
+    case JournalField::LoadBus:
+        if(bus_id >= 0) loads_.change_bus(el_id, bus_id, solver_control_, nb_bus);
+        break;
+    case JournalField::LoadP:
+        loads_.change_p_nothrow(el_id, value, solver_control_);
+        break;
+    case JournalField::LoadQ:
+        loads_.change_q_nothrow(el_id, value, solver_control_);
+        break;
+    case JournalField::GenStatus:
+        if(status) generators_.reactivate(el_id, solver_control_);
+        else generators_.deactivate(el_id, solver_control_);
+        break;
+    case JournalField::GenBus:
+        if(bus_id >= 0) generators_.change_bus(el_id, bus_id, solver_control_, nb_bus);
+        break;
+    case JournalField::GenP:
+        if(generators_.get_p_mw(el_id) != value) generators_.change_p(el_id, value, solver_control_);
+        break;
+    case JournalField::GenV:
+        if(generators_.get_vm_pu(el_id) != value) generators_.change_v(el_id, value, solver_control_);
+        break;
+    case JournalField::ShuntStatus:
+        if(status) shunts_.reactivate(el_id, solver_control_);
+        else shunts_.deactivate(el_id, solver_control_);
+        break;
+    case JournalField::ShuntBus:
+        if(bus_id >= 0) shunts_.change_bus(el_id, bus_id, solver_control_, nb_bus);
+        break;
+    case JournalField::ShuntP:
+        if(shunts_.get_p_mw()(el_id) != value) shunts_.change_p(el_id, value, solver_control_);
+        break;
+    case JournalField::ShuntQ:
+        if(shunts_.get_q_mvar()(el_id) != value) shunts_.change_q(el_id, value, solver_control_);
+        break;
+    case JournalField::SGenStatus:
+        if(status) sgens_.reactivate(el_id, solver_control_);
+        else sgens_.deactivate(el_id, solver_control_);
+        break;
+    case JournalField::SGenBus:
+        if(bus_id >= 0) sgens_.change_bus(el_id, bus_id, solver_control_, nb_bus);
+        break;
+    case JournalField::SGenP:
+        if(sgens_.get_p_mw(el_id) != value) sgens_.change_p(el_id, value, solver_control_);
+        break;
+    case JournalField::SGenQ:
+        if(sgens_.get_q_mvar(el_id) != value) sgens_.change_q(el_id, value, solver_control_);
+        break;
+    case JournalField::StorageStatus:
+        if(status) storages_.reactivate(el_id, solver_control_);
+        else storages_.deactivate(el_id, solver_control_);
+        break;
+    case JournalField::StorageBus:
+        if(bus_id >= 0) storages_.change_bus(el_id, bus_id, solver_control_, nb_bus);
+        break;
+    case JournalField::StorageP:
+        storages_.change_p_nothrow(el_id, value, solver_control_);
+        break;
+    case JournalField::StorageQ:
+        storages_.change_q_nothrow(el_id, value, solver_control_);
+        break;
+    case JournalField::DCLineStatus:
+        if(status) dc_lines_.reactivate(el_id, solver_control_);
+        else dc_lines_.deactivate(el_id, solver_control_);
+        break;
+    case JournalField::DCLineP:
+        if(dc_lines_.get_p_mw(el_id) != value) dc_lines_.change_p(el_id, value, solver_control_);
+        break;
+    case JournalField::DCLineVOr:
+        if(dc_lines_.get_vm_or_pu(el_id) != value) dc_lines_.change_v_or(el_id, value, solver_control_);
+        break;
+    case JournalField::DCLineVEx:
+        if(dc_lines_.get_vm_ex_pu(el_id) != value) dc_lines_.change_v_ex(el_id, value, solver_control_);
+        break;
+    case JournalField::DCLineBusOr:
+        if(bus_id >= 0) dc_lines_.change_bus_or(el_id, bus_id, solver_control_, nb_bus);
+        break;
+    case JournalField::DCLineBusEx:
+        if(bus_id >= 0) dc_lines_.change_bus_ex(el_id, bus_id, solver_control_, nb_bus);
+        break;
+    }
 }
 
 void GridModel::fillpv_pq(const std::vector<int>& id_me_to_solver,
@@ -817,8 +1442,9 @@ void GridModel::compute_results(bool ac){
     RealVect active_mismatch;
     if(ac){
         // In AC mode i am not forced to run through all the grid
-        auto tmp = (Ybus_ac_ * V).conjugate();
-        mismatch = V.array() * tmp.array() - acSbus_.array();
+        CplxVect tmp;
+        BaseAlgo::compute_Ibus(Ybus_ac_, V, tmp);
+        mismatch = V.array() * tmp.array().conjugate() - acSbus_.array();
         active_mismatch = mismatch.real() * sn_mva_;
     } else{
         active_mismatch = RealVect::Zero(V.size());
@@ -1137,6 +1763,22 @@ void GridModel::update_topo(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, Eigen:
     dc_lines_.update_bus_status(bus_status_);
 }
 
+void GridModel::deactivate_buses_without_element(const std::vector<int> & bus_ids)
+{
+    std::vector<bool> has_element(bus_status_.size(), false);
+    powerlines_.update_bus_status(has_element);
+    shunts_.update_bus_status(has_element);
+    trafos_.update_bus_status(has_element);
+    loads_.update_bus_status(has_element);
+    sgens_.update_bus_status(has_element);
+    storages_.update_bus_status(has_element);
+    generators_.update_bus_status(has_element);
+    dc_lines_.update_bus_status(has_element);
+    for(auto bus_id : bus_ids){
+        if(bus_status_[bus_id] && !has_element[bus_id]) deactivate_bus(bus_id);
+    }
+}
+
 // for FDPF (implementation of the alg 2 method FDBX (FDXB will follow)  // TODO FDPF
 void GridModel::fillBp_Bpp(Eigen::SparseMatrix<real_type> & Bp, 
                            Eigen::SparseMatrix<real_type> & Bpp, 
@@ -1310,4 +1952,5 @@ void GridModel::consider_only_main_component(){
     dc_lines_.disconnect_if_not_in_main_component(visited);
     // and finally deal with the buses
     init_bus_status();
+    ++solver_setup_count_;  // this is not recorded in the journal (see restore_state)
 }
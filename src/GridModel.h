@@ -42,6 +42,12 @@
 // enum class SolverType;
 
 //TODO implement a BFS check to make sure the Ymatrix is "connected" [one single component]
+/**
+A GridModel (and everything it owns: elements, solvers, linear solvers) does not use any shared mutable
+state (no mutable static, each linear solver has its own workspace): different instances can be used
+concurrently from different threads (the python GIL is released in ac_pf, dc_pf, check_solution,
+get_ptdf and get_lodf). A single instance should not be used by multiple threads at the same time.
+**/
 class GridModel : public GenericContainer
 {
     public:
@@ -97,7 +103,15 @@ class GridModel : public GenericContainer
           solver_control_(),
           compute_results_(true),
           init_vm_pu_(1.04),
+          bus_reordering_(false),
           sn_mva_(1.0),
+          nb_ybus_full_fill_(0),
+          nb_ybus_inplace_fill_(0),
+          nb_sbus_full_fill_(0),
+          nb_sbus_delta_fill_(0),
+          nb_sbus_el_touched_(0),
+          nb_saved_states_(0),
+          solver_setup_count_(0),
           max_nb_bus_per_sub_(2){
             _solver.change_solver(SolverType::SparseLU);
             _dc_solver.change_solver(SolverType::DC);
@@ -171,7 +185,14 @@ class GridModel : public GenericContainer
         void set_init_vm_pu(real_type init_vm_pu) {init_vm_pu_ = init_vm_pu; }
         real_type get_init_vm_pu() {return init_vm_pu_;}
         void set_sn_mva(real_type sn_mva) {sn_mva_ = sn_mva; }
-        real_type get_sn_mva() {return sn_mva_;}
+        real_type get_sn_mva() const {return sn_mva_;}
+
+        // renumber the buses of the solver (reverse Cuthill McKee) to reduce the bandwidth of Ybus
+        void set_bus_reordering(bool bus_reordering) {
+            if(bus_reordering != bus_reordering_) solver_control_.tell_all_changed();
+            bus_reordering_ = bus_reordering;
+        }
+        bool get_bus_reordering() const {return bus_reordering_;}
 
         void init_powerlines(const RealVect & branch_r,
                              const RealVect & branch_x,
@@ -297,13 +318,72 @@ class GridModel : public GenericContainer
         //powerflows
         // control the need to refactorize the topology
         void unset_changes(){
+            // the changes of the injections are forgotten: a Sbus that did not see them (eg only the dc powerflow
+            // has been computed since) will need to be fully recomputed
+            const unsigned long sbus_serial = sbus_change_serial();
+            if(sbus_fill_cache_ac_.change_serial != sbus_serial) sbus_fill_cache_ac_.clear();
+            if(sbus_fill_cache_dc_.change_serial != sbus_serial) sbus_fill_cache_dc_.clear();
             solver_control_.tell_none_changed();
+            // ybus_containers() lists all the elements of the grid (including the ones of sbus_containers() and the dc lines)
+            for(auto container : ybus_containers()){
+                container->clear_ybus_changed();
+                container->clear_sbus_changed();
+            }
+        }  //should be used after the powerflow as run, so some vectors will not be recomputed if not needed.
+        void tell_recompute_ybus(){
+            // the elements that changed are not known: Ybus will be fully recomputed
+            solver_control_.tell_recompute_ybus();
+            ++solver_setup_count_;  // see restore_state
+            ybus_fill_cache_ac_.clear();
+            ybus_fill_cache_dc_.clear();
+        }  //should be used after the powerflow as run, so some vectors will not be recomputed if not needed.
+        void tell_recompute_sbus(){
+            // the elements that changed are not known: Sbus will be fully recomputed
+            solver_control_.tell_recompute_sbus();
+            sbus_fill_cache_ac_.clear();
+            sbus_fill_cache_dc_.clear();
         }  //should be used after the powerflow as run, so some vectors will not be recomputed if not needed.
-        void tell_recompute_ybus(){solver_control_.tell_recompute_ybus();}  //should be used after the powerflow as run, so some vectors will not be recomputed if not needed.
-        void tell_recompute_sbus(){solver_control_.tell_recompute_sbus();}  //should be used after the powerflow as run, so some vectors will not be recomputed if not needed.
         void tell_solver_need_reset(){solver_control_.tell_solver_need_reset();}  //should be used after the powerflow as run, so some vectors will not be recomputed if not needed.
-        void tell_ybus_change_sparsity_pattern(){solver_control_.tell_ybus_change_sparsity_pattern();}  //should be used after the powerflow as run, so some vectors will not be recomputed if not needed.
+        void tell_ybus_change_sparsity_pattern(){
+            solver_control_.tell_ybus_change_sparsity_pattern();
+            ++solver_setup_count_;  // see restore_state
+        }  //should be used after the powerflow as run, so some vectors will not be recomputed if not needed.  //should be used after the powerflow as run, so some vectors will not be recomputed if not needed.
         const SolverControl & get_solver_control() const {return solver_control_;}
+        // number of times the Ybus matrices (ac and dc) have been fully recomputed and updated in place
+        std::tuple<int, int> get_ybus_fill_counters() const {return {nb_ybus_full_fill_, nb_ybus_inplace_fill_};}
+        // number of times the Sbus vectors (ac and dc) have been fully recomputed and updated with the elements that
+        // changed, and the number of elements whose contribution has been modified by the last update
+        std::tuple<int, int, int> get_sbus_fill_counters() const {return {nb_sbus_full_fill_, nb_sbus_delta_fill_, nb_sbus_el_touched_};}
+
+        /**
+        Snapshots of the grid, for "modify the grid -> compute a powerflow -> undo the modifications" loops
+        without copying the GridModel. They nest like a stack:
+
+        .. code-block:: cpp
+
+            int token = grid.save_state();
+            grid.deactivate_powerline(0);
+            grid.ac_pf(V, 10, 1e-8);
+            grid.restore_state(token);  // same grid as before "deactivate_powerline"
+
+        While a snapshot exists, the modifications made with the "deactivate_xxx", "reactivate_xxx", "change_bus_xxx"
+        and "change_p / q / v_xxx" methods (and so "update_topo", "update_loads_p" etc.) are recorded in a journal, 
+        that is undone (in reverse order) by restore_state. The status of the buses and the voltages computed by the 
+        last AC powerflow are saved as well. Other modifications (solver, slack weights, parameters of the elements 
+        etc.) are not.
+
+        When no powerflow has been computed since the snapshot, the Ybus matrix and the solver are kept as they are 
+        (the topology is the same) instead of being recomputed at the next powerflow.
+
+        The memory used by the journal and the snapshots is reused: once a given depth has been reached, saving 
+        and restoring a state does not allocate anything.
+        **/
+        int save_state();
+        // undo all the modifications since the snapshot "token" was saved, this snapshot and the ones saved after it are removed
+        void restore_state(int token);
+        // removes the snapshot "token" and the ones saved after it, without modifying the grid
+        void forget_state(int token);
+        int nb_saved_states() const {return nb_saved_states_;}
 
         // dc powerflow
         CplxVect dc_pf(const CplxVect & Vinit,
@@ -377,6 +457,9 @@ class GridModel : public GenericContainer
                 _reactivate(bus_id, bus_status_); 
             }
         }
+        // deactivate the buses among `bus_ids` to which no (connected) element is connected anymore,
+        // for example after all the elements of a bus have been moved to another one
+        void deactivate_buses_without_element(const std::vector<int> & bus_ids);
         /**
          * @brief Return the total number of connected buses !
          * 
@@ -433,58 +516,59 @@ class GridModel : public GenericContainer
         }
 
         //deactivate a powerline (disconnect it)
-        void deactivate_powerline(int powerline_id) {powerlines_.deactivate(powerline_id, solver_control_); }
-        void reactivate_powerline(int powerline_id) {powerlines_.reactivate(powerline_id, solver_control_); }
-        void change_bus_powerline_or(int powerline_id, int new_bus_id) {powerlines_.change_bus_or(powerline_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
-        void change_bus_powerline_ex(int powerline_id, int new_bus_id) {powerlines_.change_bus_ex(powerline_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
+        void deactivate_powerline(int powerline_id) {_journal(JournalField::LineStatus, powerline_id); powerlines_.deactivate(powerline_id, solver_control_); }
+        void reactivate_powerline(int powerline_id) {_journal(JournalField::LineStatus, powerline_id); powerlines_.reactivate(powerline_id, solver_control_); }
+        void change_bus_powerline_or(int powerline_id, int new_bus_id) {_journal(JournalField::LineBusOr, powerline_id); powerlines_.change_bus_or(powerline_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
+        void change_bus_powerline_ex(int powerline_id, int new_bus_id) {_journal(JournalField::LineBusEx, powerline_id); powerlines_.change_bus_ex(powerline_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
         int get_bus_powerline_or(int powerline_id) {return powerlines_.get_bus_or(powerline_id);}
         int get_bus_powerline_ex(int powerline_id) {return powerlines_.get_bus_ex(powerline_id);}
 
         //deactivate trafo
-        void deactivate_trafo(int trafo_id) {trafos_.deactivate(trafo_id, solver_control_); }
-        void reactivate_trafo(int trafo_id) {trafos_.reactivate(trafo_id, solver_control_); }
-        void change_bus_trafo_hv(int trafo_id, int new_bus_id) {trafos_.change_bus_hv(trafo_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
-        void change_bus_trafo_lv(int trafo_id, int new_bus_id) {trafos_.change_bus_lv(trafo_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
+        void deactivate_trafo(int trafo_id) {_journal(JournalField::TrafoStatus, trafo_id); trafos_.deactivate(trafo_id, solver_control_); }
+        void reactivate_trafo(int trafo_id) {_journal(JournalField::TrafoStatus, trafo_id); trafos_.reactivate(trafo_id, solver_control_); }
+        void change_bus_trafo_hv(int trafo_id, int new_bus_id) {_journal(JournalField::TrafoBusHv, trafo_id); trafos_.change_bus_hv(trafo_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
+        void change_bus_trafo_lv(int trafo_id, int new_bus_id) {_journal(JournalField::TrafoBusLv, trafo_id); trafos_.change_bus_lv(trafo_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
         int get_bus_trafo_hv(int trafo_id) {return trafos_.get_bus_hv(trafo_id);}
         int get_bus_trafo_lv(int trafo_id) {return trafos_.get_bus_lv(trafo_id);}
 
         //load
-        void deactivate_load(int load_id) {loads_.deactivate(load_id, solver_control_); }
-        void reactivate_load(int load_id) {loads_.reactivate(load_id, solver_control_); }
-        void change_bus_load(int load_id, int new_bus_id) {loads_.change_bus(load_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
-        void change_p_load(int load_id, real_type new_p) {loads_.change_p(load_id, new_p, solver_control_); }
-        void change_q_load(int load_id, real_type new_q) {loads_.change_q(load_id, new_q, solver_control_); }
+        void deactivate_load(int load_id) {_journal(JournalField::LoadStatus, load_id); loads_.deactivate(load_id, solver_control_); }
+        void reactivate_load(int load_id) {_journal(JournalField::LoadStatus, load_id); loads_.reactivate(load_id, solver_control_); }
+        void change_bus_load(int load_id, int new_bus_id) {_journal(JournalField::LoadBus, load_id); loads_.change_bus(load_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
+        void change_p_load(int load_id, real_type new_p) {_journal(JournalField::LoadP, load_id); loads_.change_p(load_id, new_p, solver_control_); }
+        void change_q_load(int load_id, real_type new_q) {_journal(JournalField::LoadQ, load_id); loads_.change_q(load_id, new_q, solver_control_); }
         int get_bus_load(int load_id) {return loads_.get_bus(load_id);}
 
         //generator
-        void deactivate_gen(int gen_id) {generators_.deactivate(gen_id, solver_control_); }
-        void reactivate_gen(int gen_id) {generators_.reactivate(gen_id, solver_control_); }
-        void change_bus_gen(int gen_id, int new_bus_id) {generators_.change_bus(gen_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
-        void change_p_gen(int gen_id, real_type new_p) {generators_.change_p(gen_id, new_p, solver_control_); }
-        void change_v_gen(int gen_id, real_type new_v_pu) {generators_.change_v(gen_id, new_v_pu, solver_control_); }
+        void deactivate_gen(int gen_id) {_journal(JournalField::GenStatus, gen_id); generators_.deactivate(gen_id, solver_control_); }
+        void reactivate_gen(int gen_id) {_journal(JournalField::GenStatus, gen_id); generators_.reactivate(gen_id, solver_control_); }
+        void change_bus_gen(int gen_id, int new_bus_id) {_journal(JournalField::GenBus, gen_id); generators_.change_bus(gen_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
+        void change_p_gen(int gen_id, real_type new_p) {_journal(JournalField::GenP, gen_id); generators_.change_p(gen_id, new_p, solver_control_); }
+        void change_v_gen(int gen_id, real_type new_v_pu) {_journal(JournalField::GenV, gen_id); generators_.change_v(gen_id, new_v_pu, solver_control_); }
         int get_bus_gen(int gen_id) {return generators_.get_bus(gen_id);}
 
         //shunt
-        void deactivate_shunt(int shunt_id) {shunts_.deactivate(shunt_id, solver_control_); }
-        void reactivate_shunt(int shunt_id) {shunts_.reactivate(shunt_id, solver_control_); }
-        void change_bus_shunt(int shunt_id, int new_bus_id) {shunts_.change_bus(shunt_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size()));  }
-        void change_p_shunt(int shunt_id, real_type new_p) {shunts_.change_p(shunt_id, new_p, solver_control_); }
-        void change_q_shunt(int shunt_id, real_type new_q) {shunts_.change_q(shunt_id, new_q, solver_control_); }
+        void deactivate_shunt(int shunt_id) {_journal(JournalField::ShuntStatus, shunt_id); shunts_.deactivate(shunt_id, solver_control_); }
+        void reactivate_shunt(int shunt_id) {_journal(JournalField::ShuntStatus, shunt_id); shunts_.reactivate(shunt_id, solver_control_); }
+        void change_bus_shunt(int shunt_id, int new_bus_id) {_journal(JournalField::ShuntBus, shunt_id); shunts_.change_bus(shunt_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size()));  }
+        void change_p_shunt(int shunt_id, real_type new_p) {_journal(JournalField::ShuntP, shunt_id); shunts_.change_p(shunt_id, new_p, solver_control_); }
+        void change_q_shunt(int shunt_id, real_type new_q) {_journal(JournalField::ShuntQ, shunt_id); shunts_.change_q(shunt_id, new_q, solver_control_); }
         int get_bus_shunt(int shunt_id) {return shunts_.get_bus(shunt_id);}
 
         //static gen
-        void deactivate_sgen(int sgen_id) {sgens_.deactivate(sgen_id, solver_control_); }
-        void reactivate_sgen(int sgen_id) {sgens_.reactivate(sgen_id, solver_control_); }
-        void change_bus_sgen(int sgen_id, int new_bus_id) {sgens_.change_bus(sgen_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
-        void change_p_sgen(int sgen_id, real_type new_p) {sgens_.change_p(sgen_id, new_p, solver_control_); }
-        void change_q_sgen(int sgen_id, real_type new_q) {sgens_.change_q(sgen_id, new_q, solver_control_); }
+        void deactivate_sgen(int sgen_id) {_journal(JournalField::SGenStatus, sgen_id); sgens_.deactivate(sgen_id, solver_control_); }
+        void reactivate_sgen(int sgen_id) {_journal(JournalField::SGenStatus, sgen_id); sgens_.reactivate(sgen_id, solver_control_); }
+        void change_bus_sgen(int sgen_id, int new_bus_id) {_journal(JournalField::SGenBus, sgen_id); sgens_.change_bus(sgen_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
+        void change_p_sgen(int sgen_id, real_type new_p) {_journal(JournalField::SGenP, sgen_id); sgens_.change_p(sgen_id, new_p, solver_control_); }
+        void change_q_sgen(int sgen_id, real_type new_q) {_journal(JournalField::SGenQ, sgen_id); sgens_.change_q(sgen_id, new_q, solver_control_); }
         int get_bus_sgen(int sgen_id) {return sgens_.get_bus(sgen_id);}
 
         //storage units
-        void deactivate_storage(int storage_id) {storages_.deactivate(storage_id, solver_control_); }
-        void reactivate_storage(int storage_id) {storages_.reactivate(storage_id, solver_control_); }
-        void change_bus_storage(int storage_id, int new_bus_id) {storages_.change_bus(storage_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
+        void deactivate_storage(int storage_id) {_journal(JournalField::StorageStatus, storage_id); storages_.deactivate(storage_id, solver_control_); }
+        void reactivate_storage(int storage_id) {_journal(JournalField::StorageStatus, storage_id); storages_.reactivate(storage_id, solver_control_); }
+        void change_bus_storage(int storage_id, int new_bus_id) {_journal(JournalField::StorageBus, storage_id); storages_.change_bus(storage_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
         void change_p_storage(int storage_id, real_type new_p) {
+               _journal(JournalField::StorageP, storage_id);
 //            if(new_p == 0.)
 //            {
 //                std::cout << " i deactivated storage with ID " << storage_id << std::endl;
@@ -496,17 +580,17 @@ class GridModel : public GenericContainer
 //            }
                storages_.change_p_nothrow(storage_id, new_p, solver_control_);
             }
-        void change_q_storage(int storage_id, real_type new_q) {storages_.change_q_nothrow(storage_id, new_q, solver_control_); }
+        void change_q_storage(int storage_id, real_type new_q) {_journal(JournalField::StorageQ, storage_id); storages_.change_q_nothrow(storage_id, new_q, solver_control_); }
         int get_bus_storage(int storage_id) {return storages_.get_bus(storage_id);}
 
         //deactivate a powerline (disconnect it)
-        void deactivate_dcline(int dcline_id) {dc_lines_.deactivate(dcline_id, solver_control_); }
-        void reactivate_dcline(int dcline_id) {dc_lines_.reactivate(dcline_id, solver_control_); }
-        void change_p_dcline(int dcline_id, real_type new_p) {dc_lines_.change_p(dcline_id, new_p, solver_control_); }
-        void change_v_or_dcline(int dcline_id, real_type new_v_pu) {dc_lines_.change_v_or(dcline_id, new_v_pu, solver_control_); }
-        void change_v_ex_dcline(int dcline_id, real_type new_v_pu) {dc_lines_.change_v_ex(dcline_id, new_v_pu, solver_control_); }
-        void change_bus_dcline_or(int dcline_id, int new_bus_id) {dc_lines_.change_bus_or(dcline_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
-        void change_bus_dcline_ex(int dcline_id, int new_bus_id) {dc_lines_.change_bus_ex(dcline_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
+        void deactivate_dcline(int dcline_id) {_journal(JournalField::DCLineStatus, dcline_id); dc_lines_.deactivate(dcline_id, solver_control_); }
+        void reactivate_dcline(int dcline_id) {_journal(JournalField::DCLineStatus, dcline_id); dc_lines_.reactivate(dcline_id, solver_control_); }
+        void change_p_dcline(int dcline_id, real_type new_p) {_journal(JournalField::DCLineP, dcline_id); dc_lines_.change_p(dcline_id, new_p, solver_control_); }
+        void change_v_or_dcline(int dcline_id, real_type new_v_pu) {_journal(JournalField::DCLineVOr, dcline_id); dc_lines_.change_v_or(dcline_id, new_v_pu, solver_control_); }
+        void change_v_ex_dcline(int dcline_id, real_type new_v_pu) {_journal(JournalField::DCLineVEx, dcline_id); dc_lines_.change_v_ex(dcline_id, new_v_pu, solver_control_); }
+        void change_bus_dcline_or(int dcline_id, int new_bus_id) {_journal(JournalField::DCLineBusOr, dcline_id); dc_lines_.change_bus_or(dcline_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
+        void change_bus_dcline_ex(int dcline_id, int new_bus_id) {_journal(JournalField::DCLineBusEx, dcline_id); dc_lines_.change_bus_ex(dcline_id, new_bus_id, solver_control_, static_cast<int>(bus_vn_kv_.size())); }
         int get_bus_dcline_or(int dcline_id) {return dc_lines_.get_bus_or(dcline_id);}
         int get_bus_dcline_ex(int dcline_id) {return dc_lines_.get_bus_ex(dcline_id);}
 
@@ -1047,9 +1131,15 @@ class GridModel : public GenericContainer
 
         // init the Ybus matrix (its size, it is filled up elsewhere) and also the 
         // converter from "my bus id" to the "solver bus id" (id_me_to_solver and id_solver_to_me)
+        // if the buses are reordered, the previous ordering is kept unless recompute_bus_order is true
         void init_Ybus(Eigen::SparseMatrix<cplx_type> & Ybus,
                        std::vector<int> & id_me_to_solver,
-                       std::vector<int>& id_solver_to_me);
+                       std::vector<int>& id_solver_to_me,
+                       bool recompute_bus_order);
+
+        // relabel the (connected) buses with the reverse Cuthill McKee ordering of the graph of Ybus
+        void reorder_buses_rcm(std::vector<int> & id_me_to_solver,
+                               std::vector<int>& id_solver_to_me) const;
 
         // converts the slack_bus_id from gridmodel ordering into solver ordering
         void init_slack_bus(const CplxVect & Sbus,
@@ -1198,7 +1288,30 @@ class GridModel : public GenericContainer
         using GenericContainer::fillYbus;  // to silence the overload-virtual warning in clang
     protected:
         void fillYbus(Eigen::SparseMatrix<cplx_type> & res, bool ac, const std::vector<int>& id_me_to_solver);
+        // only update the coefficients of the elements that changed (see GenericContainer::get_ybus_changed), 
+        // returns false (and res should be recomputed with fillYbus) if it cannot be done in place.
+        bool updateYbus(Eigen::SparseMatrix<cplx_type> & res, bool ac, const std::vector<int>& id_me_to_solver);
+        // all the elements that have coefficients in Ybus, in the order used to fill it
+        std::vector<GenericContainer *> ybus_containers(){
+            return {&powerlines_, &shunts_, &trafos_, &loads_, &sgens_, &storages_, &generators_, &dc_lines_};
+        }
         void fillSbus_me(CplxVect & res, bool ac, const std::vector<int>& id_me_to_solver);
+        // only add to Sbus the difference between the new and the previous contributions of the elements that changed 
+        // (see GenericContainer::get_sbus_changed), returns false (and res should be recomputed with fillSbus_me) if it cannot be done
+        bool updateSbus(CplxVect & res, bool ac, const std::vector<int>& id_me_to_solver);
+        // all the elements that have a (single) contribution to Sbus, in the order used to fill it
+        std::vector<const GenericContainer *> sbus_containers() const{
+            return {&shunts_, &loads_, &sgens_, &storages_, &generators_};
+        }
+        std::vector<int> sbus_containers_nb() const{
+            return {shunts_.nb(), loads_.nb(), sgens_.nb(), storages_.nb(), generators_.nb()};
+        }
+        // changes whenever an element of sbus_containers() or a dc line is modified (see GenericContainer::get_sbus_change_serial)
+        unsigned long sbus_change_serial() const{
+            unsigned long res = dc_lines_.get_sbus_change_serial();
+            for(auto container : sbus_containers()) res += container->get_sbus_change_serial();
+            return res;
+        }
         void fillpv_pq(const std::vector<int>& id_me_to_solver,
                        const std::vector<int>& id_solver_to_me,
                        const Eigen::VectorXi & slack_bus_id_solver,
@@ -1295,6 +1408,7 @@ class GridModel : public GenericContainer
         SolverControl solver_control_;
         bool compute_results_;
         real_type init_vm_pu_;  // default vm initialization, mainly for dc powerflow
+        bool bus_reordering_;  // whether the solver buses are renumbered to reduce the bandwidth of Ybus
         real_type sn_mva_;
 
         // powersystem representation
@@ -1353,6 +1467,96 @@ class GridModel : public GenericContainer
         // as matrix, for the solver
         Eigen::SparseMatrix<cplx_type> Ybus_ac_;
         Eigen::SparseMatrix<cplx_type> Ybus_dc_;
+
+        // what is needed to update the coefficients of Ybus in place (see updateYbus)
+        struct YbusFillCache
+        {
+            // triplets used for the last full computation of Ybus (and updated since then)
+            std::vector<Eigen::Triplet<cplx_type> > triplets;
+            // triplets of the i-th element of "ybus_containers()" are [container_end[i-1], container_end[i])
+            std::vector<std::size_t> container_end;
+            // position (in Ybus.valuePtr()) of each triplet, computed the first time it is needed
+            std::vector<int> triplet_to_nnz;
+            // triplets (in order) summed in the k-th non zero coefficient: nnz_triplets[nnz_triplets_ptr[k]:nnz_triplets_ptr[k+1]]
+            std::vector<int> nnz_triplets_ptr;
+            std::vector<int> nnz_triplets;
+            std::vector<bool> nnz_changed;
+
+            void clear(){
+                triplets.clear();
+                container_end.clear();
+                triplet_to_nnz.clear();
+                nnz_triplets_ptr.clear();
+                nnz_triplets.clear();
+                nnz_changed.clear();
+            }
+        };
+        YbusFillCache ybus_fill_cache_ac_;
+        YbusFillCache ybus_fill_cache_dc_;
+        int nb_ybus_full_fill_;
+        int nb_ybus_inplace_fill_;
+
+        // what is needed to update Sbus with only the elements that changed (see updateSbus)
+        struct SbusFillCache
+        {
+            // for each element of the i-th container of "sbus_containers()": solver id of the bus where it has been 
+            // added (or _deactivated_bus_id) and its contribution to Sbus (not divided by sn_mva) 
+            std::vector<std::vector<int> > bus_id_solver;
+            std::vector<std::vector<cplx_type> > contribution;
+            // value of sbus_change_serial() when the contributions have been last updated
+            unsigned long change_serial = 0;
+
+            void clear(){
+                bus_id_solver.clear();
+                contribution.clear();
+            }
+        };
+        SbusFillCache sbus_fill_cache_ac_;
+        SbusFillCache sbus_fill_cache_dc_;
+        int nb_sbus_full_fill_;
+        int nb_sbus_delta_fill_;
+        int nb_sbus_el_touched_;
+
+        // what is recorded (when a state is saved) before an element is modified, see save_state
+        enum class JournalField {LineStatus, LineBusOr, LineBusEx,
+                                 TrafoStatus, TrafoBusHv, TrafoBusLv,
+                                 LoadStatus, LoadBus, LoadP, LoadQ,
+                                 GenStatus, GenBus, GenP, GenV,
+                                 ShuntStatus, ShuntBus, ShuntP, ShuntQ,
+                                 SGenStatus, SGenBus, SGenP, SGenQ,
+                                 StorageStatus, StorageBus, StorageP, StorageQ,
+                                 DCLineStatus, DCLineP, DCLineVOr, DCLineVEx, DCLineBusOr, DCLineBusEx};
+        struct JournalEntry
+        {
+            JournalField field;
+            int el_id;
+            int int_value;  // previous status (0 or 1) or bus
+            real_type real_value;  // previous setpoint
+        };
+        struct SavedState
+        {
+            std::size_t journal_size;  // entries of the journal recorded before this state was saved
+            std::vector<bool> bus_status;
+            SolverControl solver_control;
+            int solver_setup_count;
+            // results of the last ac powerflow (if it converged) and the buses of the solver at that time
+            bool has_V;
+            CplxVect V;
+            RealVect Vm;
+            RealVect Va;
+            std::vector<int> id_solver_to_me;
+        };
+        void _journal(JournalField field, int el_id){
+            if(nb_saved_states_ > 0) _journal_record(field, el_id);
+        }
+        void _journal_record(JournalField field, int el_id);
+        void _journal_undo(const JournalEntry & entry);
+
+        std::vector<JournalEntry> journal_;
+        std::vector<SavedState> saved_states_;  // only the first nb_saved_states_ are used, the others are kept to be reused
+        int nb_saved_states_;
+        int solver_setup_count_;  // incremented each time the Ybus matrices or the solvers might have been modified
+
         CplxVect acSbus_;
         CplxVect dcSbus_;
         Eigen::VectorXi bus_pv_;  // id are the solver internal id and NOT the initial id
@@ -14,6 +14,8 @@ Some typedef and other structures define here and used everywhere else
 **/
 
 #include <complex>
+#include <memory>
+#include <utility>
 #include "Eigen/Core"
 
 // typedef float real_type;  // type for real numbers: can be changed if installed from source
@@ -171,4 +173,50 @@ class SolverControl
         bool ybus_change_sparsity_pattern_;  // sparsity pattern of ybus changed (and so are its coeff), or ybus change of dimension
 };
 
+/**
+Data (typically a vector) shared between the copies of an object (for example the parameters of the
+powerlines between the copies of a GridModel). Copying it is O(1): the data are only copied
+when they are modified by one of the objects sharing them (see `mut`).
+
+Read only access is the same as for the underlying data (`data(i)`, `data[i]`, `data.size()` etc.),
+modifications go through `data.mut()` or a new assignment.
+**/
+template<class T>
+class CopyOnWrite
+{
+    public:
+        CopyOnWrite(): data_(std::make_shared<T>()) {}
+        CopyOnWrite(const T & data): data_(std::make_shared<T>(data)) {}
+        CopyOnWrite & operator=(const T & data){
+            // previous data are not modified (they might be shared)
+            data_ = std::make_shared<T>(data);
+            return *this;
+        }
+
+        const T & operator*() const {return *data_;}
+        const T * operator->() const {return data_.get();}
+        operator const T &() const {return *data_;}
+
+        // read only access to the elements
+        template<class IndexType, class U=T>
+        auto operator()(IndexType i) const -> decltype(std::declval<const U &>()(i)) {return (*data_)(i);}
+        template<class IndexType, class U=T>
+        auto operator[](IndexType i) const -> decltype(std::declval<const U &>()[i]) {return (*data_)[i];}
+        template<class IndexType, class U=T>
+        auto coeff(IndexType i) const -> decltype(std::declval<const U &>().coeff(i)) {return data_->coeff(i);}
+        auto size() const -> decltype(std::declval<const T &>().size()) {return data_->size();}
+        auto begin() const -> decltype(std::declval<const T &>().begin()) {return data_->begin();}
+        auto end() const -> decltype(std::declval<const T &>().end()) {return data_->end();}
+
+        // access for modification: the data are copied first if they are shared
+        T & mut(){
+            if(data_.use_count() > 1) data_ = std::make_shared<T>(*data_);
+            return *data_;
+        }
+        bool is_shared() const {return data_.use_count() > 1;}
+
+    private:
+        std::shared_ptr<T> data_;
+};
+
 #endif // UTILS_H
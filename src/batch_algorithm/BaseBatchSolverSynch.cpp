@@ -8,6 +8,9 @@
 
 #include "BaseBatchSolverSynch.h"
 
+#include <thread>
+#include <algorithm>
+
 /**
  V is modified at each call !
 **/
@@ -32,10 +35,33 @@ bool BaseBatchSolverSynch::compute_one_powerflow(const Eigen::SparseMatrix<cplx_
     return conv;
 }
 
-void BaseBatchSolverSynch::compute_flows_from_Vs(bool amps)
+std::vector<Eigen::Index> BaseBatchSolverSynch::ybus_coeffs_pos(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                                                                const std::vector<Coeff> & coeffs) const
+{
+    // Ybus is compressed (column major): the coefficient (row, col) is stored in valuePtr() between 
+    // outerIndexPtr()[col] and outerIndexPtr()[col + 1], with the rows sorted in innerIndexPtr()
+    const auto * outer_index = Ybus.outerIndexPtr();
+    const auto * inner_index = Ybus.innerIndexPtr();
+    std::vector<Eigen::Index> res;
+    res.reserve(coeffs.size());
+    for(const auto & coeff : coeffs){
+        const auto * col_begin = inner_index + outer_index[coeff.col_id];
+        const auto * col_end = inner_index + outer_index[coeff.col_id + 1];
+        const auto * it = std::lower_bound(col_begin, col_end, coeff.row_id);
+        if((it == col_end) || (*it != coeff.row_id)){
+            // this should not happen: the element is connected, its coefficients are in Ybus
+            std::ostringstream exc_;
+            exc_ << "BaseBatchSolverSynch::ybus_coeffs_pos: coefficient (" << coeff.row_id << ", " << coeff.col_id << ") ";
+            exc_ << "is not stored in Ybus.";
+            throw std::runtime_error(exc_.str());
+        }
+        res.push_back(it - inner_index);
+    }
+    return res;
+}
+
+void BaseBatchSolverSynch::compute_flows_from_Vs(bool amps, int nb_thread)
 {
-    // TODO find a way to factorize that with TrafoContainer::compute_results
-    // TODO and LineContainer::compute_results
     if (_voltages.size() == 0)
     {
         std::ostringstream exc_;
@@ -46,23 +72,316 @@ void BaseBatchSolverSynch::compute_flows_from_Vs(bool amps)
     else _timer_compute_P = 0.;
 
     auto timer_compute = CustTimer();
-    const auto & sn_mva = _grid_model.get_sn_mva();
     const auto & nb_steps = _voltages.rows();
 
     // reset the results
-    if (amps) _amps_flows = RealMat::Zero(nb_steps, n_total_);
-    else _active_power_flows = RealMat::Zero(nb_steps, n_total_);
-    
-    // compute the flows for the powerlines
-    Eigen::Index lag_id = 0;
-    if (amps) compute_amps_flows(_grid_model.get_powerlines_as_data(), sn_mva, lag_id, false);
-    else compute_active_power_flows(_grid_model.get_powerlines_as_data(), sn_mva, lag_id, false);
-
-    // compute the flows for the trafos
-    lag_id = n_line_;
-    if (amps) compute_amps_flows(_grid_model.get_trafos_as_data(), sn_mva, lag_id, true);
-    else compute_active_power_flows(_grid_model.get_trafos_as_data(), sn_mva, lag_id, true);
+    RealMat & flows = amps ? _amps_flows : _active_power_flows;
+    flows = RealMat::Zero(nb_steps, n_total_);
+    compute_flows_from_voltages(_voltages, flows, amps, nb_thread);
 
     if (amps) _timer_compute_A = timer_compute.duration();
     else _timer_compute_P = timer_compute.duration();
 }
+
+void BaseBatchSolverSynch::compute_flows_from_voltages(const CplxMat & voltages,
+                                                       RealMat & flows,
+                                                       bool amps,
+                                                       int nb_thread) const
+{
+    // TODO find a way to factorize that with TrafoContainer::compute_results
+    // TODO and LineContainer::compute_results
+    const auto & sn_mva = _grid_model.get_sn_mva();
+    const Eigen::Index nb_steps = voltages.rows();
+
+    // parameters of the connected powerlines then trafos
+    BranchFlowData data;
+    add_branch_flow_data(_grid_model.get_powerlines_as_data(), 0, false, data);
+    add_branch_flow_data(_grid_model.get_trafos_as_data(), n_line_, true, data);
+
+    const Eigen::Index nb_worker = std::max(static_cast<Eigen::Index>(1), 
+                                            std::min(static_cast<Eigen::Index>(nb_thread), nb_steps));
+    if(nb_worker == 1){
+        BranchFlowBuffers buffers;
+        compute_branch_flows(data, amps, sn_mva, voltages, flows, 0, nb_steps, buffers);
+        return;
+    }
+
+    // each thread writes different rows of flows
+    auto run_worker = [&](Eigen::Index worker_id){
+        BranchFlowBuffers buffers;
+        compute_branch_flows(data, amps, sn_mva, voltages, flows,
+                             (nb_steps * worker_id) / nb_worker,
+                             (nb_steps * (worker_id + 1)) / nb_worker,
+                             buffers);
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(nb_worker - 1);
+    for(Eigen::Index worker_id = 1; worker_id < nb_worker; ++worker_id) threads.emplace_back(run_worker, worker_id);
+    run_worker(0);
+    for(auto & thread : threads) thread.join();
+}
+
+void BaseBatchSolverSynch::compute_branch_flows(const BranchFlowData & data,
+                                                bool amps,
+                                                real_type sn_mva,
+                                                const CplxMat & voltages,
+                                                RealMat & flows,
+                                                Eigen::Index first_step,
+                                                Eigen::Index last_step,
+                                                BranchFlowBuffers & buffers) const
+{
+    const Eigen::Index nb_el = data.bus_from.size();
+    if(nb_el == 0) return;
+    const bool is_ac = _solver.ac_solver_used();
+    const real_type sqrt_3 = sqrt(3.);
+    CplxVect & E_from = buffers.E_from;
+    CplxVect & E_to = buffers.E_to;
+    CplxVect & S_from = buffers.S_from;
+    RealVect & res = buffers.res;
+    E_from.resize(nb_el);
+    E_to.resize(nb_el);
+    S_from.resize(nb_el);
+    res.resize(nb_el);
+    for(Eigen::Index step = first_step; step < last_step; ++step){
+        // gather the voltages at both sides of each branch (one row of voltages is read for all branches)
+        const auto V_step = voltages.row(step);
+        for(Eigen::Index el = 0; el < nb_el; ++el){
+            E_from(el) = V_step(data.bus_from(el));
+            E_to(el) = V_step(data.bus_to(el));
+        }
+
+        // then all the branches are computed at once
+        if(is_ac){
+            // trafo equations (to get the power at the "from" side)
+            S_from.array() = E_from.array() * (data.y_ff.array() * E_from.array() + data.y_ft.array() * E_to.array()).conjugate();
+            if(amps) res.array() = S_from.array().abs() * sn_mva;
+            else res.array() = S_from.array().real() * sn_mva;
+        }else{
+            res.array() = data.y_ff.array().real() * E_from.array().arg() + data.y_ft.array().real() * E_to.array().arg();
+            res.array() -= data.dc_shift.array();
+            if(amps) res.array() = res.array().abs() * sn_mva;
+            else res.array() *= sn_mva;
+        }
+        if(amps) res.array() /= sqrt_3 * (E_from.array().abs() * data.vn_kv_from.array());
+
+        auto flows_step = flows.row(step);
+        for(Eigen::Index el = 0; el < nb_el; ++el) flows_step(data.col_id(el)) = res(el);
+    }
+}
+
+void BaseBatchSolverSynch::compute_results_from_Vs(bool branch_results,
+                                                   bool gen_results,
+                                                   bool shunt_results,
+                                                   bool bus_results,
+                                                   const CplxMat & Sbuses,
+                                                   const std::vector<std::vector<int> > & removed_branches,
+                                                   int nb_thread)
+{
+    if (_voltages.size() == 0)
+    {
+        std::ostringstream exc_;
+        exc_ << "BaseMultiplePowerflow::compute_results_from_Vs: cannot compute the results as the voltages are not set. Have you called compute(...) ? ";
+        throw std::runtime_error(exc_.str());
+    }
+    const Eigen::Index nb_steps = _voltages.rows();
+    if(gen_results && Sbuses.rows() != 1 && Sbuses.rows() != nb_steps){
+        std::ostringstream exc_;
+        exc_ << "BaseMultiplePowerflow::compute_results_from_Vs: Sbuses should have either 1 row or as many rows as the number of steps (";
+        exc_ << nb_steps << "), it has " << Sbuses.rows() << " rows.";
+        throw std::runtime_error(exc_.str());
+    }
+    if(!removed_branches.empty() && static_cast<Eigen::Index>(removed_branches.size()) != nb_steps){
+        std::ostringstream exc_;
+        exc_ << "BaseMultiplePowerflow::compute_results_from_Vs: removed_branches should be empty or have one element per step (";
+        exc_ << nb_steps << "), it has " << removed_branches.size() << " elements.";
+        throw std::runtime_error(exc_.str());
+    }
+    _timer_compute_results = 0.;
+    auto timer_compute = CustTimer();
+
+    const auto & sn_mva = _grid_model.get_sn_mva();
+    const bool is_ac = _solver.ac_solver_used();
+    const Eigen::Index nb_total_bus = _grid_model.total_bus();
+    const auto & bus_vn_kv = _grid_model.get_bus_vn_kv();
+    const auto & generators = _grid_model.get_generators_as_data();
+    const auto & shunts = _grid_model.get_shunts();
+    const Eigen::Index nb_gen = generators.nb();
+    const Eigen::Index nb_shunt = shunts.nb();
+    const auto & shunt_status = shunts.get_status();
+    const auto & shunt_bus_id = shunts.get_bus_id();
+    const auto & shunt_p_mw = shunts.get_p_mw();
+    const auto & shunt_q_mvar = shunts.get_q_mvar();
+    const real_type _1_sqrt_3 = 1.0 / std::sqrt(3.);
+
+    // preallocate the results
+    if(branch_results){
+        _p_or = RealMat::Zero(nb_steps, n_total_);
+        _q_or = RealMat::Zero(nb_steps, n_total_);
+        _a_or = RealMat::Zero(nb_steps, n_total_);
+        _p_ex = RealMat::Zero(nb_steps, n_total_);
+        _q_ex = RealMat::Zero(nb_steps, n_total_);
+        _a_ex = RealMat::Zero(nb_steps, n_total_);
+    }
+    if(gen_results){
+        _gen_q = RealMat::Zero(nb_steps, nb_gen);
+        _gen_p_slack = RealMat::Zero(nb_steps, nb_gen);
+    }
+    if(shunt_results) _shunt_q = RealMat::Zero(nb_steps, nb_shunt);
+    if(bus_results) _bus_v_kv = RealMat::Zero(nb_steps, nb_total_bus);
+
+    // parameters of the connected powerlines then trafos
+    BranchFlowData data;
+    if(branch_results || gen_results){
+        add_branch_flow_data(_grid_model.get_powerlines_as_data(), 0, false, data);
+        add_branch_flow_data(_grid_model.get_trafos_as_data(), n_line_, true, data);
+    }
+    const Eigen::Index nb_el = data.bus_from.size();
+    // position of each branch in data (-1 if it is disconnected)
+    Eigen::VectorXi branch_pos = Eigen::VectorXi::Constant(n_total_, -1);
+    for(Eigen::Index el = 0; el < nb_el; ++el) branch_pos(data.col_id(el)) = static_cast<int>(el);
+
+    // parameters of the generators (the mismatch at each bus is split among them as in GridModel::compute_results)
+    const auto & id_me_to_solver = is_ac ? _grid_model.id_me_to_ac_solver() : _grid_model.id_me_to_dc_solver();
+    const auto & id_solver_to_me = is_ac ? _grid_model.id_ac_solver_to_me() : _grid_model.id_dc_solver_to_me();
+    const Eigen::Index nb_bus_solver = id_solver_to_me.size();
+    RealVect bus_slack_weight;
+    RealVect total_q_min_per_bus;
+    RealVect total_q_max_per_bus;
+    Eigen::VectorXi total_gen_per_bus;
+    if(gen_results){
+        bus_slack_weight = generators.get_raw_slack_weights_solver(nb_bus_solver, id_me_to_solver);
+        total_q_min_per_bus = RealVect::Constant(nb_total_bus, 0.);
+        total_q_max_per_bus = RealVect::Constant(nb_total_bus, 0.);
+        total_gen_per_bus = Eigen::VectorXi::Constant(nb_total_bus, 0);
+        generators.init_q_vector(static_cast<int>(nb_total_bus), total_gen_per_bus, total_q_min_per_bus, total_q_max_per_bus);
+        _grid_model.get_dclines_as_data().init_q_vector(static_cast<int>(nb_total_bus), total_gen_per_bus, total_q_min_per_bus, total_q_max_per_bus);
+    }
+
+    // computes the steps [first_step, last_step), each thread writes different rows of the results
+    auto compute_steps = [&](Eigen::Index first_step, Eigen::Index last_step){
+        CplxVect E_from(nb_el);
+        CplxVect E_to(nb_el);
+        CplxVect S_from(nb_el);
+        CplxVect S_to(nb_el);
+        RealVect p_from(nb_el), q_from(nb_el), v_from(nb_el);
+        RealVect p_to(nb_el), q_to(nb_el), v_to(nb_el);
+        CplxVect S_bus;
+        RealVect active_mismatch;
+        RealVect reactive_mismatch;
+        if(gen_results){
+            S_bus = CplxVect(nb_total_bus);
+            active_mismatch = RealVect(nb_bus_solver);
+            reactive_mismatch = RealVect(nb_bus_solver);
+        }
+        for(Eigen::Index step = first_step; step < last_step; ++step){
+            const auto V_step = _voltages.row(step);
+            if((V_step.array() == 0.).all()) continue;  // this step has not converged
+
+            if(branch_results || gen_results){
+                // power flowing in the branches (in pu)
+                for(Eigen::Index el = 0; el < nb_el; ++el){
+                    E_from(el) = V_step(data.bus_from(el));
+                    E_to(el) = V_step(data.bus_to(el));
+                }
+                if(is_ac){
+                    S_from.array() = E_from.array() * (data.y_ff.array() * E_from.array() + data.y_ft.array() * E_to.array()).conjugate();
+                    S_to.array() = E_to.array() * (data.y_tt.array() * E_to.array() + data.y_tf.array() * E_from.array()).conjugate();
+                }else{
+                    S_from.real().array() = data.y_ff.array().real() * E_from.array().arg() + data.y_ft.array().real() * E_to.array().arg() - data.dc_shift.array();
+                    S_to.real().array() = data.y_tt.array().real() * E_to.array().arg() + data.y_tf.array().real() * E_from.array().arg() + data.dc_shift.array();
+                    S_from.imag().setZero();
+                    S_to.imag().setZero();
+                }
+                if(!removed_branches.empty()){
+                    for(auto col_id : removed_branches[step]){
+                        const int el = branch_pos(col_id);
+                        if(el < 0) continue;
+                        S_from(el) = 0.;
+                        S_to(el) = 0.;
+                    }
+                }
+            }
+
+            if(branch_results){
+                p_from.array() = S_from.array().real() * sn_mva;
+                q_from.array() = S_from.array().imag() * sn_mva;
+                p_to.array() = S_to.array().real() * sn_mva;
+                q_to.array() = S_to.array().imag() * sn_mva;
+                // voltages in kV (1. instead of 0. not to divide by 0.)
+                v_from.array() = E_from.array().abs() * data.vn_kv_from.array();
+                v_to.array() = E_to.array().abs() * data.vn_kv_to.array();
+                v_from = (v_from.array() == 0.).select(1., v_from);
+                v_to = (v_to.array() == 0.).select(1., v_to);
+
+                auto p_or = _p_or.row(step);
+                auto q_or = _q_or.row(step);
+                auto a_or = _a_or.row(step);
+                auto p_ex = _p_ex.row(step);
+                auto q_ex = _q_ex.row(step);
+                auto a_ex = _a_ex.row(step);
+                for(Eigen::Index el = 0; el < nb_el; ++el){
+                    const auto col_id = data.col_id(el);
+                    p_or(col_id) = p_from(el);
+                    q_or(col_id) = q_from(el);
+                    a_or(col_id) = std::sqrt(p_from(el) * p_from(el) + q_from(el) * q_from(el)) * _1_sqrt_3 / v_from(el);
+                    p_ex(col_id) = p_to(el);
+                    q_ex(col_id) = q_to(el);
+                    a_ex(col_id) = std::sqrt(p_to(el) * p_to(el) + q_to(el) * q_to(el)) * _1_sqrt_3 / v_to(el);
+                }
+            }
+
+            if(gen_results){
+                // power injected at each bus (in pu), from the branches and the shunts (in AC only)
+                S_bus.setZero();
+                for(Eigen::Index el = 0; el < nb_el; ++el){
+                    S_bus(data.bus_from(el)) += S_from(el);
+                    S_bus(data.bus_to(el)) += S_to(el);
+                }
+                if(is_ac){
+                    for(Eigen::Index shunt_id = 0; shunt_id < nb_shunt; ++shunt_id){
+                        if(!shunt_status[shunt_id]) continue;
+                        const auto bus_id = shunt_bus_id(shunt_id);
+                        S_bus(bus_id) += std::norm(V_step(bus_id)) * cplx_type(shunt_p_mw(shunt_id), shunt_q_mvar(shunt_id)) / sn_mva;
+                    }
+                }
+
+                // the difference with the known injections is provided by the generators
+                const auto Sbus_step = Sbuses.row(Sbuses.rows() == 1 ? 0 : step);
+                for(Eigen::Index bus_solver = 0; bus_solver < nb_bus_solver; ++bus_solver){
+                    const cplx_type mismatch = S_bus(id_solver_to_me[bus_solver]) - Sbus_step(bus_solver);
+                    active_mismatch(bus_solver) = std::real(mismatch) * sn_mva;
+                    reactive_mismatch(bus_solver) = std::imag(mismatch) * sn_mva;
+                }
+                generators.add_p_slack(active_mismatch, id_me_to_solver, bus_slack_weight, _gen_p_slack.row(step).transpose());
+                generators.compute_q(reactive_mismatch, id_me_to_solver, is_ac,
+                                     total_gen_per_bus, total_q_min_per_bus, total_q_max_per_bus, 
+                                     _gen_q.row(step).transpose());
+            }
+
+            if(shunt_results && is_ac){
+                auto shunt_q = _shunt_q.row(step);
+                for(Eigen::Index shunt_id = 0; shunt_id < nb_shunt; ++shunt_id){
+                    if(!shunt_status[shunt_id]) continue;
+                    shunt_q(shunt_id) = std::norm(V_step(shunt_bus_id(shunt_id))) * shunt_q_mvar(shunt_id);
+                }
+            }
+
+            if(bus_results) _bus_v_kv.row(step).array() = V_step.array().abs() * bus_vn_kv.transpose().array();
+        }
+    };
+
+    const Eigen::Index nb_worker = std::max(static_cast<Eigen::Index>(1), 
+                                            std::min(static_cast<Eigen::Index>(nb_thread), nb_steps));
+    if(nb_worker == 1){
+        compute_steps(0, nb_steps);
+    }else{
+        std::vector<std::thread> threads;
+        threads.reserve(nb_worker - 1);
+        for(Eigen::Index worker_id = 1; worker_id < nb_worker; ++worker_id){
+            threads.emplace_back(compute_steps, (nb_steps * worker_id) / nb_worker, (nb_steps * (worker_id + 1)) / nb_worker);
+        }
+        compute_steps(0, nb_steps / nb_worker);
+        for(auto & thread : threads) thread.join();
+    }
+    _timer_compute_results = timer_compute.duration();
+}
@@ -32,19 +32,24 @@ class BaseBatchSolverSynch
             _voltages(),
             _amps_flows(),
             _active_power_flows(),
+            _p_or(),
+            _q_or(),
+            _a_or(),
+            _p_ex(),
+            _q_ex(),
+            _a_ex(),
+            _gen_q(),
+            _gen_p_slack(),
+            _shunt_q(),
+            _bus_v_kv(),
             _nb_solved(0),
             _timer_compute_A(0.),
             _timer_compute_P(0.),
+            _timer_compute_results(0.),
             _timer_solver(0.)
             {
                 // make sure that my "grid_model" is ready to be used (for ac and dc)
-                Eigen::Index nb_bus = init_grid_model.total_bus();
-                CplxVect V = CplxVect::Constant(nb_bus, 1.04);
-                // const auto & Vtmp = init_grid_model.get_V_solver();
-                // for(int i = 0; i < Vtmp.size(); ++i) V[i] = Vtmp[i];
-                _grid_model.tell_solver_need_reset();
-                _grid_model.dc_pf(V, 10, 1e-5);
-                _grid_model.ac_pf(V, 10, 1e-5);
+                prepare_grid_model();
                 
                 // assign the right solver type
                 _solver_control.tell_none_changed();
@@ -60,6 +65,12 @@ class BaseBatchSolverSynch
             _solver.change_solver(type);
             clear();
         }
+        // jacobian reuse of the Newton Raphson based solvers (see BaseNRAlgo::set_jacobian_reuse)
+        void set_jacobian_reuse(int refactor_every, real_type refactor_ratio){
+            _solver.set_jacobian_reuse(refactor_every, refactor_ratio);
+        }
+        int get_refactor_every() const {return _solver.get_refactor_every();}
+        real_type get_refactor_ratio() const {return _solver.get_refactor_ratio();}
         std::vector<SolverType> available_solvers() const {return _solver.available_solvers(); }
         SolverType get_solver_type() const {return _solver.get_type(); }
 
@@ -75,16 +86,32 @@ class BaseBatchSolverSynch
 
         // utlities informations
         double amps_computation_time() const {return _timer_compute_A;}
+        double results_computation_time() const {return _timer_compute_results;}
         double solver_time() const {return _timer_solver;}
         int nb_solved() const {return _nb_solved;}
         virtual void clear() {
             _solver.reset();
+            clear_results();
+        }
+        // clear the results but keep the solver (and its factorization) as is
+        void clear_results() {
             _amps_flows = RealMat();
             _active_power_flows = RealMat();
+            _p_or = RealMat();
+            _q_or = RealMat();
+            _a_or = RealMat();
+            _p_ex = RealMat();
+            _q_ex = RealMat();
+            _a_ex = RealMat();
+            _gen_q = RealMat();
+            _gen_p_slack = RealMat();
+            _shunt_q = RealMat();
+            _bus_v_kv = RealMat();
             _voltages = CplxMat();
             _nb_solved = 0;
             _timer_compute_A = 0.;
             _timer_compute_P = 0.;
+            _timer_compute_results = 0.;
             _timer_solver = 0.;
         }
 
@@ -94,68 +121,133 @@ class BaseBatchSolverSynch
         const RealMat & get_flows() const {return _amps_flows;}
         const RealMat & get_power_flows() const {return _active_power_flows;}
         const CplxMat & get_voltages() const {return _voltages;}
+
+        // results of compute_results_from_Vs (one row per step, empty if not computed)
+        // branches: all powerlines then all trafos (MW, MVAr and kA)
+        const RealMat & get_p_or() const {return _p_or;}
+        const RealMat & get_q_or() const {return _q_or;}
+        const RealMat & get_a_or() const {return _a_or;}
+        const RealMat & get_p_ex() const {return _p_ex;}
+        const RealMat & get_q_ex() const {return _q_ex;}
+        const RealMat & get_a_ex() const {return _a_ex;}
+        // generators: reactive power (MVAr) and active power absorbed by the slack (MW, 0. for the non slack generators)
+        const RealMat & get_gen_q() const {return _gen_q;}
+        const RealMat & get_gen_p_slack() const {return _gen_p_slack;}
+        // shunts: reactive power (MVAr)
+        const RealMat & get_shunt_q() const {return _shunt_q;}
+        // buses: voltage magnitude (kV)
+        const RealMat & get_bus_v_kv() const {return _bus_v_kv;}
         
     protected:
+        // computes the Ybus (ac and dc), the bus labelling of the solvers and the pv / pq / slack buses
+        // of _grid_model, to be called each time its topology is modified
+        void prepare_grid_model(){
+            CplxVect V = CplxVect::Constant(_grid_model.total_bus(), 1.04);
+            // const auto & Vtmp = init_grid_model.get_V_solver();
+            // for(int i = 0; i < Vtmp.size(); ++i) V[i] = Vtmp[i];
+            _grid_model.tell_solver_need_reset();
+            _grid_model.dc_pf(V, 10, 1e-5);
+            _grid_model.ac_pf(V, 10, 1e-5);
+        }
+
+        // coefficients of Ybus (solver labelling) of the connected branches in branch_ids
+        // (powerlines then trafos), 4 per branch
         template<class T>
-        void compute_amps_flows(const T & structure_data,
-                                real_type sn_mva,
-                                Eigen::Index lag_id,
-                                bool is_trafo) 
+        std::vector<Coeff> branch_ybus_coeffs(const T & branch_ids, bool ac_solver_used) const
         {
-            const auto & bus_vn_kv = _grid_model.get_bus_vn_kv();
-            const auto & el_status = structure_data.get_status();
-            const auto & bus_from = structure_data.get_bus_from();
-            const auto & bus_to = structure_data.get_bus_to();
-            bool is_ac = _solver.ac_solver_used();
+            const auto & powerlines = _grid_model.get_powerlines_as_data();
+            const auto & trafos = _grid_model.get_trafos_as_data();
+            const auto & id_me_to_solver = ac_solver_used ? _grid_model.id_me_to_ac_solver(): _grid_model.id_me_to_dc_solver();
+            Eigen::Index bus_1_id, bus_2_id;
+            cplx_type y_ff, y_ft, y_tf, y_tt;
+            bool status;
+            std::vector<Coeff> res;
+            res.reserve(branch_ids.size() * 4);  // usually there are 4 coeffs per powerlines / trafos
+            for(auto line_id : branch_ids){
+                if(line_id < n_line_)
+                {
+                    // this is a powerline
+                    bus_1_id = id_me_to_solver[powerlines.get_bus_from()[line_id]];
+                    bus_2_id = id_me_to_solver[powerlines.get_bus_to()[line_id]];
+                    status = powerlines.get_status()[line_id];
+                    if(ac_solver_used){
+                        y_ff = powerlines.yac_ff()[line_id];
+                        y_ft = powerlines.yac_ft()[line_id];
+                        y_tf = powerlines.yac_tf()[line_id];
+                        y_tt = powerlines.yac_tt()[line_id];
+                    }else{
+                        y_ff = powerlines.ydc_ff()[line_id];
+                        y_ft = powerlines.ydc_ft()[line_id];
+                        y_tf = powerlines.ydc_tf()[line_id];
+                        y_tt = powerlines.ydc_tt()[line_id];
+                    }
+                }else{
+                    // this is a trafo
+                    const auto trafo_id = line_id - n_line_;
+                    status = trafos.get_status()[trafo_id];
+                    bus_1_id = id_me_to_solver[trafos.get_bus_from()[trafo_id]];
+                    bus_2_id = id_me_to_solver[trafos.get_bus_to()[trafo_id]];
+                    if(ac_solver_used){
+                        y_ff = trafos.yac_ff()[trafo_id];
+                        y_ft = trafos.yac_ft()[trafo_id];
+                        y_tf = trafos.yac_tf()[trafo_id];
+                        y_tt = trafos.yac_tt()[trafo_id];
+                    }else{
+                        y_ff = trafos.ydc_ff()[trafo_id];
+                        y_ft = trafos.ydc_ft()[trafo_id];
+                        y_tf = trafos.ydc_tf()[trafo_id];
+                        y_tt = trafos.ydc_tt()[trafo_id];
+                    }
+                }
 
-            const auto & vect_y_ff = is_ac ? structure_data.yac_ff() : structure_data.ydc_ff();
-            const auto & vect_y_ft = is_ac ? structure_data.yac_ft() : structure_data.ydc_ft();
-            Eigen::Ref<const RealVect> dc_x_tau_shift = structure_data.dc_x_tau_shift(); // not used in AC nor if it's powerline anyway
+                if(status && bus_1_id != GenericContainer::_deactivated_bus_id && bus_2_id != GenericContainer::_deactivated_bus_id)
+                {
+                    // element is connected
+                    res.push_back({bus_1_id, bus_1_id, y_ff});
+                    res.push_back({bus_1_id, bus_2_id, y_ft});
+                    res.push_back({bus_2_id, bus_1_id, y_tf});
+                    res.push_back({bus_2_id, bus_2_id, y_tt});
+                }
+            }
+            return res;
+        }
 
-            Eigen::Index nb_el = structure_data.nb();
-            real_type sqrt_3 = sqrt(3.);
+        // position (in Ybus.valuePtr()) of each coefficient, Ybus must be compressed
+        // (throws if a coefficient is not stored in Ybus)
+        std::vector<Eigen::Index> ybus_coeffs_pos(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                                                  const std::vector<Coeff> & coeffs) const;
 
+        // parameters of the connected branches needed to compute the flows, stored contiguously
+        // (powerlines and trafos are stored in the same structure)
+        struct BranchFlowData
+        {
+            Eigen::VectorXi bus_from;  // grid model labelling
+            Eigen::VectorXi bus_to;
+            Eigen::VectorXi col_id;  // column of the results
+            CplxVect y_ff;
+            CplxVect y_ft;
+            CplxVect y_tt;
+            CplxVect y_tf;
+            RealVect vn_kv_from;
+            RealVect vn_kv_to;
+            RealVect dc_shift;  // only used in DC (0. for powerlines)
+        };
+
+        // buffers of compute_branch_flows (nothing is allocated for each step)
+        struct BranchFlowBuffers
+        {
+            CplxVect E_from;
+            CplxVect E_to;
+            CplxVect S_from;
             RealVect res;
-            for(Eigen::Index el_id = 0; el_id < nb_el; ++el_id){
-                if(!el_status[el_id]) continue;
-
-                // retrieve which buses are used
-                int bus_from_me = bus_from(el_id);
-                int bus_to_me = bus_to(el_id);
+        };
 
-                // retrieve voltages
-                const auto Efrom = _voltages.col(bus_from_me);  // vector (one voltages per step)
-                const auto Eto = _voltages.col(bus_to_me);
-
-                const real_type bus_vn_kv_f = bus_vn_kv(bus_from_me);
-                const RealVect v_f_kv = Efrom.array().abs() * bus_vn_kv_f;
-
-                // retrieve physical parameters
-                const cplx_type y_ff = vect_y_ff(el_id);  // scalar
-                const cplx_type y_ft = vect_y_ft(el_id);
-
-                if(is_ac){
-                    // trafo equations (to get the power at the "from" side)
-                    CplxVect I_ft =  y_ff * Efrom + y_ft * Eto;
-                    I_ft = I_ft.array().conjugate();
-                    const CplxVect S_ft = Efrom.array() * I_ft.array();
-
-                    // now compute the current flow
-                    res = S_ft.array().abs() * sn_mva;
-                }else{
-                    res = (std::real(y_ff) * Efrom.array().arg() + std::real(y_ft) * Eto.array().arg()) * sn_mva;
-                    if(is_trafo) res.array() -= dc_x_tau_shift(el_id);
-                    res.array() = res.array().abs();
-                }
-                res.array() /= sqrt_3 * v_f_kv.array();
-                _amps_flows.col(el_id + lag_id) = res;
-            }
-        }
+        // add the connected elements of structure_data at the end of data
         template<class T>
-        void compute_active_power_flows(const T & structure_data,
-                                        real_type sn_mva,
-                                        Eigen::Index lag_id,
-                                        bool is_trafo) 
+        void add_branch_flow_data(const T & structure_data,
+                                  Eigen::Index lag_id,
+                                  bool is_trafo,
+                                  BranchFlowData & data) const
         {
             const auto & bus_vn_kv = _grid_model.get_bus_vn_kv();
             const auto & el_status = structure_data.get_status();
@@ -165,45 +257,60 @@ class BaseBatchSolverSynch
 
             Eigen::Ref<const CplxVect> vect_y_ff = is_ac ? structure_data.yac_ff() : structure_data.ydc_ff();
             Eigen::Ref<const CplxVect> vect_y_ft = is_ac ? structure_data.yac_ft() : structure_data.ydc_ft();
+            Eigen::Ref<const CplxVect> vect_y_tt = is_ac ? structure_data.yac_tt() : structure_data.ydc_tt();
+            Eigen::Ref<const CplxVect> vect_y_tf = is_ac ? structure_data.yac_tf() : structure_data.ydc_tf();
             Eigen::Ref<const RealVect> dc_x_tau_shift = structure_data.dc_x_tau_shift(); // not used in AC nor if it's powerline anyway
 
-            Eigen::Index nb_el = structure_data.nb();
-
-            RealVect res;
+            const Eigen::Index nb_el = structure_data.nb();
+            Eigen::Index pos = data.bus_from.size();
+            Eigen::Index nb_connected = 0;
+            for(Eigen::Index el_id = 0; el_id < nb_el; ++el_id) if(el_status[el_id]) ++nb_connected;
+            const Eigen::Index new_size = pos + nb_connected;
+            data.bus_from.conservativeResize(new_size);
+            data.bus_to.conservativeResize(new_size);
+            data.col_id.conservativeResize(new_size);
+            data.y_ff.conservativeResize(new_size);
+            data.y_ft.conservativeResize(new_size);
+            data.y_tt.conservativeResize(new_size);
+            data.y_tf.conservativeResize(new_size);
+            data.vn_kv_from.conservativeResize(new_size);
+            data.vn_kv_to.conservativeResize(new_size);
+            data.dc_shift.conservativeResize(new_size);
             for(Eigen::Index el_id = 0; el_id < nb_el; ++el_id){
                 if(!el_status[el_id]) continue;
-
-                // retrieve which buses are used
-                int bus_from_me = bus_from(el_id);
-                int bus_to_me = bus_to(el_id);
-
-                // retrieve voltages
-                const auto Efrom = _voltages.col(bus_from_me);  // vector (one voltages per step)
-                const auto Eto = _voltages.col(bus_to_me);
-
-                const real_type bus_vn_kv_f = bus_vn_kv(bus_from_me);
-                const RealVect v_f_kv = Efrom.array().abs() * bus_vn_kv_f;
-
-                // retrieve physical parameters
-                const cplx_type y_ff = vect_y_ff(el_id);  // scalar
-                const cplx_type y_ft = vect_y_ft(el_id);
-
-                // trafo equations (to get the power at the "from" side)
-                if(is_ac){
-                    CplxVect I_ft = y_ff * Efrom + y_ft * Eto;
-                    I_ft = I_ft.array().conjugate();
-                    const CplxVect S_ft = Efrom.array() * I_ft.array();
-
-                    // now compute the active flow
-                    res = S_ft.array().real() * sn_mva;
-                }else{
-                    res = (std::real(y_ff) * Efrom.array().arg() + std::real(y_ft) * Eto.array().arg()) * sn_mva;
-                    if(is_trafo) res.array() -= dc_x_tau_shift(el_id);
-                }
-                _active_power_flows.col(el_id + lag_id) = res;
+                data.bus_from(pos) = bus_from(el_id);
+                data.bus_to(pos) = bus_to(el_id);
+                data.col_id(pos) = static_cast<int>(el_id + lag_id);
+                data.y_ff(pos) = vect_y_ff(el_id);
+                data.y_ft(pos) = vect_y_ft(el_id);
+                data.y_tt(pos) = vect_y_tt(el_id);
+                data.y_tf(pos) = vect_y_tf(el_id);
+                data.vn_kv_from(pos) = bus_vn_kv(bus_from(el_id));
+                data.vn_kv_to(pos) = bus_vn_kv(bus_to(el_id));
+                data.dc_shift(pos) = is_trafo ? dc_x_tau_shift(el_id) : 0.;
+                ++pos;
             }
         }
 
+        // flows at the "from" side of the branches in data (current in kA if amps is true, 
+        // active power in MW otherwise) for the steps [first_step, last_step)
+        void compute_branch_flows(const BranchFlowData & data,
+                                  bool amps,
+                                  real_type sn_mva,
+                                  const CplxMat & voltages,
+                                  RealMat & flows,
+                                  Eigen::Index first_step,
+                                  Eigen::Index last_step,
+                                  BranchFlowBuffers & buffers) const;
+
+        // flows at the "from" side of all powerlines then all trafos (see compute_branch_flows), for each row of
+        // voltages, flows should be of size (voltages.rows(), n_total_)
+        // the steps are split in nb_thread contiguous tiles, each computed in its own thread
+        void compute_flows_from_voltages(const CplxMat & voltages,
+                                         RealMat & flows,
+                                         bool amps,
+                                         int nb_thread) const;
+
         bool compute_one_powerflow(const Eigen::SparseMatrix<cplx_type> & Ybus,
                                    CplxVect & V,
                                    const CplxVect & Sbus,
@@ -215,7 +322,20 @@ class BaseBatchSolverSynch
                                    double tol
                                    );
 
-        void compute_flows_from_Vs(bool amps=true);
+        void compute_flows_from_Vs(bool amps=true, int nb_thread=1);
+
+        // computes, for each row of _voltages, the families of results requested (see get_p_or, get_gen_q, 
+        // get_shunt_q and get_bus_v_kv). Sbuses are the power injected at each bus of the solver used to 
+        // compute _voltages (one row per step, or a single row for all the steps), they are only used for the 
+        // generators. If not empty, removed_branches lists (for each step) the branches disconnected at this step.
+        // The steps that did not converge (all voltages are 0.) are left to 0.
+        void compute_results_from_Vs(bool branch_results,
+                                     bool gen_results,
+                                     bool shunt_results,
+                                     bool bus_results,
+                                     const CplxMat & Sbuses,
+                                     const std::vector<std::vector<int> > & removed_branches,
+                                     int nb_thread);
 
         CplxVect extract_Vsolver_from_Vinit(const CplxVect& Vinit,
                                             Eigen::Index nb_buses_solver,
@@ -247,11 +367,22 @@ class BaseBatchSolverSynch
         CplxMat _voltages;
         RealMat _amps_flows;
         RealMat _active_power_flows;
+        RealMat _p_or;
+        RealMat _q_or;
+        RealMat _a_or;
+        RealMat _p_ex;
+        RealMat _q_ex;
+        RealMat _a_ex;
+        RealMat _gen_q;
+        RealMat _gen_p_slack;
+        RealMat _shunt_q;
+        RealMat _bus_v_kv;
         
         // timers
         int _nb_solved;
         double _timer_compute_A;
         double _timer_compute_P;
+        double _timer_compute_results;
         double _timer_solver;
 
         // solver control
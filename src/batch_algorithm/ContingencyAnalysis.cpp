@@ -8,136 +8,357 @@
 
 #include "ContingencyAnalysis.h"
 
-#include <queue>
+#include <memory>
+#include <random>
+#include <functional>
+#include <exception>
+#include <limits>
+#include <algorithm>
 #include <math.h>       /* isfinite */
 
-bool ContingencyAnalysis::check_invertible(const Eigen::SparseMatrix<cplx_type> & Ybus) const{
-    std::vector<bool> visited(Ybus.cols(), false); 
-    std::vector<bool> already_added(Ybus.cols(), false);
-    std::queue<Eigen::Index> neighborhood;
-    Eigen::Index col_id = 0;  // start by node 0, why not
-    while (true)
-    {
-        visited[col_id] = true;
-        for (Eigen::SparseMatrix<cplx_type>::InnerIterator it(Ybus, col_id); it; ++it)
-        {
-            // add in the queue all my neighbor (if the coefficient is big enough)
-            if(!visited[it.row()] && !already_added[it.row()] && abs(it.value()) > 1e-8){
-                neighborhood.push(it.row());
-                already_added[it.row()] = true;
-            }
+void ContingencyAggregate::init(Eigen::Index nb_bus, Eigen::Index nb_branch){
+    max_flows = RealVect::Zero(nb_branch);
+    max_flows_cont = IntVect::Constant(nb_branch, -1);
+    nb_violations = IntVect::Zero(nb_branch);
+    min_vm = RealVect::Constant(nb_bus, std::numeric_limits<real_type>::infinity());
+    max_vm = RealVect::Constant(nb_bus, -std::numeric_limits<real_type>::infinity());
+}
+
+void ContingencyAggregate::update(Eigen::Index cont_id,
+                                  Eigen::Ref<const CplxVect> V,
+                                  Eigen::Ref<const RealVect> amps_flows,
+                                  const RealVect & violation_flows)
+{
+    const Eigen::Index nb_branch = amps_flows.size();
+    for(Eigen::Index br_id = 0; br_id < nb_branch; ++br_id){
+        const real_type flow = amps_flows(br_id);
+        if(!isfinite(flow)) continue;
+        if(flow > max_flows(br_id)){
+            max_flows(br_id) = flow;
+            max_flows_cont(br_id) = static_cast<int>(cont_id);
         }
-        if(neighborhood.empty()) break;
-        col_id = neighborhood.front();
-        neighborhood.pop();
+        if(flow > violation_flows(br_id)) ++nb_violations(br_id);
     }
-    
-    bool ok = true;
-    for(auto el: visited){
-        if(!el)
-        {
-            // this node has not been visited, there is an error
-            ok=false;
-            break;
+    const Eigen::Index nb_bus = V.size();
+    for(Eigen::Index bus_id = 0; bus_id < nb_bus; ++bus_id){
+        const real_type vm = std::abs(V(bus_id));
+        if(vm == 0.) continue;  // bus not used
+        min_vm(bus_id) = std::min(min_vm(bus_id), vm);
+        max_vm(bus_id) = std::max(max_vm(bus_id), vm);
+    }
+}
+
+void ContingencyAggregate::merge(const ContingencyAggregate & other){
+    const Eigen::Index nb_branch = max_flows.size();
+    for(Eigen::Index br_id = 0; br_id < nb_branch; ++br_id){
+        const int other_cont = other.max_flows_cont(br_id);
+        if(other_cont == -1) continue;
+        const bool is_higher = other.max_flows(br_id) > max_flows(br_id);
+        const bool same_lower_id = (other.max_flows(br_id) == max_flows(br_id)) && ((max_flows_cont(br_id) == -1) || (other_cont < max_flows_cont(br_id)));
+        if(is_higher || same_lower_id){
+            max_flows(br_id) = other.max_flows(br_id);
+            max_flows_cont(br_id) = other_cont;
         }
     }
-    return ok;
+    nb_violations += other.nb_violations;
+    min_vm = min_vm.cwiseMin(other.min_vm);
+    max_vm = max_vm.cwiseMax(other.max_vm);
 }
 
-void ContingencyAnalysis::init_li_coeffs(bool ac_solver_used){
-    _li_coeffs.clear();
-    _li_coeffs.reserve(_li_defaults.size());
+void ContingencyAnalysis::set_aggregation(const RealVect & thermal_limits, real_type loading_threshold){
+    if(thermal_limits.size() != n_total_){
+        std::ostringstream exc_;
+        exc_ << "SecurityAnalysis::set_aggregation: thermal_limits should have the same size as the total number of ";
+        exc_ << "powerlines / trafos (" << n_total_ << "), but it has " << thermal_limits.size() << " elements.";
+        throw std::runtime_error(exc_.str());
+    }
+    _aggregate = true;
+    _aggr_thermal_limits = thermal_limits;
+    _aggr_loading_threshold = loading_threshold;
+    _aggr_res = ContingencyAggregate();
+}
+
+void ContingencyAnalysis::init_connectivity(bool ac_solver_used){
     const auto & powerlines = _grid_model.get_powerlines_as_data();
     const auto & trafos = _grid_model.get_trafos_as_data();
     const auto & id_me_to_solver = ac_solver_used ? _grid_model.id_me_to_ac_solver(): _grid_model.id_me_to_dc_solver();
-    Eigen::Index bus_1_id, bus_2_id;
-    cplx_type y_ff, y_ft, y_tf, y_tt;
-    bool status;
-    for(const auto & this_cont_id: _li_defaults){
-        std::vector<Coeff> this_cont_coeffs;
-        this_cont_coeffs.reserve(this_cont_id.size() * 4);  // usually there are 4 coeffs per powerlines / trafos
-        for(auto line_id : this_cont_id){
-            if(line_id < n_line_)
-            {
-                // this is a powerline
-                bus_1_id = id_me_to_solver[powerlines.get_bus_from()[line_id]];
-                bus_2_id = id_me_to_solver[powerlines.get_bus_to()[line_id]];
-                status = powerlines.get_status()[line_id];
-                if(ac_solver_used){
-                    y_ff = powerlines.yac_ff()[line_id];
-                    y_ft = powerlines.yac_ft()[line_id];
-                    y_tf = powerlines.yac_tf()[line_id];
-                    y_tt = powerlines.yac_tt()[line_id];
-                }else{
-                    y_ff = powerlines.ydc_ff()[line_id];
-                    y_ft = powerlines.ydc_ft()[line_id];
-                    y_tf = powerlines.ydc_tf()[line_id];
-                    y_tt = powerlines.ydc_tt()[line_id];
+
+    // the graph: buses of the solver and connected powerlines / trafos (parallel branches are kept)
+    _nb_bus_graph = 0;
+    for(auto bus_solver_id : id_me_to_solver){
+        if(bus_solver_id != GenericContainer::_deactivated_bus_id) ++_nb_bus_graph;
+    }
+    _branch_from.assign(n_total_, -1);
+    _branch_to.assign(n_total_, -1);
+    for(Eigen::Index line_id = 0; line_id < n_line_; ++line_id){
+        if(!powerlines.get_status()[line_id]) continue;
+        _branch_from[line_id] = id_me_to_solver[powerlines.get_bus_from()[line_id]];
+        _branch_to[line_id] = id_me_to_solver[powerlines.get_bus_to()[line_id]];
+    }
+    for(Eigen::Index trafo_id = 0; trafo_id < n_trafos_; ++trafo_id){
+        if(!trafos.get_status()[trafo_id]) continue;
+        _branch_from[trafo_id + n_line_] = id_me_to_solver[trafos.get_bus_from()[trafo_id]];
+        _branch_to[trafo_id + n_line_] = id_me_to_solver[trafos.get_bus_to()[trafo_id]];
+    }
+    std::vector<int> adj_start(_nb_bus_graph + 1, 0);
+    for(Eigen::Index br_id = 0; br_id < n_total_; ++br_id){
+        if(!is_branch_in_graph(br_id)) continue;
+        ++adj_start[_branch_from[br_id] + 1];
+        ++adj_start[_branch_to[br_id] + 1];
+    }
+    for(Eigen::Index bus_id = 0; bus_id < _nb_bus_graph; ++bus_id) adj_start[bus_id + 1] += adj_start[bus_id];
+    std::vector<int> adj_branch(adj_start[_nb_bus_graph]);
+    std::vector<int> adj_pos(adj_start.begin(), adj_start.end() - 1);
+    for(Eigen::Index br_id = 0; br_id < n_total_; ++br_id){
+        if(!is_branch_in_graph(br_id)) continue;
+        adj_branch[adj_pos[_branch_from[br_id]]++] = static_cast<int>(br_id);
+        adj_branch[adj_pos[_branch_to[br_id]]++] = static_cast<int>(br_id);
+    }
+
+    // iterative depth first search (Tarjan): a tree branch (parent(v), v) is a bridge iff low[v] > tin[parent(v)].
+    // Each non tree branch also receives a random label and each tree branch the "xor" of the labels of the 
+    // non tree branches covering it: a set of branches disconnects the grid iff (with high probability) a
+    // non empty subset of their labels "xor" to 0 (bridges are labelled 0).
+    _is_bridge.assign(n_total_, false);
+    _cut_labels.assign(n_total_, 0);
+    _base_connected = true;
+    if(_nb_bus_graph == 0) return;
+    std::mt19937_64 gen(0);  // fixed seed: results are reproducible
+    std::vector<int> tin(_nb_bus_graph, -1);
+    std::vector<int> low(_nb_bus_graph, -1);
+    std::vector<int> parent_branch(_nb_bus_graph, -1);
+    std::vector<int> next_adj(adj_start.begin(), adj_start.end() - 1);
+    std::vector<std::uint64_t> acc_labels(_nb_bus_graph, 0);
+    std::vector<int> stack;
+    stack.reserve(_nb_bus_graph);
+    int timer = 0;
+    for(int root = 0; root < _nb_bus_graph; ++root){
+        if(tin[root] != -1) continue;
+        if(root > 0) _base_connected = false;  // more than one connected component in the base case
+        tin[root] = low[root] = timer++;
+        stack.push_back(root);
+        while(!stack.empty()){
+            const int bus_id = stack.back();
+            if(next_adj[bus_id] < adj_start[bus_id + 1]){
+                const int br_id = adj_branch[next_adj[bus_id]++];
+                if(br_id == parent_branch[bus_id]) continue;
+                const int other_bus = _branch_from[br_id] == bus_id ? _branch_to[br_id] : _branch_from[br_id];
+                if(tin[other_bus] == -1){
+                    // tree branch
+                    parent_branch[other_bus] = br_id;
+                    tin[other_bus] = low[other_bus] = timer++;
+                    stack.push_back(other_bus);
+                }else if(tin[other_bus] < tin[bus_id]){
+                    // non tree branch, seen from its deepest end
+                    low[bus_id] = std::min(low[bus_id], tin[other_bus]);
+                    std::uint64_t label = 0;
+                    while(label == 0) label = gen();
+                    _cut_labels[br_id] = label;
+                    acc_labels[bus_id] ^= label;
+                    acc_labels[other_bus] ^= label;
                 }
             }else{
-                // this is a trafo
-                const auto trafo_id = line_id - n_line_;
-                status = trafos.get_status()[trafo_id];
-                bus_1_id = id_me_to_solver[trafos.get_bus_from()[trafo_id]];
-                bus_2_id = id_me_to_solver[trafos.get_bus_to()[trafo_id]];
-                if(ac_solver_used){
-                    y_ff = trafos.yac_ff()[trafo_id];
-                    y_ft = trafos.yac_ft()[trafo_id];
-                    y_tf = trafos.yac_tf()[trafo_id];
-                    y_tt = trafos.yac_tt()[trafo_id];
-                }else{
-                    y_ff = trafos.ydc_ff()[trafo_id];
-                    y_ft = trafos.ydc_ft()[trafo_id];
-                    y_tf = trafos.ydc_tf()[trafo_id];
-                    y_tt = trafos.ydc_tt()[trafo_id];
-                }
+                // all the subtree of bus_id has been visited
+                stack.pop_back();
+                const int br_id = parent_branch[bus_id];
+                if(br_id == -1) continue;
+                const int parent_bus = _branch_from[br_id] == bus_id ? _branch_to[br_id] : _branch_from[br_id];
+                low[parent_bus] = std::min(low[parent_bus], low[bus_id]);
+                if(low[bus_id] > tin[parent_bus]) _is_bridge[br_id] = true;
+                _cut_labels[br_id] = acc_labels[bus_id];
+                acc_labels[parent_bus] ^= acc_labels[bus_id];
             }
+        }
+    }
+}
 
-            if(status && bus_1_id != GenericContainer::_deactivated_bus_id && bus_2_id != GenericContainer::_deactivated_bus_id)
-            {
-                // element is connected
-                this_cont_coeffs.push_back({bus_1_id, bus_1_id, y_ff});
-                this_cont_coeffs.push_back({bus_1_id, bus_2_id, y_ft});
-                this_cont_coeffs.push_back({bus_2_id, bus_1_id, y_tf});
-                this_cont_coeffs.push_back({bus_2_id, bus_2_id, y_tt});
-            }
+bool ContingencyAnalysis::is_connected_after(const std::set<int> & this_cont_id) const{
+    if(!_base_connected) return false;
+    // basis (for the xor) of the labels of the disconnected branches, sorted in decreasing order
+    std::vector<std::uint64_t> basis;
+    basis.reserve(this_cont_id.size());
+    for(auto br_id : this_cont_id){
+        if(!is_branch_in_graph(br_id)) continue;  // already disconnected (or both its sides are on the same bus)
+        if(_is_bridge[br_id]) return false;
+        std::uint64_t label = _cut_labels[br_id];
+        for(auto el : basis) label = std::min(label, label ^ el);
+        if(label == 0){
+            // some of the branches (probably) form a cut, I check it exactly
+            return is_connected_after_union_find(this_cont_id);
         }
-        _li_coeffs.push_back(this_cont_coeffs);
+        basis.insert(std::upper_bound(basis.begin(), basis.end(), label, std::greater<std::uint64_t>()), label);
     }
+    return true;
 }
 
-bool ContingencyAnalysis::remove_from_Ybus(Eigen::SparseMatrix<cplx_type> & Ybus,
-                                           const std::vector<Coeff> & coeffs) const
+bool ContingencyAnalysis::is_connected_after_union_find(const std::set<int> & this_cont_id) const{
+    std::vector<int> parent(_nb_bus_graph);
+    for(int bus_id = 0; bus_id < _nb_bus_graph; ++bus_id) parent[bus_id] = bus_id;
+    auto find = [&parent](int bus_id){
+        while(parent[bus_id] != bus_id){
+            parent[bus_id] = parent[parent[bus_id]];
+            bus_id = parent[bus_id];
+        }
+        return bus_id;
+    };
+    Eigen::Index nb_component = _nb_bus_graph;
+    for(Eigen::Index br_id = 0; br_id < n_total_; ++br_id){
+        if(!is_branch_in_graph(br_id)) continue;
+        if(this_cont_id.count(static_cast<int>(br_id))) continue;
+        const int root_from = find(_branch_from[br_id]);
+        const int root_to = find(_branch_to[br_id]);
+        if(root_from == root_to) continue;
+        parent[root_from] = root_to;
+        --nb_component;
+    }
+    return nb_component <= 1;
+}
+
+void ContingencyAnalysis::init_li_connected(bool ac_solver_used){
+    init_connectivity(ac_solver_used);
+    _li_connected.clear();
+    _li_connected.reserve(_li_defaults.size());
+    for(const auto & this_cont_id: _li_defaults){
+        _li_connected.push_back(is_connected_after(this_cont_id));
+    }
+}
+
+void ContingencyAnalysis::init_li_coeffs(bool ac_solver_used){
+    _need_init_coeffs = false;
+    _li_coeffs_ac = ac_solver_used;
+    _li_coeffs.clear();
+    _li_coeffs.reserve(_li_defaults.size());
+    for(const auto & this_cont_id: _li_defaults){
+        _li_coeffs.push_back(contingency_coeffs(this_cont_id, ac_solver_used));
+    }
+    init_li_connected(ac_solver_used);
+}
+
+std::vector<Coeff> ContingencyAnalysis::contingency_coeffs(const std::set<int> & this_cont_id, bool ac_solver_used) const{
+    return branch_ybus_coeffs(this_cont_id, ac_solver_used);
+}
+
+void ContingencyAnalysis::init_li_coeffs_pos(const Eigen::SparseMatrix<cplx_type> & Ybus){
+    _li_coeffs_pos.clear();
+    _li_coeffs_pos.reserve(_li_coeffs.size());
+    for(const auto & coeffs : _li_coeffs) _li_coeffs_pos.push_back(ybus_coeffs_pos(Ybus, coeffs));
+}
+
+void ContingencyAnalysis::remove_from_Ybus(Eigen::SparseMatrix<cplx_type> & Ybus,
+                                           const std::vector<Coeff> & coeffs,
+                                           const std::vector<Eigen::Index> & coeffs_pos,
+                                           std::vector<cplx_type> & init_values) const
 {
-    for(const auto & coeff_to_remove: coeffs){
-        Ybus.coeffRef(coeff_to_remove.row_id, coeff_to_remove.col_id) -= coeff_to_remove.value;
+    cplx_type * values = Ybus.valuePtr();
+    const std::size_t nb_coeffs = coeffs.size();
+    init_values.resize(nb_coeffs);
+    for(std::size_t i = 0; i < nb_coeffs; ++i){
+        cplx_type & el = values[coeffs_pos[i]];
+        init_values[i] = el;
+        el -= coeffs[i].value;
     }
-    return check_invertible(Ybus);
 }
 
 IntVect ContingencyAnalysis::is_grid_connected_after_contingency(){
-    const bool ac_solver_used = _solver.ac_solver_used();
-    Eigen::SparseMatrix<cplx_type> Ybus = ac_solver_used ? _grid_model.get_Ybus_solver() : _grid_model.get_dcYbus_solver();
-    IntVect res = IntVect::Constant(_li_coeffs.size(), 0);
-    int cont_id = 0;
-    for(const auto & coeffs_modif: _li_coeffs){
-        if(remove_from_Ybus(Ybus, coeffs_modif)) res(cont_id) = 1;
-        else res(cont_id) = 0;
-        readd_to_Ybus(Ybus, coeffs_modif);
-        ++cont_id;
+    init_li_connected(_solver.ac_solver_used());
+    IntVect res = IntVect::Constant(_li_connected.size(), 0);
+    for(std::size_t cont_id = 0; cont_id < _li_connected.size(); ++cont_id){
+        if(_li_connected[cont_id]) res(cont_id) = 1;
     }
     return res;
 }
 
 void ContingencyAnalysis::readd_to_Ybus(Eigen::SparseMatrix<cplx_type> & Ybus,
-                                     const std::vector<Coeff> & coeffs) const
+                                        const std::vector<Eigen::Index> & coeffs_pos,
+                                        const std::vector<cplx_type> & init_values) const
 {
-    for(const auto & coeff_to_remove: coeffs){
-        Ybus.coeffRef(coeff_to_remove.row_id, coeff_to_remove.col_id) += coeff_to_remove.value;
+    // restore in reverse order: if the same coefficient is modified multiple times
+    // the first value saved is the original one
+    cplx_type * values = Ybus.valuePtr();
+    for(std::size_t i = coeffs_pos.size(); i > 0; --i){
+        values[coeffs_pos[i - 1]] = init_values[i - 1];
     }
 }
 
 void ContingencyAnalysis::compute(const CplxVect & Vinit, int max_iter, real_type tol)
+{
+    std::vector<std::size_t> cont_ids(_li_defaults.size());
+    for(std::size_t cont_id = 0; cont_id < cont_ids.size(); ++cont_id) cont_ids[cont_id] = cont_id;
+    compute_subset(Vinit, max_iter, tol, cont_ids);
+    _screening_loading = RealVect();
+}
+
+void ContingencyAnalysis::compute_screened(const CplxVect & Vinit,
+                                           int max_iter,
+                                           real_type tol,
+                                           const RealVect & thermal_limits,
+                                           real_type loading_threshold,
+                                           int max_nb_verified)
+{
+    auto timer = CustTimer();
+    if(thermal_limits.size() != n_total_){
+        std::ostringstream exc_;
+        exc_ << "SecurityAnalysis::compute_screened: thermal_limits should have the same size as the total number of ";
+        exc_ << "powerlines / trafos (" << n_total_ << "), but it has " << thermal_limits.size() << " elements.";
+        throw std::runtime_error(exc_.str());
+    }
+
+    // first stage: active power flows after each contingency with the LODF
+    compute_lodf();
+    const double timer_screening = _timer_total;
+
+    // loading (estimated current / thermal limit) of the most loaded branch after each contingency
+    // current is estimated from the dc flows assuming a voltage magnitude of 1 pu.
+    const auto & bus_vn_kv = _grid_model.get_bus_vn_kv();
+    const auto & powerlines = _grid_model.get_powerlines_as_data();
+    const auto & trafos = _grid_model.get_trafos_as_data();
+    RealVect vn_kv_from = RealVect::Zero(n_total_);
+    for(Eigen::Index line_id = 0; line_id < n_line_; ++line_id){
+        if(!powerlines.get_status()[line_id]) continue;
+        vn_kv_from(line_id) = bus_vn_kv(powerlines.get_bus_from()[line_id]);
+    }
+    for(Eigen::Index trafo_id = 0; trafo_id < n_trafos_; ++trafo_id){
+        if(!trafos.get_status()[trafo_id]) continue;
+        vn_kv_from(trafo_id + n_line_) = bus_vn_kv(trafos.get_bus_from()[trafo_id]);
+    }
+    const Eigen::Index nb_cont = _li_defaults.size();
+    _screening_loading = RealVect::Zero(nb_cont);
+    const real_type sqrt_3 = sqrt(3.);
+    for(Eigen::Index cont_id = 0; cont_id < nb_cont; ++cont_id){
+        auto flows = _active_power_flows.row(cont_id);
+        if(!flows.allFinite()){
+            // the grid is split, this contingency cannot be simulated with the solver either
+            _screening_loading(cont_id) = std::numeric_limits<real_type>::infinity();
+            continue;
+        }
+        real_type max_loading = 0.;
+        for(Eigen::Index br_id = 0; br_id < n_total_; ++br_id){
+            if((vn_kv_from(br_id) <= 0.) || (thermal_limits(br_id) <= 0.)) continue;
+            const real_type loading = std::abs(flows(br_id)) / (sqrt_3 * vn_kv_from(br_id) * thermal_limits(br_id));
+            max_loading = std::max(max_loading, loading);
+        }
+        _screening_loading(cont_id) = max_loading;
+    }
+
+    // second stage: powerflow (with the solver of this class) for the most loaded contingencies only
+    std::vector<std::size_t> cont_ids;
+    for(Eigen::Index cont_id = 0; cont_id < nb_cont; ++cont_id){
+        const real_type loading = _screening_loading(cont_id);
+        if(isfinite(loading) && (loading >= loading_threshold)) cont_ids.push_back(cont_id);
+    }
+    if((max_nb_verified >= 0) && (cont_ids.size() > static_cast<std::size_t>(max_nb_verified))){
+        std::stable_sort(cont_ids.begin(), cont_ids.end(),
+                         [this](std::size_t cont1, std::size_t cont2){return _screening_loading(cont1) > _screening_loading(cont2);});
+        cont_ids.resize(max_nb_verified);
+        std::sort(cont_ids.begin(), cont_ids.end());
+    }
+    _active_power_flows = RealMat();
+    compute_subset(Vinit, max_iter, tol, cont_ids);
+    _timer_pre_proc += timer_screening;
+    _timer_total = timer.duration();
+}
+
+void ContingencyAnalysis::compute_subset(const CplxVect & Vinit, int max_iter, real_type tol, const std::vector<std::size_t> & cont_ids)
 {
     auto timer = CustTimer();
     auto timer_preproc = CustTimer();
@@ -160,18 +381,26 @@ void ContingencyAnalysis::compute(const CplxVect & Vinit, int max_iter, real_typ
     const auto & sn_mva = _grid_model.get_sn_mva();
     const bool ac_solver_used = _solver.ac_solver_used();
 
-    // redo a powerflow in case the solver has changed
+    // redo a powerflow in case the solver has changed (or the base case has been updated)
     if(ac_solver_used){
         if(_grid_model.get_solver().get_type() != _solver.get_type())
         {
             _grid_model.change_solver(_solver.get_type());
+            _base_ac_changed = true;
+        }
+        if(_base_ac_changed){
             _grid_model.ac_pf(Vinit, max_iter, tol);
+            _base_ac_changed = false;
         }
     }else{
         if(_grid_model.get_dc_solver().get_type() != _solver.get_type())
         {
             _grid_model.change_solver(_solver.get_type());
+            _base_dc_changed = true;
+        }
+        if(_base_dc_changed){
             _grid_model.dc_pf(Vinit, max_iter, tol);
+            _base_dc_changed = false;
         }
     }
     Eigen::SparseMatrix<cplx_type> Ybus = ac_solver_used ? _grid_model.get_Ybus_solver() : _grid_model.get_dcYbus_solver();
@@ -187,83 +416,457 @@ void ContingencyAnalysis::compute(const CplxVect & Vinit, int max_iter, real_typ
     CplxVect Sbus = CplxVect::Zero(nb_buses_solver);
     _grid_model.fillSbus_other(Sbus, ac_solver_used, id_me_to_solver); 
 
-    // initialize properly the coefficients that I will need to remove
-    init_li_coeffs(ac_solver_used);
+    // initialize properly the coefficients that I will need to remove (only if the contingencies or
+    // the topology changed) and where they are stored in Ybus, for the AC solvers
+    if(_need_init_coeffs || (_li_coeffs_ac != ac_solver_used)){
+        init_li_coeffs(ac_solver_used);
+    }
+    if(ac_solver_used){
+        Ybus.makeCompressed();
+        init_li_coeffs_pos(Ybus);
+    }
     Eigen::Index nb_steps = _li_defaults.size();
 
-    // init the results matrices
-    _voltages = BaseBatchSolverSynch::CplxMat::Zero(nb_steps, nb_total_bus); 
+    // init the results matrices (in streaming mode the voltages are sent to the sink instead)
+    _li_cont_branches = ((_sink && _sink_with_flows) || _aggregate) ? my_defaults_vect() : std::vector<std::vector<int> >();
+    if(_sink){
+        _voltages = BaseBatchSolverSynch::CplxMat();
+        _sink->start(nb_total_bus, n_total_, _sink_with_flows);
+    }else{
+        _voltages = BaseBatchSolverSynch::CplxMat::Zero(nb_steps, nb_total_bus); 
+    }
+    if(_aggregate) _aggr_res.init(nb_total_bus, n_total_);
     _amps_flows = RealMat::Zero(0, n_total_);
-
-    // reset the solver
-    _solver.reset();
-    _solver_control.tell_ybus_some_coeffs_zero();
-    // ybus does not change sparsity pattern here
+    _verified = IntVect::Zero(nb_steps);
+    // the sink is always told the computation is over (even if the base case diverged or something failed)
+    struct SinkFinisher{
+        ContingencyResultSink * sink;
+        ~SinkFinisher(){if(sink) sink->finish();}
+    } sink_finisher{_sink.get()};
 
     // compute the right Vinit to send to the solver
     CplxVect Vinit_solver = extract_Vsolver_from_Vinit(Vinit, nb_buses_solver, nb_total_bus, id_me_to_solver);
 
-    // perform the initial powerflow
-    _solver_control.tell_all_changed();
+    // perform the initial powerflow, the solver is reset only if needed: when only the injections 
+    // changed its symbolic factorization is kept
+    const bool same_buses = (bus_pv.size() == _solver_pv.size()) && (bus_pv == _solver_pv) &&
+                            (bus_pq.size() == _solver_pq.size()) && (bus_pq == _solver_pq) &&
+                            (slack_ids.size() == _solver_slack_ids.size()) && (slack_ids == _solver_slack_ids);
+    if(_need_reset_solver || !same_buses){
+        _solver.reset();
+        _solver_control.tell_all_changed();
+        _solver_pv = bus_pv;
+        _solver_pq = bus_pq;
+        _solver_slack_ids = slack_ids;
+        _need_reset_solver = false;
+    }else{
+        _solver_control.tell_none_changed();
+        _solver_control.tell_recompute_ybus();
+        _solver_control.tell_recompute_sbus();
+    }
     _solver.tell_solver_control(_solver_control);
     bool conv = _solver.compute_pf(Ybus, Vinit_solver, Sbus, slack_ids, slack_weights, bus_pv, bus_pq, max_iter, tol);
 
     // end of pre processing
     _timer_pre_proc = timer_preproc.duration();
-    if(!conv) return;
+    if(!conv){
+        finalize_aggregation();
+        return;
+    }
     _solver_control.tell_none_changed();
+    for(auto cont_id : cont_ids) _verified(cont_id) = 1;
+    // if an exception interrupts the contingencies, _solver might still hold the modifications of
+    // the (internal, for dc solvers) Ybus of one of them: it is reset at the next computation
+    struct ResetOnError{
+        bool & need_reset_solver;
+        bool done;
+        ~ResetOnError(){if(!done) need_reset_solver = true;}
+    } reset_on_error{_need_reset_solver, false};
 
     // now perform the security analysis
-    Eigen::Index cont_id = 0;
+    const std::size_t nb_worker = std::min(static_cast<std::size_t>(_nb_thread), cont_ids.size());
+    if(nb_worker <= 1){
+        compute_contingencies(_solver, _solver_control, Ybus, Vinit_solver, Sbus,
+                              slack_ids, slack_weights, bus_pv, bus_pq, id_solver_to_me,
+                              max_iter, tol / sn_mva,
+                              cont_ids, 0, 1,
+                              _nb_solved, _timer_solver, _timer_modif_Ybus,
+                              _aggr_res);
+        reset_on_error.done = true;
+        finalize_aggregation();
+        _timer_total = timer.duration();
+        return;
+    }
+
+    // each worker has its own solver, solver control and Ybus (the grid model is only read)
+    // the worker 0 is the calling thread and reuses _solver (already initialized above)
+    std::vector<std::unique_ptr<ChooseSolver> > solvers(nb_worker);
+    std::vector<SolverControl> solver_controls(nb_worker);
+    std::vector<Eigen::SparseMatrix<cplx_type> > Ybuses(nb_worker, Ybus);
+    std::vector<int> nb_solveds(nb_worker, 0);
+    std::vector<double> timer_solvers(nb_worker, 0.);
+    std::vector<double> timer_modif_Ybuses(nb_worker, 0.);
+    std::vector<std::exception_ptr> errors(nb_worker, nullptr);
+    std::vector<ContingencyAggregate> aggregates(nb_worker);
+    if(_aggregate){
+        for(auto & aggregate : aggregates) aggregate.init(nb_total_bus, n_total_);
+    }
+
+    auto run_worker = [&](std::size_t worker_id){
+        try{
+            ChooseSolver & solver = worker_id == 0 ? _solver : *solvers[worker_id];
+            SolverControl & solver_control = worker_id == 0 ? _solver_control : solver_controls[worker_id];
+            if(worker_id != 0){
+                // initialize this solver the same way _solver has been initialized
+                solver.change_solver(_solver.get_type());
+                solver.set_jacobian_reuse(_solver.get_refactor_every(), _solver.get_refactor_ratio());
+                solver.set_gridmodel(&_grid_model);
+                solver.reset();
+                solver_control.tell_all_changed();
+                solver.tell_solver_control(solver_control);
+                CplxVect V = Vinit_solver;
+                if(!solver.compute_pf(Ybuses[worker_id], V, Sbus, slack_ids, slack_weights, bus_pv, bus_pq, max_iter, tol)){
+                    // this should not happen as the same powerflow converged with _solver
+                    std::ostringstream exc_;
+                    exc_ << "SecurityAnalysis::compute: the initial powerflow diverged for the worker " << worker_id;
+                    exc_ << ", error was: " << solver.get_error();
+                    throw std::runtime_error(exc_.str());
+                }
+                solver_control.tell_none_changed();
+            }
+            compute_contingencies(solver, solver_control, Ybuses[worker_id], Vinit_solver, Sbus,
+                                  slack_ids, slack_weights, bus_pv, bus_pq, id_solver_to_me,
+                                  max_iter, tol / sn_mva,
+                                  cont_ids, worker_id, nb_worker,
+                                  nb_solveds[worker_id], timer_solvers[worker_id], timer_modif_Ybuses[worker_id],
+                                  aggregates[worker_id]);
+        }catch(...){
+            errors[worker_id] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nb_worker - 1);
+    for(std::size_t worker_id = 1; worker_id < nb_worker; ++worker_id){
+        solvers[worker_id] = std::unique_ptr<ChooseSolver>(new ChooseSolver());
+        threads.emplace_back(run_worker, worker_id);
+    }
+    run_worker(0);
+    for(auto & thread : threads) thread.join();
+
+    if(!errors[0]) reset_on_error.done = true;  // the other workers have their own solver
+    for(std::size_t worker_id = 0; worker_id < nb_worker; ++worker_id){
+        if(errors[worker_id]) std::rethrow_exception(errors[worker_id]);
+        // timers are summed over all the workers
+        _nb_solved += nb_solveds[worker_id];
+        _timer_solver += timer_solvers[worker_id];
+        _timer_modif_Ybus += timer_modif_Ybuses[worker_id];
+        if(_aggregate) _aggr_res.merge(aggregates[worker_id]);
+    }
+    finalize_aggregation();
+    _timer_total = timer.duration();
+}
+
+void ContingencyAnalysis::finalize_aggregation(){
+    if(!_aggregate) return;
+    // buses never energized (in any converged contingency)
+    for(Eigen::Index bus_id = 0; bus_id < _aggr_res.min_vm.size(); ++bus_id){
+        if(isfinite(_aggr_res.min_vm(bus_id))) continue;
+        _aggr_res.min_vm(bus_id) = std::numeric_limits<real_type>::quiet_NaN();
+        _aggr_res.max_vm(bus_id) = std::numeric_limits<real_type>::quiet_NaN();
+    }
+}
+
+void ContingencyAnalysis::compute_contingencies(ChooseSolver & solver,
+                                                SolverControl & solver_control,
+                                                Eigen::SparseMatrix<cplx_type> & Ybus,
+                                                const CplxVect & Vinit_solver,
+                                                const CplxVect & Sbus,
+                                                const Eigen::VectorXi & slack_ids,
+                                                const RealVect & slack_weights,
+                                                const Eigen::VectorXi & bus_pv,
+                                                const Eigen::VectorXi & bus_pq,
+                                                const std::vector<int> & id_solver_to_me,
+                                                int max_iter,
+                                                real_type tol,
+                                                const std::vector<std::size_t> & cont_ids,
+                                                std::size_t first_id,
+                                                std::size_t step,
+                                                int & nb_solved,
+                                                double & timer_solver,
+                                                double & timer_modif_Ybus,
+                                                ContingencyAggregate & aggregate)
+{
+    const bool ac_solver_used = solver.ac_solver_used();
+    const std::size_t nb_cont = cont_ids.size();
     CplxVect V;
-    for(const auto & coeffs_modif: _li_coeffs){
-        auto timer_modif_Ybus = CustTimer();
-        bool invertible = true;
-        // no need to add to this Ybus as DC solver have an internal Ybus which is updated with _solver.update_internal_Ybus
-        if (ac_solver_used) invertible = remove_from_Ybus(Ybus, coeffs_modif);
-        _timer_modif_Ybus += timer_modif_Ybus.duration();
+    CplxMat V_buffer;
+    RealMat flows_buffer;
+    RealVect violation_flows;
+    if(_aggregate){
+        // branches without limit are never in violation
+        violation_flows = _aggr_loading_threshold * _aggr_thermal_limits;
+        for(Eigen::Index br_id = 0; br_id < n_total_; ++br_id){
+            if(_aggr_thermal_limits(br_id) <= 0.) violation_flows(br_id) = std::numeric_limits<real_type>::infinity();
+        }
+    }
+    std::vector<cplx_type> init_values;
+    bool conv;
+    for(std::size_t id = first_id; id < nb_cont; id += step){
+        const std::size_t cont_id = cont_ids[id];
+        const auto & coeffs_modif = _li_coeffs[cont_id];
+        // contingencies that split the grid are not simulated
+        const bool invertible = _li_connected[cont_id];
+        auto timer_modif = CustTimer();
+        // no need to add to this Ybus as DC solver have an internal Ybus which is updated with solver.update_internal_Ybus
+        if (ac_solver_used && invertible) remove_from_Ybus(Ybus, coeffs_modif, _li_coeffs_pos[cont_id], init_values);
+        timer_modif_Ybus += timer_modif.duration();
         conv = false;
 
         if(invertible)
         {
             if(!ac_solver_used)
             {
-                // DC solver stores the ybus internally, I update it
-                // instead of building it over and over
+                // DC solver stores the ybus internally (and its factorization), I tell it which
+                // coefficients are removed, they are handled with a low rank update (no refactorization)
                 for(const Coeff& coeff : coeffs_modif){
-                    _solver.update_internal_Ybus(coeff, false);  // false => remove the coeff (using -= )
+                    solver.update_internal_Ybus(coeff, false);  // false => remove the coeff
                 }
             }
             V = Vinit_solver; // Vinit is reused for each contingencies
-            conv = compute_one_powerflow(Ybus, V, Sbus,
-                                         slack_ids, slack_weights,
-                                         bus_pv, bus_pq,
-                                         max_iter,
-                                         tol / sn_mva);
+            // the values of Ybus changed: the factorization of the jacobian of another contingency cannot be reused
+            if(ac_solver_used && solver.get_refactor_every() > 1) solver.tell_ybus_values_changed();
+            solver.tell_solver_control(solver_control);
+            conv = solver.compute_pf(Ybus, V, Sbus, slack_ids, slack_weights, bus_pv, bus_pq, max_iter, tol);
+            if(conv) V = solver.get_V().array();
+            ++nb_solved;
+            timer_solver += solver.get_computation_time();
             if(!ac_solver_used)
             {
-                // DC solver stores the ybus internally, I update it
-                // instead of building it over and over
+                // restore the base case
                 for(const Coeff& coeff : coeffs_modif){
-                    _solver.update_internal_Ybus(coeff, true);  // true => add back the coeff (using += )
+                    solver.update_internal_Ybus(coeff, true);  // true => add back the coeff
                 }
             }
         }
-        // std::string conv_str =  conv ? "has converged" : "has diverged";
-        // std::cout << "contingency " << contingency << ": " << conv_str << std::endl;
-        // if(!conv) std::cout << "\t error was: " << _solver.get_error() << std::endl;
-        // ++contingency;
-
-        timer_modif_Ybus = CustTimer();
-        // no need to add to this Ybus as DC solver have an internal Ybus which is updated with _solver.update_internal_Ybus
-        if (ac_solver_used) readd_to_Ybus(Ybus, coeffs_modif); 
-        _timer_modif_Ybus += timer_modif_Ybus.duration();
-        if (conv && invertible) _voltages.row(cont_id)(id_solver_to_me) = V.array();
+
+        timer_modif = CustTimer();
+        // no need to add to this Ybus as DC solver have an internal Ybus which is updated with solver.update_internal_Ybus
+        if (ac_solver_used && invertible) readd_to_Ybus(Ybus, _li_coeffs_pos[cont_id], init_values);
+        timer_modif_Ybus += timer_modif.duration();
+        conv = conv && invertible;
+        if(_sink || _aggregate){
+            cont_results(cont_id, conv, V, id_solver_to_me, _sink_with_flows || _aggregate, V_buffer, flows_buffer);
+            if(_aggregate && conv) aggregate.update(cont_id, V_buffer.row(0).transpose(), flows_buffer.row(0).transpose(), violation_flows);
+            if(_sink){
+                std::lock_guard<std::mutex> lock(_sink_mutex);
+                if(_sink_with_flows) _sink->push(cont_id, conv, V_buffer.row(0).transpose(), flows_buffer.row(0).transpose());
+                else _sink->push(cont_id, conv, V_buffer.row(0).transpose(), RealVect());
+            }
+        }
+        if (!_sink && conv) _voltages.row(cont_id)(id_solver_to_me) = V.array();
+    }
+}
+
+void ContingencyAnalysis::cont_results(std::size_t cont_id,
+                                       bool converged,
+                                       const CplxVect & V,
+                                       const std::vector<int> & id_solver_to_me,
+                                       bool with_flows,
+                                       CplxMat & V_buffer,
+                                       RealMat & flows_buffer) const
+{
+    V_buffer = CplxMat::Zero(1, _grid_model.total_bus());
+    if(converged) V_buffer.row(0)(id_solver_to_me) = V.array();
+    if(with_flows){
+        flows_buffer = RealMat::Zero(1, n_total_);
+        compute_flows_from_voltages(V_buffer, flows_buffer, true, 1);
+        for(auto l_id : _li_cont_branches[cont_id]){
+            real_type & el = flows_buffer(0, l_id);
+            if(isfinite(el)) el = 0.;
+        }
+    }else{
+        flows_buffer = RealMat::Zero(1, 0);
+    }
+}
+
+void ContingencyAnalysis::compute_lodf()
+{
+    auto timer = CustTimer();
+    auto timer_preproc = CustTimer();
+
+    _timer_modif_Ybus = 0.;
+    _timer_pre_proc = 0.;
+    _timer_total = 0.;
+    _timer_solver = 0.;
+
+    // everything is computed from the DC powerflow of the base case (done when this class is created,
+    // and again if the base case has been updated since then)
+    if(_base_dc_changed){
+        const CplxVect Vinit = CplxVect::Constant(_grid_model.total_bus(), {_grid_model.get_init_vm_pu(), 0.});
+        _grid_model.dc_pf(Vinit, 10, 1e-8);
+        _base_dc_changed = false;
+    }
+    const ChooseSolver & dc_solver = _grid_model.get_dc_solver();
+    if(!dc_solver.converged()){
+        std::ostringstream exc_;
+        exc_ << "SecurityAnalysis::compute_lodf: the DC powerflow did not converge on the base case, ";
+        exc_ << "the LODF cannot be used.";
+        throw std::runtime_error(exc_.str());
+    }
+    const auto & sn_mva = _grid_model.get_sn_mva();
+    const auto & id_me_to_solver = _grid_model.id_me_to_dc_solver();
+    const auto & powerlines = _grid_model.get_powerlines_as_data();
+    const auto & trafos = _grid_model.get_trafos_as_data();
+
+    // flows and PTDF of the base case (computed only once)
+    const RealVect Va_base = dc_solver.get_Va();
+    RealVect flows_base = RealVect::Zero(n_total_);
+    compute_dc_flows(powerlines, Va_base, id_me_to_solver, sn_mva, 0, false, flows_base);
+    compute_dc_flows(trafos, Va_base, id_me_to_solver, sn_mva, n_line_, true, flows_base);
+    const Eigen::Matrix<real_type, Eigen::Dynamic, Eigen::Dynamic> PTDF = _grid_model.get_ptdf_solver();  // size (nb_branch, nb_bus_solver)
+
+    // buses (solver labelling) of both sides of each branch and contingencies that split the grid
+    // (this overrides the connectivity analysis done for the solver of this class)
+    init_li_connected(false);
+    _need_init_coeffs = true;
+
+    // inputs for the contingencies that cannot be handled by the LODF
+    const Eigen::SparseMatrix<cplx_type> & Ybus = _grid_model.get_dcYbus_solver();
+    const CplxVect Sbus = _grid_model.get_dcSbus_solver();
+    const CplxVect Vinit_solver = dc_solver.get_V();
+    Eigen::SparseMatrix<cplx_type> Ybus_cont;
+    CplxVect Sbus_cont;
+    std::unique_ptr<ChooseSolver> explicit_solver;
+
+    // init the results matrices
+    const Eigen::Index nb_steps = _li_defaults.size();
+    _voltages = CplxMat();
+    _amps_flows = RealMat();
+    _active_power_flows = RealMat::Zero(nb_steps, n_total_);
+    _verified = IntVect::Zero(nb_steps);
+    _screening_loading = RealVect();
+    _timer_pre_proc = timer_preproc.duration();
+
+    std::vector<int> branch_out;
+    Eigen::Matrix<real_type, Eigen::Dynamic, Eigen::Dynamic> H;  // flow modification on all branches for a transfer between the two sides of each disconnected branch
+    Eigen::Matrix<real_type, Eigen::Dynamic, Eigen::Dynamic> M;
+    RealVect transfer;
+    RealVect flows;
+    Eigen::Index cont_id = 0;
+    for(const auto & this_cont_id: _li_defaults){
+        auto res = _active_power_flows.row(cont_id);
+        if(!_li_connected[cont_id]){
+            res.array() = std::numeric_limits<real_type>::quiet_NaN();
+            ++cont_id;
+            continue;
+        }
+        res = flows_base.transpose();
+
+        // only the connected branches are concerned
+        branch_out.clear();
+        for(auto l_id : this_cont_id){
+            if(_branch_from[l_id] == -1 || _branch_to[l_id] == -1) continue;
+            branch_out.push_back(l_id);
+        }
+        const Eigen::Index nb_out = branch_out.size();
+        if(nb_out == 0){
+            ++cont_id;
+            continue;
+        }
+
+        // for a n-1, H.col(0) (normalized) is the column of the LODF matrix,
+        // for a n-k, the "transfers" are computed such that the flows on all disconnected branches are 0
+        H.resize(n_total_, nb_out);
+        for(Eigen::Index j = 0; j < nb_out; ++j){
+            const auto l_id = branch_out[j];
+            H.col(j) = PTDF.col(_branch_from[l_id]) - PTDF.col(_branch_to[l_id]);
+        }
+        M = - H(branch_out, Eigen::all);
+        M.diagonal().array() += 1.;
+        bool lodf_ok;
+        if(nb_out == 1){
+            lodf_ok = std::abs(M(0, 0)) > _lodf_tol;
+            if(lodf_ok) transfer = flows_base(branch_out) / M(0, 0);
+        }else{
+            Eigen::FullPivLU<Eigen::Matrix<real_type, Eigen::Dynamic, Eigen::Dynamic> > lu(M);
+            lu.setThreshold(_lodf_tol);
+            lodf_ok = lu.isInvertible();
+            if(lodf_ok) transfer = lu.solve(flows_base(branch_out));
+        }
+
+        if(lodf_ok){
+            res += (H * transfer).transpose();
+            res(branch_out).array() = 0.;
+        }else{
+            // 1 - LODF_ii is (almost) 0 (but the grid is not split): numerical issue,
+            // I fall back to an actual powerflow, on the DC Ybus of the contingency factorized from scratch
+            // (reusing the factorization of the base case would suffer from the same issue)
+            SolverControl solver_control;
+            if(!explicit_solver){
+                explicit_solver = std::unique_ptr<ChooseSolver>(new ChooseSolver());
+                explicit_solver->change_solver(dc_solver.get_type());
+                explicit_solver->set_gridmodel(&_grid_model);
+                solver_control.tell_all_changed();
+            }else{
+                solver_control.tell_none_changed();
+                solver_control.tell_recompute_ybus();
+                solver_control.tell_recompute_sbus();
+            }
+            explicit_solver->tell_solver_control(solver_control);
+            Ybus_cont = Ybus;
+            for(const Coeff& coeff : contingency_coeffs(this_cont_id, false)) Ybus_cont.coeffRef(coeff.row_id, coeff.col_id) -= coeff.value;
+
+            // phase shifters are modeled with injections in the DC Sbus, they need to be removed too
+            Sbus_cont = Sbus;
+            for(auto l_id : branch_out){
+                if(l_id < n_line_) continue;
+                const real_type shift = trafos.dc_x_tau_shift()(l_id - n_line_);
+                Sbus_cont(_branch_from[l_id]) -= shift;
+                Sbus_cont(_branch_to[l_id]) += shift;
+            }
+            CplxVect V = Vinit_solver;
+            // max_iter and tol are not used by DC solvers
+            const bool conv = explicit_solver->compute_pf(Ybus_cont, V, Sbus_cont,
+                                                          _grid_model.get_slack_ids_dc_solver(),
+                                                          _grid_model.get_slack_weights_solver(),
+                                                          _grid_model.get_pv_solver(),
+                                                          _grid_model.get_pq_solver(),
+                                                          10, 1e-8);
+            ++_nb_solved;
+            _timer_solver += explicit_solver->get_computation_time();
+            if(conv){
+                const RealVect Va = explicit_solver->get_Va();
+                flows = RealVect::Zero(n_total_);
+                compute_dc_flows(powerlines, Va, id_me_to_solver, sn_mva, 0, false, flows);
+                compute_dc_flows(trafos, Va, id_me_to_solver, sn_mva, n_line_, true, flows);
+                res = flows.transpose();
+                res(branch_out).array() = 0.;
+            }
+            if(!conv) res.array() = std::numeric_limits<real_type>::quiet_NaN();
+        }
         ++cont_id;
     }
     _timer_total = timer.duration();
 }
 
+void ContingencyAnalysis::compute_results(bool branch_results, bool gen_results, bool shunt_results, bool bus_results)
+{
+    // the injections are the same for all the contingencies
+    const bool ac_solver_used = _solver.ac_solver_used();
+    const auto & id_me_to_solver = ac_solver_used ? _grid_model.id_me_to_ac_solver() :  _grid_model.id_me_to_dc_solver();
+    CplxVect Sbus = CplxVect::Zero(ac_solver_used ? _grid_model.id_ac_solver_to_me().size() : _grid_model.id_dc_solver_to_me().size());
+    if(gen_results) _grid_model.fillSbus_other(Sbus, ac_solver_used, id_me_to_solver);
+    CplxMat Sbuses = Sbus.transpose();
+
+    std::vector<std::vector<int> > removed_branches;
+    removed_branches.reserve(_li_defaults.size());
+    for(const auto & this_cont : _li_defaults) removed_branches.emplace_back(this_cont.begin(), this_cont.end());
+
+    compute_results_from_Vs(branch_results, gen_results, shunt_results, bus_results,
+                            Sbuses, removed_branches, _nb_thread);
+}
+
 // by default the flows are not 0 when the powerline is connected in the original topology
 // this function sorts this out
 void ContingencyAnalysis::clean_flows(bool is_amps)
@@ -10,7 +10,35 @@
 #define SECURITYANALYSIS_H
 
 #include "BaseBatchSolverSynch.h"
+#include "ContingencyResultSink.h"
 #include <set>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+
+/**
+Results of a contingency analysis reduced over all the (converged) contingencies, updated 
+each time a contingency is simulated
+**/
+struct ContingencyAggregate
+{
+    RealVect max_flows;  // for each branch, maximum current (kA) over all contingencies
+    IntVect max_flows_cont;  // for each branch, contingency responsible for max_flows (-1 if none)
+    IntVect nb_violations;  // for each branch, number of contingencies for which the current is above the limit
+    RealVect min_vm;  // for each bus, minimum voltage magnitude (pu) over all contingencies
+    RealVect max_vm;  // for each bus, maximum voltage magnitude (pu) over all contingencies
+
+    void init(Eigen::Index nb_bus, Eigen::Index nb_branch);
+    // V (0. for the disconnected buses) and amps_flows are the results of the contingency cont_id
+    void update(Eigen::Index cont_id,
+                Eigen::Ref<const CplxVect> V,
+                Eigen::Ref<const RealVect> amps_flows,
+                const RealVect & violation_flows);
+    // same results as if all the contingencies of "other" had been given to "update"
+    // (in case of equality, the contingency with the lowest id is kept)
+    void merge(const ContingencyAggregate & other);
+};
 
 /**
 Class to perform a contingency analysis (security analysis), which consist of performing some powerflow after some powerlines
@@ -23,9 +51,27 @@ class ContingencyAnalysis: public BaseBatchSolverSynch
                             BaseBatchSolverSynch(init_grid_model),
                             _li_defaults(),
                             _li_coeffs(),
+                            _li_coeffs_pos(),
                             _timer_total(0.),
                             _timer_modif_Ybus(0.),
-                            _timer_pre_proc(0.)
+                            _timer_pre_proc(0.),
+                            _nb_thread(1),
+                            _lodf_tol(1e-8),
+                            _base_connected(true),
+                            _nb_bus_graph(0),
+                            _verified(),
+                            _screening_loading(),
+                            _sink(),
+                            _sink_with_flows(false),
+                            _aggregate(false),
+                            _aggr_thermal_limits(),
+                            _aggr_loading_threshold(1.),
+                            _aggr_res(),
+                            _need_init_coeffs(true),
+                            _li_coeffs_ac(true),
+                            _need_reset_solver(true),
+                            _base_ac_changed(false),
+                            _base_dc_changed(false)
                             { }
 
         ContingencyAnalysis(const ContingencyAnalysis&) = delete;
@@ -36,11 +82,13 @@ class ContingencyAnalysis: public BaseBatchSolverSynch
                 std::set<int> this_default = {l_id};
                 _li_defaults.insert(this_default);
             }
+            _need_init_coeffs = true;
         }
         void add_n1(int line_id){
             check_ok_el(line_id);
             std::set<int> this_default = {line_id};
             _li_defaults.insert(this_default);
+            _need_init_coeffs = true;
         }
         void add_multiple_n1(const std::vector<int> & vect_n1s){
             for(const auto line_id : vect_n1s){
@@ -48,6 +96,7 @@ class ContingencyAnalysis: public BaseBatchSolverSynch
                 std::set<int> this_default = {line_id};
                 _li_defaults.insert(this_default);
             }
+            _need_init_coeffs = true;
         }
         void add_nk(const std::vector<int> & vect_nk){
             std::set<int> this_default;
@@ -57,6 +106,7 @@ class ContingencyAnalysis: public BaseBatchSolverSynch
                 this_default.insert(line_id);
             }
             _li_defaults.insert(this_default);
+            _need_init_coeffs = true;
         }
 
         // utilities to remove defaults to simulate (TODO)
@@ -64,12 +114,23 @@ class ContingencyAnalysis: public BaseBatchSolverSynch
             BaseBatchSolverSynch::clear();
             _li_defaults.clear();
             _li_coeffs.clear();
+            _li_coeffs_pos.clear();
+            _li_connected.clear();
+            _verified = IntVect();
+            _screening_loading = RealVect();
+            _aggr_res = ContingencyAggregate();
             _timer_total = 0.;
             _timer_modif_Ybus = 0.;
             _timer_pre_proc = 0.;
+            _need_init_coeffs = true;
+            _need_reset_solver = true;
         }
+        // the contingencies, the solver (and its factorization) are kept
         void clear_results_only(){
-            BaseBatchSolverSynch::clear();
+            BaseBatchSolverSynch::clear_results();
+            _verified = IntVect();
+            _screening_loading = RealVect();
+            _aggr_res = ContingencyAggregate();
             _timer_total = 0.;
             _timer_modif_Ybus = 0.;
             _timer_pre_proc = 0.;
@@ -79,6 +140,7 @@ class ContingencyAnalysis: public BaseBatchSolverSynch
             check_ok_el(line_id);
             std::set<int> this_default = {line_id};
             auto nb_removed = _li_defaults.erase(this_default);
+            _need_init_coeffs = true;
             return nb_removed >= 1;
         }
         size_t remove_multiple_n1(const std::vector<int> & vect_n1s){
@@ -88,6 +150,7 @@ class ContingencyAnalysis: public BaseBatchSolverSynch
                 std::set<int> this_default = {line_id};
                 nb_removed += _li_defaults.erase(this_default);
             }
+            _need_init_coeffs = true;
             return nb_removed;
         }
         bool remove_nk(const std::vector<int> & vect_nk){
@@ -98,25 +161,127 @@ class ContingencyAnalysis: public BaseBatchSolverSynch
                 this_default.insert(line_id);
             }
             auto nb_removed = _li_defaults.erase(this_default);
+            _need_init_coeffs = true;
             return nb_removed >= 1;
         }
 
+        // incremental update of the base case (instead of creating a new ContingencyAnalysis): the internal
+        // grid model is modified, and the base powerflow is run again at the next computation. The contingency 
+        // coefficients, the connectivity analysis and the solver (with its symbolic factorization) are kept when 
+        // the topology is not modified.
+        void update_gens_p(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, Eigen::RowMajor> > has_changed,
+                           Eigen::Ref<Eigen::Array<float, Eigen::Dynamic, Eigen::RowMajor> > new_values){
+            _grid_model.update_gens_p(has_changed, new_values);
+            tell_injections_changed();
+        }
+        void update_sgens_p(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, Eigen::RowMajor> > has_changed,
+                            Eigen::Ref<Eigen::Array<float, Eigen::Dynamic, Eigen::RowMajor> > new_values){
+            _grid_model.update_sgens_p(has_changed, new_values);
+            tell_injections_changed();
+        }
+        void update_gens_v(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, Eigen::RowMajor> > has_changed,
+                           Eigen::Ref<Eigen::Array<float, Eigen::Dynamic, Eigen::RowMajor> > new_values){
+            _grid_model.update_gens_v(has_changed, new_values);
+            tell_injections_changed();
+        }
+        void update_loads_p(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, Eigen::RowMajor> > has_changed,
+                            Eigen::Ref<Eigen::Array<float, Eigen::Dynamic, Eigen::RowMajor> > new_values){
+            _grid_model.update_loads_p(has_changed, new_values);
+            tell_injections_changed();
+        }
+        void update_loads_q(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, Eigen::RowMajor> > has_changed,
+                            Eigen::Ref<Eigen::Array<float, Eigen::Dynamic, Eigen::RowMajor> > new_values){
+            _grid_model.update_loads_q(has_changed, new_values);
+            tell_injections_changed();
+        }
+        void update_storages_p(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, Eigen::RowMajor> > has_changed,
+                               Eigen::Ref<Eigen::Array<float, Eigen::Dynamic, Eigen::RowMajor> > new_values){
+            _grid_model.update_storages_p(has_changed, new_values);
+            tell_injections_changed();
+        }
+        void update_topo(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, Eigen::RowMajor> > has_changed,
+                         Eigen::Ref<Eigen::Array<int, Eigen::Dynamic, Eigen::RowMajor> > new_values){
+            if(!has_changed.any()) return;
+            _grid_model.update_topo(has_changed, new_values);
+            tell_topo_changed();
+        }
+        void change_p_shunt(int shunt_id, real_type new_p){
+            _grid_model.change_p_shunt(shunt_id, new_p);
+            tell_injections_changed();
+        }
+        void change_q_shunt(int shunt_id, real_type new_q){
+            _grid_model.change_q_shunt(shunt_id, new_q);
+            tell_injections_changed();
+        }
+        void change_bus_shunt(int shunt_id, int new_bus_id){
+            _grid_model.change_bus_shunt(shunt_id, new_bus_id);
+            tell_topo_changed();
+        }
+        void deactivate_shunt(int shunt_id){
+            _grid_model.deactivate_shunt(shunt_id);
+            tell_topo_changed();
+        }
+        void reactivate_shunt(int shunt_id){
+            _grid_model.reactivate_shunt(shunt_id);
+            tell_topo_changed();
+        }
+        void update_slack_weights(Eigen::Ref<Eigen::Array<bool, Eigen::Dynamic, Eigen::RowMajor> > could_be_slack){
+            _grid_model.update_slack_weights(could_be_slack);
+            tell_injections_changed();
+            _need_reset_solver = true;
+        }
+
         // make the computation
         void compute(const CplxVect & Vinit, int max_iter, real_type tol);
         IntVect is_grid_connected_after_contingency();
 
+        // DC only: compute the active power flows after each contingency with the LODF (from the DC powerflow 
+        // of the base case) instead of running a powerflow for each of them. A powerflow is only run when
+        // the LODF cannot be used (1 - LODF_ii is almost 0, ie the contingency split the grid)
+        void compute_lodf();
+        void set_lodf_tol(real_type lodf_tol){
+            if(lodf_tol <= 0.){
+                std::ostringstream exc_;
+                exc_ << "SecurityAnalysis::set_lodf_tol: the tolerance should be > 0., ";
+                exc_ << "you provided " << lodf_tol << ".";
+                throw std::runtime_error(exc_.str());
+            }
+            _lodf_tol = lodf_tol;
+        }
+        real_type get_lodf_tol() const {return _lodf_tol;}
+
+        // two stages contingency analysis: all contingencies are first screened with the LODF (see compute_lodf)
+        // then a powerflow (with the solver of this class) is run only for the contingencies for which the 
+        // loading of the most loaded branch (estimated from the dc flows, thermal_limits are in kA) is above
+        // loading_threshold. At most max_nb_verified contingencies (the most loaded ones) are simulated 
+        // this way (no limit if max_nb_verified is < 0).
+        void compute_screened(const CplxVect & Vinit,
+                              int max_iter,
+                              real_type tol,
+                              const RealVect & thermal_limits,
+                              real_type loading_threshold,
+                              int max_nb_verified);
+        // 1 for the contingencies simulated with the solver of this class at the last call to `compute...`, 0 otherwise
+        const IntVect & get_verified() const {return _verified;}
+        // loading of the most loaded branch estimated during the screening (empty if `compute_screened` was not called)
+        const RealVect & get_screening_loading() const {return _screening_loading;}
+
         Eigen::Ref<RealMat > compute_flows() {
-            compute_flows_from_Vs();
+            compute_flows_from_Vs(true, _nb_thread);
             clean_flows();
             return _amps_flows;
         }
 
         Eigen::Ref<RealMat > compute_power_flows() {
-            compute_flows_from_Vs(false);
+            compute_flows_from_Vs(false, _nb_thread);
             clean_flows(false);
             return _active_power_flows;
         }
 
+        // results of the branches, generators, shunts and buses (see get_p_or, get_gen_q, get_shunt_q and get_bus_v_kv)
+        // for each contingency, the disconnected branches are at 0.
+        void compute_results(bool branch_results, bool gen_results, bool shunt_results, bool bus_results);
+
         // python cannot handle set of sets... (c++ can because set are ordered set, but in python
         // they are unordered one, with hash functions)
         const std::set<std::set<int> > & my_defaults() const {return _li_defaults;}
@@ -130,6 +295,48 @@ class ContingencyAnalysis: public BaseBatchSolverSynch
             return res;
         }
 
+        // parallel computation: the contingencies are split between "nb_thread" workers
+        // (each with its own solver and its own copy of Ybus)
+        void set_nb_thread(int nb_thread){
+            if(nb_thread < 1){
+                std::ostringstream exc_;
+                exc_ << "SecurityAnalysis::set_nb_thread: the number of threads should be >= 1, ";
+                exc_ << "you provided " << nb_thread << ".";
+                throw std::runtime_error(exc_.str());
+            }
+            _nb_thread = nb_thread;
+        }
+        int get_nb_thread() const {return _nb_thread;}
+
+        // streaming mode: the results of each contingency are sent to the sink as soon as it is simulated
+        // (by compute and compute_screened) and the dense results (get_voltages) are not stored
+        void set_result_sink(std::shared_ptr<ContingencyResultSink> sink, bool with_flows){
+            _sink = sink;
+            _sink_with_flows = with_flows;
+        }
+        void clear_result_sink(){
+            _sink.reset();
+            _sink_with_flows = false;
+        }
+        bool has_result_sink() const {return static_cast<bool>(_sink);}
+
+        // online aggregation: each time a contingency converges (in compute and compute_screened), the 
+        // maximum current of each branch (and the contingency responsible for it), the number of contingencies
+        // for which the current is above loading_threshold * thermal_limits (in kA) and the min / max voltage 
+        // magnitude of each bus are updated
+        void set_aggregation(const RealVect & thermal_limits, real_type loading_threshold);
+        void clear_aggregation(){
+            _aggregate = false;
+            _aggr_thermal_limits = RealVect();
+            _aggr_res = ContingencyAggregate();
+        }
+        bool has_aggregation() const {return _aggregate;}
+        const RealVect & get_max_flows() const {return _aggr_res.max_flows;}
+        const IntVect & get_max_flows_cont() const {return _aggr_res.max_flows_cont;}
+        const IntVect & get_nb_violations() const {return _aggr_res.nb_violations;}
+        const RealVect & get_min_vm() const {return _aggr_res.min_vm;}
+        const RealVect & get_max_vm() const {return _aggr_res.max_vm;}
+
         // timers
         double total_time() const {return _timer_total;}
         double preprocessing_time() const {return _timer_pre_proc;}
@@ -141,6 +348,16 @@ class ContingencyAnalysis: public BaseBatchSolverSynch
         }
 
     protected:
+        void tell_injections_changed(){
+            _base_ac_changed = true;
+            _base_dc_changed = true;
+        }
+        void tell_topo_changed(){
+            tell_injections_changed();
+            _need_init_coeffs = true;
+            _need_reset_solver = true;
+        }
+
         // prevent the insertion of "out of range" elements
         void check_ok_el(Eigen::Index el){
             if(el < 0){
@@ -157,26 +374,159 @@ class ContingencyAnalysis: public BaseBatchSolverSynch
             }
         }
         void init_li_coeffs(bool ac_solver_used);
+        // coefficients of Ybus (solver labelling) to modify to simulate the given contingency
+        std::vector<Coeff> contingency_coeffs(const std::set<int> & this_cont_id, bool ac_solver_used) const;
+        // position (in Ybus.valuePtr()) of each coefficient of _li_coeffs, Ybus must be compressed
+        // (the positions are valid for any copy of this Ybus)
+        void init_li_coeffs_pos(const Eigen::SparseMatrix<cplx_type> & Ybus);
         // remove the line parameters from Ybus, this is to emulate its disconnection
-        bool remove_from_Ybus(Eigen::SparseMatrix<cplx_type> & Ybus, const std::vector<Coeff> & coeffs) const;
-        // after the coefficient has been removed with "remove_from_Ybus", add it back to Ybus
-        void readd_to_Ybus(Eigen::SparseMatrix<cplx_type> & Ybus, const std::vector<Coeff> & coeffs) const;
+        // (the values of Ybus before the modification are stored in init_values)
+        void remove_from_Ybus(Eigen::SparseMatrix<cplx_type> & Ybus,
+                              const std::vector<Coeff> & coeffs,
+                              const std::vector<Eigen::Index> & coeffs_pos,
+                              std::vector<cplx_type> & init_values) const;
+        // after the coefficient has been removed with "remove_from_Ybus", put back the original values in Ybus
+        // (values are restored and not added back, so that Ybus is exactly the same as before, whatever the
+        // number of contingencies simulated)
+        void readd_to_Ybus(Eigen::SparseMatrix<cplx_type> & Ybus,
+                           const std::vector<Eigen::Index> & coeffs_pos,
+                           const std::vector<cplx_type> & init_values) const;
 
         // by default the flows are not 0 when the powerline is connected in the original topology
         // this function sorts this out
         void clean_flows(bool is_amps=true);
 
         // sometimes, when i perform some disconnection, I make the graph non connexe
-        // in this case, well, i don't use the results of the simulation
-        bool check_invertible(const Eigen::SparseMatrix<cplx_type> & Ybus) const;
+        // in this case, well, i don't simulate the contingency.
+        // The graph of the base case is analyzed once (bridges and "cut" labels, see init_connectivity) 
+        // and then checking a contingency costs O(k^2) for k disconnected elements
+        void init_connectivity(bool ac_solver_used);
+        bool is_connected_after(const std::set<int> & this_cont_id) const;
+        // exact check (O(nb_branch)) used when the labels indicate the grid is split
+        bool is_connected_after_union_find(const std::set<int> & this_cont_id) const;
+        // fill _li_connected (and the connectivity index)
+        void init_li_connected(bool ac_solver_used);
+        bool is_branch_in_graph(Eigen::Index br_id) const {
+            const int bus_from = _branch_from[br_id];
+            const int bus_to = _branch_to[br_id];
+            return (bus_from != -1) && (bus_to != -1) && (bus_from != bus_to);
+        }
+
+        // perform the powerflows only for the contingencies in cont_ids (indexes of the rows of the results)
+        void compute_subset(const CplxVect & Vinit, int max_iter, real_type tol, const std::vector<std::size_t> & cont_ids);
+
+        // simulate the contingencies cont_ids[first_id], cont_ids[first_id + step], cont_ids[first_id + 2 * step], ...
+        // with the given solver and write the results in the corresponding rows of _voltages.
+        // Only the rows of _voltages it is responsible for are written, so it can be called
+        // concurrently by different workers (provided each has its own solver, solver_control and Ybus)
+        void compute_contingencies(ChooseSolver & solver,
+                                   SolverControl & solver_control,
+                                   Eigen::SparseMatrix<cplx_type> & Ybus,
+                                   const CplxVect & Vinit_solver,
+                                   const CplxVect & Sbus,
+                                   const Eigen::VectorXi & slack_ids,
+                                   const RealVect & slack_weights,
+                                   const Eigen::VectorXi & bus_pv,
+                                   const Eigen::VectorXi & bus_pq,
+                                   const std::vector<int> & id_solver_to_me,
+                                   int max_iter,
+                                   real_type tol,
+                                   const std::vector<std::size_t> & cont_ids,
+                                   std::size_t first_id,
+                                   std::size_t step,
+                                   int & nb_solved,
+                                   double & timer_solver,
+                                   double & timer_modif_Ybus,
+                                   ContingencyAggregate & aggregate);
+        // buses never energized get NaN as min / max voltage magnitude
+        void finalize_aggregation();
+        // results (as a row of _voltages and of _amps_flows after compute_flows) of the contingency 
+        // cont_id (V is in the solver labelling), used by the sink and the aggregation
+        void cont_results(std::size_t cont_id,
+                          bool converged,
+                          const CplxVect & V,
+                          const std::vector<int> & id_solver_to_me,
+                          bool with_flows,
+                          CplxMat & V_buffer,
+                          RealMat & flows_buffer) const;
+
+        // dc flows (in MW) at the "from" side of each element, computed from the voltage angles (solver labelling)
+        template<class T>
+        void compute_dc_flows(const T & structure_data,
+                              const RealVect & Va,
+                              const std::vector<int> & id_me_to_solver,
+                              real_type sn_mva,
+                              Eigen::Index lag_id,
+                              bool is_trafo,
+                              RealVect & res) const
+        {
+            const auto & el_status = structure_data.get_status();
+            const auto & bus_from = structure_data.get_bus_from();
+            const auto & bus_to = structure_data.get_bus_to();
+            const auto & vect_y_ff = structure_data.ydc_ff();
+            const auto & vect_y_ft = structure_data.ydc_ft();
+            Eigen::Ref<const RealVect> dc_x_tau_shift = structure_data.dc_x_tau_shift(); // not used if it's powerline
+            const Eigen::Index nb_el = structure_data.nb();
+            for(Eigen::Index el_id = 0; el_id < nb_el; ++el_id){
+                if(!el_status[el_id]) continue;
+                const int bus_from_solver = id_me_to_solver[bus_from(el_id)];
+                const int bus_to_solver = id_me_to_solver[bus_to(el_id)];
+                real_type p_from = std::real(vect_y_ff(el_id)) * Va(bus_from_solver) + std::real(vect_y_ft(el_id)) * Va(bus_to_solver);
+                if(is_trafo) p_from -= dc_x_tau_shift(el_id);
+                res(el_id + lag_id) = p_from * sn_mva;
+            }
+        }
+
     private:
         // li_default
         std::set<std::set<int> > _li_defaults;  // do not use unordered_set here, we rely on the order for different functions !
         std::vector<std::vector<Coeff> > _li_coeffs;  // for each n-k, stores the coefficients I need to modify in the Ybus
+        std::vector<std::vector<Eigen::Index> > _li_coeffs_pos;  // for each n-k, position of these coefficients in Ybus.valuePtr() (AC only)
 
         //timers
         double _timer_total;  // total time spent in "compute"
         double _timer_modif_Ybus;  // time to update the Ybus between the defaults simulation
         double _timer_pre_proc;  // time to compute the coefficients of the Ybus
+
+        // parallelism
+        int _nb_thread;  // number of workers used in "compute" (1 = everything is done in the calling thread)
+
+        // lodf
+        real_type _lodf_tol;  // below this value, 1 - LODF_ii is considered to be 0 (contingency split the grid)
+
+        // connectivity index of the base case (see init_connectivity)
+        bool _base_connected;
+        int _nb_bus_graph;
+        std::vector<int> _branch_from;  // solver bus of the "from" side of each branch (-1 if disconnected)
+        std::vector<int> _branch_to;  // solver bus of the "to" side of each branch (-1 if disconnected)
+        std::vector<bool> _is_bridge;
+        std::vector<std::uint64_t> _cut_labels;
+        std::vector<bool> _li_connected;  // for each contingency: does the grid stay connected
+
+        // screening
+        IntVect _verified;  // 1 if the contingency has been simulated with the solver, 0 otherwise
+        RealVect _screening_loading;  // loading of the most loaded branch (dc approximation) for each contingency
+
+        // streaming mode
+        std::shared_ptr<ContingencyResultSink> _sink;  // if set, results are sent there instead of being stored in _voltages
+        bool _sink_with_flows;  // whether the flows are also sent to the sink
+        std::mutex _sink_mutex;  // the sink is never called concurrently
+        std::vector<std::vector<int> > _li_cont_branches;  // branches disconnected by each contingency (to clean the flows)
+
+        // online aggregation
+        bool _aggregate;
+        RealVect _aggr_thermal_limits;  // kA
+        real_type _aggr_loading_threshold;
+        ContingencyAggregate _aggr_res;
+
+        // incremental update of the base case
+        bool _need_init_coeffs;  // _li_coeffs (and the connectivity) need to be computed again
+        bool _li_coeffs_ac;  // whether _li_coeffs have been computed for an ac solver
+        bool _need_reset_solver;  // _solver needs to be initialized from scratch (symbolic factorization included)
+        Eigen::VectorXi _solver_pv;  // pv buses used for the last initialization of _solver
+        Eigen::VectorXi _solver_pq;  // pq buses used for the last initialization of _solver
+        Eigen::VectorXi _solver_slack_ids;  // slack buses used for the last initialization of _solver
+        bool _base_ac_changed;  // the grid model has been modified since its last ac powerflow
+        bool _base_dc_changed;  // the grid model has been modified since its last dc powerflow
 };
 #endif  //COMPUTERS_H
@@ -0,0 +1,103 @@
+// Copyright (c) 2025, RTE (https://www.rte-france.com)
+// See AUTHORS.txt
+// This Source Code Form is subject to the terms of the Mozilla Public License, version 2.0.
+// If a copy of the Mozilla Public License, version 2.0 was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// SPDX-License-Identifier: MPL-2.0
+// This file is part of LightSim2grid, LightSim2grid implements a c++ backend targeting the Grid2Op platform.
+
+#include "ContingencyResultSink.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <cstdint>
+
+ContingencyQueueSink::ContingencyQueueSink(int max_size):
+    _max_size(max_size),
+    _queue(),
+    _finished(true)
+{
+    if(max_size < 1){
+        std::ostringstream exc_;
+        exc_ << "ContingencyQueueSink: the maximum size of the queue should be >= 1, ";
+        exc_ << "you provided " << max_size << ".";
+        throw std::runtime_error(exc_.str());
+    }
+}
+
+void ContingencyQueueSink::start(Eigen::Index /*nb_bus*/, Eigen::Index /*nb_branch*/, bool /*with_flows*/){
+    std::lock_guard<std::mutex> lock(_mutex);
+    _finished = false;
+}
+
+void ContingencyQueueSink::push(Eigen::Index cont_id,
+                                bool converged,
+                                Eigen::Ref<const CplxVect> V,
+                                Eigen::Ref<const RealVect> amps_flows)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _not_full.wait(lock, [this]{return _queue.size() < static_cast<std::size_t>(_max_size);});
+    _queue.push_back({cont_id, converged, V, amps_flows});
+    lock.unlock();
+    _not_empty.notify_one();
+}
+
+void ContingencyQueueSink::finish(){
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _finished = true;
+    }
+    _not_empty.notify_all();
+}
+
+bool ContingencyQueueSink::pop(ContingencyResult & res){
+    std::unique_lock<std::mutex> lock(_mutex);
+    _not_empty.wait(lock, [this]{return _finished || !_queue.empty();});
+    if(_queue.empty()) return false;
+    res = std::move(_queue.front());
+    _queue.pop_front();
+    lock.unlock();
+    _not_full.notify_one();
+    return true;
+}
+
+void ContingencyFileSink::start(Eigen::Index nb_bus, Eigen::Index nb_branch, bool with_flows){
+    _nb_bus = nb_bus;
+    _nb_branch = nb_branch;
+    _with_flows = with_flows;
+    if(_file.is_open()) _file.close();
+    // the layout of the records depends on the settings of the computation: the file is overwritten
+    _file.open(_path, std::ios::binary | std::ios::trunc);
+    if(!_file){
+        std::ostringstream exc_;
+        exc_ << "ContingencyFileSink: impossible to open the file \"" << _path << "\" for writing.";
+        throw std::runtime_error(exc_.str());
+    }
+}
+
+void ContingencyFileSink::push(Eigen::Index cont_id,
+                               bool converged,
+                               Eigen::Ref<const CplxVect> V,
+                               Eigen::Ref<const RealVect> amps_flows)
+{
+    const std::int64_t header[2] = {static_cast<std::int64_t>(cont_id), converged ? 1 : 0};
+    _file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    _file.write(reinterpret_cast<const char*>(V.data()), _nb_bus * sizeof(cplx_type));
+    if(_with_flows) _file.write(reinterpret_cast<const char*>(amps_flows.data()), _nb_branch * sizeof(real_type));
+    if(!_file){
+        std::ostringstream exc_;
+        exc_ << "ContingencyFileSink: error while writing the results of contingency " << cont_id;
+        exc_ << " to the file \"" << _path << "\".";
+        throw std::runtime_error(exc_.str());
+    }
+}
+
+void ContingencyFileSink::finish(){
+    if(_file.is_open()) _file.close();
+}
+
+std::size_t ContingencyFileSink::record_size() const{
+    std::size_t res = 2 * sizeof(std::int64_t) + _nb_bus * sizeof(cplx_type);
+    if(_with_flows) res += _nb_branch * sizeof(real_type);
+    return res;
+}
@@ -0,0 +1,152 @@
+// Copyright (c) 2025, RTE (https://www.rte-france.com)
+// See AUTHORS.txt
+// This Source Code Form is subject to the terms of the Mozilla Public License, version 2.0.
+// If a copy of the Mozilla Public License, version 2.0 was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// SPDX-License-Identifier: MPL-2.0
+// This file is part of LightSim2grid, LightSim2grid implements a c++ backend targeting the Grid2Op platform.
+
+#ifndef CONTINGENCYRESULTSINK_H
+#define CONTINGENCYRESULTSINK_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <fstream>
+#include <string>
+
+#include "Utils.h"
+
+/**
+Receives the results of a ContingencyAnalysis one contingency at a time (instead of storing them
+in a dense "nb_contingency x nb_bus" matrix), so that memory stays bounded whatever the number
+of contingencies simulated.
+
+The ContingencyAnalysis never calls "push" concurrently (even when multiple threads are used), but
+the contingencies are not necessarily pushed in order.
+**/
+class ContingencyResultSink
+{
+    public:
+        virtual ~ContingencyResultSink() = default;
+
+        // called once at the beginning of each computation
+        virtual void start(Eigen::Index /*nb_bus*/, Eigen::Index /*nb_branch*/, bool /*with_flows*/) {}
+
+        // called once for each contingency: V (complex voltages, one per bus of the grid model) is 0.
+        // if the contingency has not converged. amps_flows (kA at the "from" side of each powerline then
+        // each trafos) is empty if the flows are not requested.
+        virtual void push(Eigen::Index cont_id,
+                          bool converged,
+                          Eigen::Ref<const CplxVect> V,
+                          Eigen::Ref<const RealVect> amps_flows) = 0;
+
+        // called once at the end of each computation (even if it failed)
+        virtual void finish() {}
+};
+
+/**
+Calls a user defined function for each contingency
+**/
+class ContingencyCallbackSink: public ContingencyResultSink
+{
+    public:
+        typedef std::function<void(Eigen::Index, bool, const CplxVect &, const RealVect &)> CallbackType;
+
+        ContingencyCallbackSink(const CallbackType & callback):
+            _callback(callback) {}
+
+        virtual void push(Eigen::Index cont_id,
+                          bool converged,
+                          Eigen::Ref<const CplxVect> V,
+                          Eigen::Ref<const RealVect> amps_flows){
+            _callback(cont_id, converged, V, amps_flows);
+        }
+
+    private:
+        CallbackType _callback;
+};
+
+// result of one contingency, as stored in the ContingencyQueueSink
+struct ContingencyResult
+{
+    Eigen::Index cont_id;
+    bool converged;
+    CplxVect V;
+    RealVect amps_flows;
+};
+
+/**
+Bounded queue: the computation blocks when "max_size" results are waiting to be consumed
+(with "pop", typically from another thread).
+**/
+class ContingencyQueueSink: public ContingencyResultSink
+{
+    public:
+        ContingencyQueueSink(int max_size);
+
+        virtual void start(Eigen::Index nb_bus, Eigen::Index nb_branch, bool with_flows);
+        virtual void push(Eigen::Index cont_id,
+                          bool converged,
+                          Eigen::Ref<const CplxVect> V,
+                          Eigen::Ref<const RealVect> amps_flows);
+        virtual void finish();
+
+        // wait for the next result, returns false (and res is not modified) when the
+        // computation is over and all the results have been consumed
+        bool pop(ContingencyResult & res);
+
+        int max_size() const {return _max_size;}
+        int size() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return static_cast<int>(_queue.size());
+        }
+
+    private:
+        const int _max_size;
+        std::deque<ContingencyResult> _queue;
+        bool _finished;
+        std::mutex _mutex;
+        std::condition_variable _not_full;
+        std::condition_variable _not_empty;
+};
+
+/**
+Writes the results to a binary file (overwritten at each computation), each contingency being stored as a fixed size record:
+    - cont_id (int64)
+    - converged (int64, 0 or 1)
+    - V (nb_bus complex128)
+    - amps_flows (nb_branch float64, only if the flows are requested)
+
+The file can then be read (without loading it completely) with `numpy.memmap`.
+**/
+class ContingencyFileSink: public ContingencyResultSink
+{
+    public:
+        ContingencyFileSink(const std::string & path):
+            _path(path),
+            _nb_bus(0),
+            _nb_branch(0),
+            _with_flows(false) {}
+
+        virtual void start(Eigen::Index nb_bus, Eigen::Index nb_branch, bool with_flows);
+        virtual void push(Eigen::Index cont_id,
+                          bool converged,
+                          Eigen::Ref<const CplxVect> V,
+                          Eigen::Ref<const RealVect> amps_flows);
+        virtual void finish();
+
+        const std::string & path() const {return _path;}
+        // size (in bytes) of one record with the settings of the last computation
+        std::size_t record_size() const;
+
+    private:
+        std::string _path;
+        std::ofstream _file;
+        Eigen::Index _nb_bus;
+        Eigen::Index _nb_branch;
+        bool _with_flows;
+};
+
+#endif  // CONTINGENCYRESULTSINK_H
@@ -9,6 +9,11 @@
 #include "TimeSeries.h"
 #include <iostream>
 #include <sstream>
+#include <memory>
+#include <exception>
+#include <algorithm>
+#include <numeric>
+#include <map>
 
 int TimeSeries::compute_Vs(Eigen::Ref<const RealMat> gen_p,
                            Eigen::Ref<const RealMat> sgen_p,
@@ -74,45 +79,612 @@ int TimeSeries::compute_Vs(Eigen::Ref<const RealMat> gen_p,
     // init the results matrices
     _voltages = BaseBatchSolverSynch::CplxMat::Zero(nb_steps, nb_total_bus); 
     _amps_flows = RealMat::Zero(0, n_total_);
+    _steps_status = IntVect::Constant(nb_steps, -1);
+    _steps_nb_iter = IntVect::Zero(nb_steps);
+    _steps_error = IntVect::Constant(nb_steps, static_cast<int>(ErrorType::NoError));
 
     // extract V solver from the given V
     CplxVect Vinit_solver = extract_Vsolver_from_Vinit(Vinit, nb_buses_solver, nb_total_bus, id_me_to_solver);
+    // set the "right" init vector
+    _grid_model.get_generators().set_vm(Vinit_solver, id_me_to_solver);
+
+    // the steps are split in contiguous chunks, one per worker
+    const Eigen::Index nb_worker = std::max(static_cast<Eigen::Index>(1), 
+                                            std::min(static_cast<Eigen::Index>(_nb_thread), nb_steps));
+    std::vector<Eigen::Index> chunk_begin(nb_worker + 1);
+    for(Eigen::Index worker_id = 0; worker_id <= nb_worker; ++worker_id) chunk_begin[worker_id] = (nb_steps * worker_id) / nb_worker;
+
+    // the chunks (except the first one) and the steps following a divergence start from a DC powerflow
+    Eigen::SparseMatrix<cplx_type> dcYbus;
+    if((nb_worker > 1 || _continue_on_divergence) && ac_solver_used && same_ac_dc_buses()) dcYbus = _grid_model.get_dcYbus_solver();
+    const Eigen::VectorXi dc_slack_ids = _grid_model.get_slack_ids_dc_solver();
     _timer_pre_proc = timer_preproc.duration();
 
-    // compute the powerflows
-    // set the "right" init vector
-    CplxVect V = Vinit_solver;
-    _grid_model.get_generators().set_vm(V, id_me_to_solver);
+    const real_type tol_ = tol / sn_mva; 
+    _topo_flow_data.clear();
+    _steps_topology = IntVect::Zero(nb_steps);
+    _nb_topologies = nb_steps > 0 ? 1 : 0;
+    std::vector<Eigen::Index> all_steps(nb_steps);
+    std::iota(all_steps.begin(), all_steps.end(), 0);
+    if(!_topo_events.empty()){
+        compute_topo_steps(Vinit, max_iter, tol_);
+    }else if(!ac_solver_used){
+        // the DC powerflow is linear and the (dc) Ybus is the same at all steps: it is factorized once
+        // and all the steps are solved together (nb_thread is not used)
+        compute_dc_steps(Ybus, Vinit_solver, _Sbuses, all_steps, slack_ids, slack_weights, bus_pv, bus_pq, id_solver_to_me);
+    }else if(nb_worker == 1){
+        CplxVect V = Vinit_solver;
+        compute_chunk(_solver, _solver_control, Ybus, V, _Sbuses, all_steps,
+                      slack_ids, slack_weights, bus_pv, bus_pq, id_solver_to_me,
+                      Vinit_solver, dcYbus, dc_slack_ids,
+                      max_iter, tol_, 0, nb_steps,
+                      _nb_solved, _timer_solver);
+    }else{
+        // each worker has its own solver and solver control (the grid model and Ybus are only read)
+        // the worker 0 is the calling thread and reuses _solver
+        std::vector<std::unique_ptr<ChooseSolver> > solvers(nb_worker);
+        std::vector<SolverControl> solver_controls(nb_worker);
+        std::vector<int> nb_solveds(nb_worker, 0);
+        std::vector<double> timer_solvers(nb_worker, 0.);
+        std::vector<std::exception_ptr> errors(nb_worker, nullptr);
+
+        auto run_worker = [&](Eigen::Index worker_id){
+            try{
+                ChooseSolver & solver = worker_id == 0 ? _solver : *solvers[worker_id];
+                SolverControl & solver_control = worker_id == 0 ? _solver_control : solver_controls[worker_id];
+                CplxVect V = Vinit_solver;
+                if(worker_id != 0){
+                    solver.change_solver(_solver.get_type());
+                    solver.set_jacobian_reuse(_solver.get_refactor_every(), _solver.get_refactor_ratio());
+                    solver.set_gridmodel(&_grid_model);
+                    solver.reset();
+                    solver_control.tell_none_changed();
+                    solver_control.tell_recompute_sbus();
+                    if(ac_solver_used) V = dc_init_chunk(dcYbus, Vinit_solver, _Sbuses.row(chunk_begin[worker_id]),
+                                                         dc_slack_ids, slack_weights, bus_pv, bus_pq,
+                                                         timer_solvers[worker_id]);
+                }
+                compute_chunk(solver, solver_control, Ybus, V, _Sbuses, all_steps,
+                              slack_ids, slack_weights, bus_pv, bus_pq, id_solver_to_me,
+                              Vinit_solver, dcYbus, dc_slack_ids,
+                              max_iter, tol_, chunk_begin[worker_id], chunk_begin[worker_id + 1],
+                              nb_solveds[worker_id], timer_solvers[worker_id]);
+            }catch(...){
+                errors[worker_id] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(nb_worker - 1);
+        for(Eigen::Index worker_id = 1; worker_id < nb_worker; ++worker_id){
+            solvers[worker_id] = std::unique_ptr<ChooseSolver>(new ChooseSolver());
+            threads.emplace_back(run_worker, worker_id);
+        }
+        run_worker(0);
+        for(auto & thread : threads) thread.join();
+
+        for(Eigen::Index worker_id = 0; worker_id < nb_worker; ++worker_id){
+            if(errors[worker_id]) std::rethrow_exception(errors[worker_id]);
+            // timers are summed over all the workers
+            _nb_solved += nb_solveds[worker_id];
+            _timer_solver += timer_solvers[worker_id];
+        }
+    }
+
+    // it is succesfull only if all the steps converged
+    _status = (_steps_status.array() == 1).all() ? 1 : 0;
+    _timer_total = timer.duration();
+    return _status;
+}
 
+void TimeSeries::compute_chunk(ChooseSolver & solver,
+                               SolverControl & solver_control,
+                               const Eigen::SparseMatrix<cplx_type> & Ybus,
+                               CplxVect & V,
+                               const CplxMat & Sbuses,
+                               const std::vector<Eigen::Index> & steps,
+                               const Eigen::VectorXi & slack_ids,
+                               const RealVect & slack_weights,
+                               const Eigen::VectorXi & bus_pv,
+                               const Eigen::VectorXi & bus_pq,
+                               const std::vector<int> & id_solver_to_me,
+                               const CplxVect & Vinit_solver,
+                               const Eigen::SparseMatrix<cplx_type> & dcYbus,
+                               const Eigen::VectorXi & dc_slack_ids,
+                               int max_iter,
+                               real_type tol,
+                               Eigen::Index first_step,
+                               Eigen::Index last_step,
+                               int & nb_solved,
+                               double & timer_solver)
+{
     bool conv;
-    Eigen::Index step_diverge = -1;
-    const real_type tol_ = tol / sn_mva; 
-    // do the computation for each step
-    for(Eigen::Index i = 0; i < nb_steps; ++i){
-        conv = false;
-        conv = compute_one_powerflow(Ybus,
-                                     V, 
-                                     _Sbuses.row(i),
-                                     slack_ids,
-                                     slack_weights,
-                                     bus_pv,
-                                     bus_pq,
-                                     max_iter,
-                                     tol_);
+    // previous solutions, kept only for the extrapolations
+    const bool keep_history = _predictor == PredictorType::Linear || _predictor == PredictorType::Quadratic;
+    CplxVect V_last, V_prev, V_prev2;
+    int nb_history = 0;  // number of consecutive steps solved just before the current one
+    for(Eigen::Index k = first_step; k < last_step; ++k){
+        const Eigen::Index step = steps[k];
+        if(nb_history > 0 && _predictor != PredictorType::NoPredictor){
+            // the extrapolations are only made between consecutive steps
+            const int nb_consecutive = step == steps[k - 1] + 1 ? nb_history : 1;
+            predict_V(solver, Ybus, V, V_prev, V_prev2, nb_consecutive, Sbuses.row(k),
+                      slack_ids, slack_weights, bus_pv, bus_pq, timer_solver);
+        }
+        solver.tell_solver_control(solver_control);
+        conv = solver.compute_pf(Ybus, V, Sbuses.row(k), slack_ids, slack_weights, bus_pv, bus_pq, max_iter, tol);
+        ++nb_solved;
+        timer_solver += solver.get_computation_time();
+        _steps_nb_iter(step) = solver.get_nb_iter();
         if(!conv){
-            _timer_total = timer.duration();
-            return _status;
+            _steps_status(step) = 0;
+            _steps_error(step) = static_cast<int>(solver.get_error());
+            nb_history = 0;
+            if(!_continue_on_divergence) return;
+            // the next step does not start from the diverged voltages, and the solver
+            // (which might hold a failed factorization) starts from scratch
+            if(k + 1 < last_step) V = dc_init_chunk(dcYbus, Vinit_solver, Sbuses.row(k + 1), 
+                                                    dc_slack_ids, slack_weights, bus_pv, bus_pq, timer_solver);
+            solver.reset();
+            solver_control.tell_none_changed();
+            solver_control.tell_recompute_sbus();
+            continue;
+        }
+        nb_history = (nb_history > 0 && step == steps[k - 1] + 1) ? std::min(nb_history + 1, 3) : 1;
+        if(keep_history){
+            V_prev2.swap(V_prev);
+            V_prev.swap(V_last);
+            V_last = solver.get_V();
         }
-        if(conv && step_diverge < 0) _voltages.row(i)(id_solver_to_me) = V.array();
-        else step_diverge = i;
+        // each worker writes different rows of the results
+        V = solver.get_V().array();
+        _voltages.row(step)(id_solver_to_me) = V.array();
+        _steps_status(step) = 1;
     }
-    if(step_diverge > 0){
-        _status = 0;
+}
+
+void TimeSeries::predict_V(ChooseSolver & solver,
+                           const Eigen::SparseMatrix<cplx_type> & Ybus,
+                           CplxVect & V,
+                           const CplxVect & V_prev,
+                           const CplxVect & V_prev2,
+                           int nb_history,
+                           const CplxVect & Sbus,
+                           const Eigen::VectorXi & slack_ids,
+                           const RealVect & slack_weights,
+                           const Eigen::VectorXi & bus_pv,
+                           const Eigen::VectorXi & bus_pq,
+                           double & timer_solver) const
+{
+    auto timer = CustTimer();
+    if(_predictor == PredictorType::Jacobian){
+        // V is not modified if the solver cannot do it
+        solver.predict_V(Ybus, V, Sbus, slack_ids, slack_weights, bus_pv, bus_pq);
+    }else if(nb_history >= 2){
+        // magnitudes and angles are extrapolated separately, the angle differences are computed
+        // with V * conj(V_prev) so that they do not wrap around
+        const bool quadratic = _predictor == PredictorType::Quadratic && nb_history >= 3;
+        for(Eigen::Index bus_id = 0; bus_id < V.size(); ++bus_id){
+            const real_type Vm = std::abs(V(bus_id));
+            real_type dVm = Vm - std::abs(V_prev(bus_id));
+            real_type dVa = std::arg(V(bus_id) * std::conj(V_prev(bus_id)));
+            if(quadratic){
+                dVm = 2. * dVm - (std::abs(V_prev(bus_id)) - std::abs(V_prev2(bus_id)));
+                dVa = 2. * dVa - std::arg(V_prev(bus_id) * std::conj(V_prev2(bus_id)));
+            }
+            if(Vm + dVm <= 0.) continue;  // extrapolation went too far, this bus is not modified
+            V(bus_id) = std::polar(Vm + dVm, std::arg(V(bus_id)) + dVa);
+        }
+    }
+    timer_solver += timer.duration();
+}
+
+CplxVect TimeSeries::dc_init_chunk(const Eigen::SparseMatrix<cplx_type> & dcYbus,
+                                   const CplxVect & Vinit_solver,
+                                   const CplxVect & Sbus,
+                                   const Eigen::VectorXi & slack_ids,
+                                   const RealVect & slack_weights,
+                                   const Eigen::VectorXi & bus_pv,
+                                   const Eigen::VectorXi & bus_pq,
+                                   double & timer_solver)
+{
+    // no DC powerflow if the buses are not labelled the same way in AC and DC (see same_ac_dc_buses)
+    if(dcYbus.cols() != Vinit_solver.size()) return Vinit_solver;
+
+    ChooseSolver dc_solver;
+    SolverControl dc_solver_control;
+    dc_solver.change_solver(_grid_model.get_dc_solver_type());
+    dc_solver.set_gridmodel(&_grid_model);
+    dc_solver_control.tell_all_changed();
+    dc_solver.tell_solver_control(dc_solver_control);
+    CplxVect V = Vinit_solver;
+    const bool conv = dc_solver.compute_pf(dcYbus, V, Sbus, slack_ids, slack_weights, bus_pv, bus_pq, 10, 1e-8);
+    timer_solver += dc_solver.get_computation_time();
+    // if the DC powerflow diverged, I start from Vinit (as for the first chunk)
+    if(!conv) return Vinit_solver;
+
+    const RealVect & Va = dc_solver.get_Va();
+    const RealVect Vm = Vinit_solver.array().abs();
+    CplxVect res(Vinit_solver.size());
+    for(Eigen::Index bus_id = 0; bus_id < res.size(); ++bus_id) res(bus_id) = std::polar(Vm(bus_id), Va(bus_id));
+    return res;
+}
+
+void TimeSeries::compute_dc_steps(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                                  const CplxVect & Vinit_solver,
+                                  const CplxMat & Sbuses,
+                                  const std::vector<Eigen::Index> & steps,
+                                  const Eigen::VectorXi & slack_ids,
+                                  const RealVect & slack_weights,
+                                  const Eigen::VectorXi & bus_pv,
+                                  const Eigen::VectorXi & bus_pq,
+                                  const std::vector<int> & id_solver_to_me)
+{
+    // steps are solved by blocks, to keep the memory used by the right hand sides bounded
+    const Eigen::Index nb_steps_per_block = 1024;
+    const Eigen::Index nb_steps = Sbuses.rows();
+    const Eigen::Index nb_buses_solver = Sbuses.cols();
+    // the magnitudes are the same at all steps (DC approximation)
+    const RealVect Vm = Vinit_solver.array().abs();
+    ::RealMat Sbuses_block;  // one column per step
+    ::RealMat Va;
+    for(Eigen::Index first_step = 0; first_step < nb_steps; first_step += nb_steps_per_block){
+        const Eigen::Index nb_steps_block = std::min(nb_steps_per_block, nb_steps - first_step);
+        Sbuses_block = Sbuses.middleRows(first_step, nb_steps_block).real().transpose();
+        _solver.tell_solver_control(_solver_control);
+        const bool conv = _solver.compute_pf_multi(Ybus, Vinit_solver, Sbuses_block, slack_ids, slack_weights, bus_pv, bus_pq, Va);
+        _nb_solved += static_cast<int>(nb_steps_block);
+        _timer_solver += _solver.get_computation_time();
+        // Ybus is now factorized, it is reused for the next blocks
+        _solver_control.tell_none_changed();
+        _solver_control.tell_recompute_sbus();
+        if(!conv){
+            // the linear solver failed, no step of this block converged
+            for(Eigen::Index i = 0; i < nb_steps_block; ++i){
+                _steps_status(steps[first_step + i]) = 0;
+                _steps_error(steps[first_step + i]) = static_cast<int>(_solver.get_error());
+            }
+            continue;
+        }
+        for(Eigen::Index i = 0; i < nb_steps_block; ++i){
+            const Eigen::Index step = steps[first_step + i];
+            const auto Va_step = Va.col(i);
+            _steps_nb_iter(step) = 1;
+            if(!Va_step.array().allFinite()){
+                _steps_status(step) = 0;
+                _steps_error(step) = static_cast<int>(ErrorType::InifiniteValue);
+                continue;
+            }
+            auto V_step = _voltages.row(step);
+            for(Eigen::Index bus_id = 0; bus_id < nb_buses_solver; ++bus_id){
+                V_step(id_solver_to_me[bus_id]) = std::polar(Vm(bus_id), Va_step(bus_id));
+            }
+            _steps_status(step) = 1;
+        }
+    }
+}
+
+void TimeSeries::add_branch_status_event(int step, int branch_id, bool connected)
+{
+    if(step < 0 || branch_id < 0 || branch_id >= n_total_){
+        std::ostringstream exc_;
+        exc_ << "TimeSeries::add_branch_status_event: invalid event (step " << step << ", branch " << branch_id << "). ";
+        exc_ << "The step should be >= 0 and the branch id between 0 and " << n_total_ - 1;
+        exc_ << " (powerlines then trafos).";
+        throw std::runtime_error(exc_.str());
+    }
+    _topo_events.push_back({step, branch_id, -1, connected ? 1 : 0});
+}
+
+void TimeSeries::add_branch_bus_event(int step, int branch_id, int side, int new_bus_id)
+{
+    if(step < 0 || branch_id < 0 || branch_id >= n_total_ || (side != 0 && side != 1) ||
+       new_bus_id < 0 || new_bus_id >= _grid_model.total_bus()){
+        std::ostringstream exc_;
+        exc_ << "TimeSeries::add_branch_bus_event: invalid event (step " << step << ", branch " << branch_id;
+        exc_ << ", side " << side << ", bus " << new_bus_id << "). ";
+        exc_ << "The step should be >= 0, the branch id between 0 and " << n_total_ - 1;
+        exc_ << " (powerlines then trafos), the side 0 or 1 and the bus id between 0 and " << _grid_model.total_bus() - 1 << ".";
+        throw std::runtime_error(exc_.str());
+    }
+    _topo_events.push_back({step, branch_id, side, new_bus_id});
+}
+
+bool TimeSeries::get_branch_status(int branch_id) const
+{
+    if(branch_id < n_line_) return _grid_model.get_powerlines_as_data().get_status()[branch_id];
+    return _grid_model.get_trafos_as_data().get_status()[branch_id - n_line_];
+}
+
+int TimeSeries::get_branch_bus(int branch_id, int side) const
+{
+    if(branch_id < n_line_){
+        const auto & powerlines = _grid_model.get_powerlines_as_data();
+        return side == 0 ? powerlines.get_bus_from()(branch_id) : powerlines.get_bus_to()(branch_id);
+    }
+    const auto & trafos = _grid_model.get_trafos_as_data();
+    const int trafo_id = branch_id - static_cast<int>(n_line_);
+    return side == 0 ? trafos.get_bus_from()(trafo_id) : trafos.get_bus_to()(trafo_id);
+}
+
+void TimeSeries::set_branch_status(int branch_id, bool connected)
+{
+    if(branch_id < n_line_){
+        if(connected) _grid_model.reactivate_powerline(branch_id);
+        else _grid_model.deactivate_powerline(branch_id);
     }else{
-        // If i reached there, it means it is succesfull
-        _status = 1;
+        const int trafo_id = branch_id - static_cast<int>(n_line_);
+        if(connected) _grid_model.reactivate_trafo(trafo_id);
+        else _grid_model.deactivate_trafo(trafo_id);
     }
-    
-    _timer_total = timer.duration();
-    return _status;
+}
+
+void TimeSeries::set_branch_bus(int branch_id, int side, int new_bus_id)
+{
+    if(!_grid_model.get_bus_status()[new_bus_id]) _grid_model.reactivate_bus(new_bus_id);
+    if(branch_id < n_line_){
+        if(side == 0) _grid_model.change_bus_powerline_or(branch_id, new_bus_id);
+        else _grid_model.change_bus_powerline_ex(branch_id, new_bus_id);
+    }else{
+        const int trafo_id = branch_id - static_cast<int>(n_line_);
+        if(side == 0) _grid_model.change_bus_trafo_hv(trafo_id, new_bus_id);
+        else _grid_model.change_bus_trafo_lv(trafo_id, new_bus_id);
+    }
+}
+
+void TimeSeries::compute_topo_steps(const CplxVect & Vinit, int max_iter, real_type tol)
+{
+    auto timer_preproc = CustTimer();
+    const Eigen::Index nb_steps = _Sbuses.rows();
+    const Eigen::Index nb_total_bus = _grid_model.total_bus();
+    const bool ac_solver_used = _solver.ac_solver_used();
+
+    // events are applied in the order of the steps (and in the order they were added for the same step)
+    std::vector<TopoEvent> events = _topo_events;
+    std::stable_sort(events.begin(), events.end(), [](const TopoEvent & a, const TopoEvent & b){return a.step < b.step;});
+    if(events.back().step >= nb_steps){
+        std::ostringstream exc_;
+        exc_ << "TimeSeries::compute_Vs: a topology event is set at step " << events.back().step;
+        exc_ << " but there are only " << nb_steps << " steps.";
+        throw std::runtime_error(exc_.str());
+    }
+
+    // branches concerned by the events, and their topology in the grid model
+    std::vector<int> status_branches, bus_branches;
+    for(const auto & event : events) (event.side == -1 ? status_branches : bus_branches).push_back(event.branch_id);
+    for(auto * branches : {&status_branches, &bus_branches}){
+        std::sort(branches->begin(), branches->end());
+        branches->erase(std::unique(branches->begin(), branches->end()), branches->end());
+    }
+    auto index_of = [](const std::vector<int> & branches, int branch_id){
+        return std::lower_bound(branches.begin(), branches.end(), branch_id) - branches.begin();
+    };
+    std::vector<int> init_status(status_branches.size());
+    std::vector<int> init_buses(2 * bus_branches.size());
+    for(std::size_t i = 0; i < status_branches.size(); ++i) init_status[i] = get_branch_status(status_branches[i]) ? 1 : 0;
+    for(std::size_t i = 0; i < bus_branches.size(); ++i){
+        init_buses[2 * i] = get_branch_bus(bus_branches[i], 0);
+        init_buses[2 * i + 1] = get_branch_bus(bus_branches[i], 1);
+    }
+
+    // topology of each step: the steps are grouped by bus assignment of the branches ("configuration")
+    // then by status of the branches ("topology")
+    std::map<std::vector<int>, int> config_ids;
+    std::vector<std::vector<int> > config_buses;
+    std::vector<std::vector<int> > config_topos;
+    std::map<std::pair<int, std::vector<int> >, int> topo_ids;
+    std::vector<std::vector<int> > topo_status;
+    std::vector<std::vector<Eigen::Index> > topo_steps;
+    std::vector<int> status = init_status;
+    std::vector<int> buses = init_buses;
+    std::size_t event_id = 0;
+    int topo_id = 0;
+    for(Eigen::Index step = 0; step < nb_steps; ++step){
+        bool changed = step == 0;
+        for(; event_id < events.size() && events[event_id].step == step; ++event_id){
+            const auto & event = events[event_id];
+            if(event.side == -1) status[index_of(status_branches, event.branch_id)] = event.value;
+            else buses[2 * index_of(bus_branches, event.branch_id) + event.side] = event.value;
+            changed = true;
+        }
+        if(changed){
+            const auto config_it = config_ids.emplace(buses, static_cast<int>(config_buses.size()));
+            if(config_it.second){
+                config_buses.push_back(buses);
+                config_topos.emplace_back();
+            }
+            const int config_id = config_it.first->second;
+            const auto topo_it = topo_ids.emplace(std::make_pair(config_id, status), static_cast<int>(topo_status.size()));
+            if(topo_it.second){
+                topo_status.push_back(status);
+                topo_steps.emplace_back();
+                config_topos[config_id].push_back(topo_it.first->second);
+            }
+            topo_id = topo_it.first->second;
+        }
+        _steps_topology(step) = topo_id;
+        topo_steps[topo_id].push_back(step);
+    }
+    _nb_topologies = static_cast<int>(topo_status.size());
+
+    // buses that the events can leave without any element
+    std::vector<int> event_buses = init_buses;
+    for(const auto & this_config_buses : config_buses) event_buses.insert(event_buses.end(), this_config_buses.begin(), this_config_buses.end());
+    std::sort(event_buses.begin(), event_buses.end());
+    event_buses.erase(std::unique(event_buses.begin(), event_buses.end()), event_buses.end());
+    _topo_flow_data.assign(topo_status.size(), BranchFlowData());
+
+    // _Sbuses are labelled with the solver buses of the initial topology
+    const std::vector<int> init_solver_to_me = ac_solver_used ? _grid_model.id_ac_solver_to_me() : _grid_model.id_dc_solver_to_me();
+    const std::vector<bool> init_bus_status = _grid_model.get_bus_status();
+    _timer_pre_proc += timer_preproc.duration();
+
+    auto restore_grid_model = [&](){
+        for(std::size_t i = 0; i < status_branches.size(); ++i) set_branch_status(status_branches[i], init_status[i] == 1);
+        for(std::size_t i = 0; i < bus_branches.size(); ++i){
+            set_branch_bus(bus_branches[i], 0, init_buses[2 * i]);
+            set_branch_bus(bus_branches[i], 1, init_buses[2 * i + 1]);
+        }
+        for(Eigen::Index bus_id = 0; bus_id < nb_total_bus; ++bus_id){
+            if(!init_bus_status[bus_id]) _grid_model.deactivate_bus(static_cast<int>(bus_id));
+            else _grid_model.reactivate_bus(static_cast<int>(bus_id));
+        }
+        prepare_grid_model();
+    };
+
+    try{
+        Eigen::SparseMatrix<cplx_type> Ybus_config, Ybus, dcYbus_config, dcYbus;
+        CplxMat Sbuses;
+        for(std::size_t config_id = 0; config_id < config_buses.size(); ++config_id){
+            timer_preproc = CustTimer();
+            const auto & this_config_topos = config_topos[config_id];
+            // the grid model is set with the union of the topologies of this configuration
+            for(std::size_t i = 0; i < bus_branches.size(); ++i){
+                set_branch_bus(bus_branches[i], 0, config_buses[config_id][2 * i]);
+                set_branch_bus(bus_branches[i], 1, config_buses[config_id][2 * i + 1]);
+            }
+            for(std::size_t i = 0; i < status_branches.size(); ++i){
+                bool connected = false;
+                for(auto this_topo_id : this_config_topos) connected = connected || (topo_status[this_topo_id][i] == 1);
+                set_branch_status(status_branches[i], connected);
+            }
+            // a bus left empty by the events would make Ybus singular
+            _grid_model.deactivate_buses_without_element(event_buses);
+            prepare_grid_model();
+
+            Ybus_config = ac_solver_used ? _grid_model.get_Ybus_solver() : _grid_model.get_dcYbus_solver();
+            Ybus_config.makeCompressed();
+            Ybus = Ybus_config;
+            // the steps following a divergence start from a DC powerflow
+            dcYbus_config = Eigen::SparseMatrix<cplx_type>();
+            dcYbus = dcYbus_config;
+            if(ac_solver_used && _continue_on_divergence && same_ac_dc_buses()){
+                dcYbus_config = _grid_model.get_dcYbus_solver();
+                dcYbus_config.makeCompressed();
+                dcYbus = dcYbus_config;
+            }
+            const Eigen::VectorXi dc_slack_ids = _grid_model.get_slack_ids_dc_solver();
+            const Eigen::Index nb_buses_solver = Ybus.cols();
+            const auto & id_me_to_solver = ac_solver_used ? _grid_model.id_me_to_ac_solver() :  _grid_model.id_me_to_dc_solver();
+            const auto & id_solver_to_me = ac_solver_used ? _grid_model.id_ac_solver_to_me() : _grid_model.id_dc_solver_to_me();
+            const Eigen::VectorXi bus_pv = _grid_model.get_pv_solver();
+            const Eigen::VectorXi bus_pq = _grid_model.get_pq_solver();
+            const Eigen::VectorXi slack_ids = ac_solver_used ? _grid_model.get_slack_ids_solver(): _grid_model.get_slack_ids_dc_solver();
+            const RealVect slack_weights = _grid_model.get_slack_weights_solver();
+            CplxVect Vinit_solver = extract_Vsolver_from_Vinit(Vinit, nb_buses_solver, nb_total_bus, id_me_to_solver);
+            // the buses activated by the events have no initial voltage
+            for(Eigen::Index bus_id = 0; bus_id < nb_total_bus; ++bus_id){
+                const int solver_id = id_me_to_solver[bus_id];
+                if(init_bus_status[bus_id] || solver_id == GridModel::_deactivated_bus_id) continue;
+                if(std::abs(Vinit_solver(solver_id)) == 0.) Vinit_solver(solver_id) = {_grid_model.get_init_vm_pu(), 0.};
+            }
+            _grid_model.get_generators().set_vm(Vinit_solver, id_me_to_solver);
+
+            // the buses of the initial topology deactivated by the events (-1) have no element, hence no injection
+            std::vector<int> init_to_config(init_solver_to_me.size());
+            for(std::size_t bus_id = 0; bus_id < init_solver_to_me.size(); ++bus_id) init_to_config[bus_id] = id_me_to_solver[init_solver_to_me[bus_id]];
+
+            BranchFlowData flow_data_config;
+            add_branch_flow_data(_grid_model.get_powerlines_as_data(), 0, false, flow_data_config);
+            add_branch_flow_data(_grid_model.get_trafos_as_data(), n_line_, true, flow_data_config);
+
+            // new sparsity pattern: everything is computed again
+            _solver.reset();
+            _solver_control.tell_none_changed();
+            _solver_control.tell_recompute_sbus();
+            _timer_pre_proc += timer_preproc.duration();
+
+            for(auto this_topo_id : this_config_topos){
+                timer_preproc = CustTimer();
+                // the branches disconnected in this topology are removed from Ybus (same sparsity pattern)
+                std::vector<int> removed;
+                for(std::size_t i = 0; i < status_branches.size(); ++i){
+                    if(topo_status[this_topo_id][i] == 0 && get_branch_status(status_branches[i])) removed.push_back(status_branches[i]);
+                }
+                const std::vector<Coeff> coeffs = branch_ybus_coeffs(removed, ac_solver_used);
+                const std::vector<Eigen::Index> coeffs_pos = ybus_coeffs_pos(Ybus, coeffs);
+                std::copy(Ybus_config.valuePtr(), Ybus_config.valuePtr() + Ybus_config.nonZeros(), Ybus.valuePtr());
+                cplx_type * values = Ybus.valuePtr();
+                for(std::size_t i = 0; i < coeffs.size(); ++i) values[coeffs_pos[i]] -= coeffs[i].value;
+                // the DC solver needs to factorize it again, the AC solver cannot reuse the factorization of the jacobian
+                if(!ac_solver_used) _solver_control.tell_recompute_ybus();
+                else if(_solver.get_refactor_every() > 1) _solver.tell_ybus_values_changed();
+                if(dcYbus.nonZeros() > 0){
+                    const std::vector<Coeff> dc_coeffs = branch_ybus_coeffs(removed, false);
+                    const std::vector<Eigen::Index> dc_coeffs_pos = ybus_coeffs_pos(dcYbus, dc_coeffs);
+                    std::copy(dcYbus_config.valuePtr(), dcYbus_config.valuePtr() + dcYbus_config.nonZeros(), dcYbus.valuePtr());
+                    cplx_type * dc_values = dcYbus.valuePtr();
+                    for(std::size_t i = 0; i < dc_coeffs.size(); ++i) dc_values[dc_coeffs_pos[i]] -= dc_coeffs[i].value;
+                }
+
+                std::vector<Eigen::Index> kept;
+                kept.reserve(flow_data_config.col_id.size());
+                for(Eigen::Index el = 0; el < flow_data_config.col_id.size(); ++el){
+                    if(!std::binary_search(removed.begin(), removed.end(), flow_data_config.col_id(el))) kept.push_back(el);
+                }
+                BranchFlowData & flow_data = _topo_flow_data[this_topo_id];
+                flow_data.bus_from = flow_data_config.bus_from(kept);
+                flow_data.bus_to = flow_data_config.bus_to(kept);
+                flow_data.col_id = flow_data_config.col_id(kept);
+                flow_data.y_ff = flow_data_config.y_ff(kept);
+                flow_data.y_ft = flow_data_config.y_ft(kept);
+                flow_data.y_tt = flow_data_config.y_tt(kept);
+                flow_data.y_tf = flow_data_config.y_tf(kept);
+                flow_data.vn_kv_from = flow_data_config.vn_kv_from(kept);
+                flow_data.vn_kv_to = flow_data_config.vn_kv_to(kept);
+                flow_data.dc_shift = flow_data_config.dc_shift(kept);
+
+                // injections of the steps of this topology, with the buses of this configuration
+                const auto & steps = topo_steps[this_topo_id];
+                const Eigen::Index nb_steps_topo = static_cast<Eigen::Index>(steps.size());
+                Sbuses = CplxMat::Zero(nb_steps_topo, nb_buses_solver);
+                for(Eigen::Index k = 0; k < nb_steps_topo; ++k){
+                    const auto Sbus_step = _Sbuses.row(steps[k]);
+                    auto Sbus_topo = Sbuses.row(k);
+                    for(std::size_t bus_id = 0; bus_id < init_to_config.size(); ++bus_id){
+                        if(init_to_config[bus_id] == GridModel::_deactivated_bus_id) continue;
+                        Sbus_topo(init_to_config[bus_id]) = Sbus_step(bus_id);
+                    }
+                }
+                _timer_pre_proc += timer_preproc.duration();
+
+                if(ac_solver_used){
+                    CplxVect V = Vinit_solver;
+                    compute_chunk(_solver, _solver_control, Ybus, V, Sbuses, steps,
+                                  slack_ids, slack_weights, bus_pv, bus_pq, id_solver_to_me,
+                                  Vinit_solver, dcYbus, dc_slack_ids,
+                                  max_iter, tol, 0, nb_steps_topo,
+                                  _nb_solved, _timer_solver);
+                }else{
+                    compute_dc_steps(Ybus, Vinit_solver, Sbuses, steps, slack_ids, slack_weights, bus_pv, bus_pq, id_solver_to_me);
+                }
+            }
+        }
+    }catch(...){
+        restore_grid_model();
+        throw;
+    }
+    timer_preproc = CustTimer();
+    restore_grid_model();
+    _timer_pre_proc += timer_preproc.duration();
+}
+
+void TimeSeries::compute_topo_flows(bool amps)
+{
+    if (_voltages.size() == 0)
+    {
+        std::ostringstream exc_;
+        exc_ << "TimeSeries::compute_topo_flows: cannot compute the flows as the voltages are not set. Have you called compute_Vs(...) ? ";
+        throw std::runtime_error(exc_.str());
+    }
+    auto timer_compute = CustTimer();
+    const Eigen::Index nb_steps = _voltages.rows();
+    RealMat & flows = amps ? _amps_flows : _active_power_flows;
+    flows = RealMat::Zero(nb_steps, n_total_);
+    BranchFlowBuffers buffers;
+    for(Eigen::Index step = 0; step < nb_steps; ++step){
+        compute_branch_flows(_topo_flow_data[_steps_topology(step)], amps, _grid_model.get_sn_mva(), _voltages, flows, step, step + 1, buffers);
+    }
+    if (amps) _timer_compute_A = timer_compute.duration();
+    else _timer_compute_P = timer_compute.duration();
 }
@@ -9,8 +9,17 @@
 #ifndef COMPUTERS_H
 #define COMPUTERS_H
 
+#include <thread>
+#include <vector>
+
 #include "BaseBatchSolverSynch.h"
 
+// how the initial voltages of a step are guessed from the steps already solved (AC solvers only)
+enum class PredictorType {NoPredictor,  // solution of the previous step
+                          Linear,  // linear extrapolation (magnitudes and angles) of the 2 previous steps
+                          Quadratic,  // quadratic extrapolation of the 3 previous steps
+                          Jacobian};  // one newton step using the last factorized jacobian (Newton Raphson solvers only)
+
 /**
 Allws the computation of time series, that is, the same grid topology is used along with time
 series of injections (productions and loads) to compute powerflows/
@@ -22,7 +31,17 @@ class TimeSeries: public BaseBatchSolverSynch
             BaseBatchSolverSynch(init_grid_model),
             _Sbuses(),
             _status(1), // 1: success, 0: failure
+            _steps_status(),
+            _steps_nb_iter(),
+            _steps_error(),
+            _topo_events(),
+            _steps_topology(),
+            _nb_topologies(0),
+            _topo_flow_data(),
             _compute_flows(true),
+            _continue_on_divergence(false),
+            _predictor(PredictorType::NoPredictor),
+            _nb_thread(1),
             _timer_total(0.) ,
             _timer_pre_proc(0.)
             {}
@@ -39,6 +58,52 @@ class TimeSeries: public BaseBatchSolverSynch
 
         // status
         int get_status() const {return _status;}
+        // status of each step (1: converged, 0: diverged, -1: not computed)
+        const IntVect & get_steps_status() const {return _steps_status;}
+        // number of iterations of the solver at each step (0 if not computed)
+        const IntVect & get_steps_nb_iter() const {return _steps_nb_iter;}
+        // error of the solver at each step (see ErrorType, NoError if not computed)
+        const IntVect & get_steps_error() const {return _steps_error;}
+        // total number of iterations of the solver (all steps)
+        int total_nb_iter() const {return _steps_nb_iter.sum();}
+
+        // initial voltages of each step (see PredictorType), the extrapolations only use the steps just before
+        // that converged (with the same topology), otherwise the solution of the previous step is used
+        void set_predictor(PredictorType predictor) {_predictor = predictor;}
+        PredictorType get_predictor() const {return _predictor;}
+
+        // if true, the computation goes on after a step diverged: the following step starts from Vinit
+        // (with the angles of a DC powerflow, for AC solvers) instead of the voltages of the previous step.
+        // Otherwise (default) the computation stops at the first step that diverges.
+        void set_continue_on_divergence(bool continue_on_divergence) {_continue_on_divergence = continue_on_divergence;}
+        bool get_continue_on_divergence() const {return _continue_on_divergence;}
+
+        // parallel computation: the steps are split in "nb_thread" contiguous chunks, each
+        // solved by its own solver (the voltages are propagated from one step to the next inside a chunk)
+        void set_nb_thread(int nb_thread){
+            if(nb_thread < 1){
+                std::ostringstream exc_;
+                exc_ << "TimeSeries::set_nb_thread: the number of threads should be >= 1, ";
+                exc_ << "you provided " << nb_thread << ".";
+                throw std::runtime_error(exc_.str());
+            }
+            _nb_thread = nb_thread;
+        }
+        int get_nb_thread() const {return _nb_thread;}
+
+        // topology changing along the time series: the modification is applied at the beginning of "step" and
+        // is kept for all the following steps (until another event concerns the same branch). Branches are
+        // labelled as in the flows: all the powerlines then all the trafos.
+        // The steps are then grouped by topology and each topology is factorized once (nb_thread is not used)
+        void add_branch_status_event(int step, int branch_id, bool connected);
+        // side is 0 for the "from" side (or for powerlines, hv for trafos) and 1 for the "to" side (ex / lv),
+        // new_bus_id is in the grid model labelling (the bus is activated if needed)
+        void add_branch_bus_event(int step, int branch_id, int side, int new_bus_id);
+        void clear_topo_events() {_topo_events.clear();}
+        int nb_topo_events() const {return static_cast<int>(_topo_events.size());}
+        // topology used at each step by the last call to compute_Vs (0 is the topology of the first step)
+        const IntVect & get_steps_topology() const {return _steps_topology;}
+        int nb_topologies() const {return _nb_topologies;}
 
         /**
         This function computes the results of running as many powerflow when varying the 
@@ -58,22 +123,134 @@ class TimeSeries: public BaseBatchSolverSynch
             BaseBatchSolverSynch::clear();
             _Sbuses = CplxMat();
             _status = 1;
+            _steps_status = IntVect();
+            _steps_nb_iter = IntVect();
+            _steps_error = IntVect();
+            _steps_topology = IntVect();
+            _nb_topologies = 0;
+            _topo_flow_data.clear();
             _compute_flows = true;
             _timer_total = 0.;
             _timer_pre_proc = 0.;
         }
 
+        // buses are labelled as in the solver for the topology of the grid model (topology events are not
+        // taken into account)
         Eigen::Ref<const CplxMat > get_sbuses() const {return _Sbuses;}
         Eigen::Ref<RealMat > compute_flows() {
-            compute_flows_from_Vs();
+            if(_topo_flow_data.empty()) compute_flows_from_Vs(true, _nb_thread);
+            else compute_topo_flows(true);
             return _amps_flows;
         }
         Eigen::Ref<RealMat > compute_power_flows() {
-            compute_flows_from_Vs(false);
+            if(_topo_flow_data.empty()) compute_flows_from_Vs(false, _nb_thread);
+            else compute_topo_flows(false);
             return _active_power_flows;
         }
+        // results of the branches, generators, shunts and buses (see get_p_or, get_gen_q, get_shunt_q and get_bus_v_kv)
+        void compute_results(bool branch_results, bool gen_results, bool shunt_results, bool bus_results) {
+            if(!_topo_flow_data.empty()){
+                std::ostringstream exc_;
+                exc_ << "TimeSeries::compute_results: the results cannot be computed when the topology changes ";
+                exc_ << "along the time series (topology events). Use compute_flows / compute_power_flows instead.";
+                throw std::runtime_error(exc_.str());
+            }
+            compute_results_from_Vs(branch_results, gen_results, shunt_results, bus_results,
+                                    _Sbuses, std::vector<std::vector<int> >(), _nb_thread);
+        }
 
     protected:
+        // change of topology at a given step (see add_branch_status_event and add_branch_bus_event)
+        struct TopoEvent
+        {
+            int step;
+            int branch_id;  // powerlines then trafos
+            int side;  // -1 for a change of status, 0 for the "from" side and 1 for the "to" side
+            int value;  // new status (0 or 1) or new bus (grid model labelling)
+        };
+
+        // solves steps[first_step], ..., steps[last_step - 1] with the given solver, starting from V, the row k 
+        // of Sbuses being the injections of steps[k]. It stops at the first step that diverges, unless 
+        // _continue_on_divergence is set: the next step then starts from Vinit_solver and the angles of a DC 
+        // powerflow (computed with dcYbus, if not empty)
+        void compute_chunk(ChooseSolver & solver,
+                           SolverControl & solver_control,
+                           const Eigen::SparseMatrix<cplx_type> & Ybus,
+                           CplxVect & V,
+                           const CplxMat & Sbuses,
+                           const std::vector<Eigen::Index> & steps,
+                           const Eigen::VectorXi & slack_ids,
+                           const RealVect & slack_weights,
+                           const Eigen::VectorXi & bus_pv,
+                           const Eigen::VectorXi & bus_pq,
+                           const std::vector<int> & id_solver_to_me,
+                           const CplxVect & Vinit_solver,
+                           const Eigen::SparseMatrix<cplx_type> & dcYbus,
+                           const Eigen::VectorXi & dc_slack_ids,
+                           int max_iter,
+                           real_type tol,
+                           Eigen::Index first_step,
+                           Eigen::Index last_step,
+                           int & nb_solved,
+                           double & timer_solver);
+
+        // all the steps at once (with a DC solver), Sbuses and steps as in compute_chunk
+        void compute_dc_steps(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                              const CplxVect & Vinit_solver,
+                              const CplxMat & Sbuses,
+                              const std::vector<Eigen::Index> & steps,
+                              const Eigen::VectorXi & slack_ids,
+                              const RealVect & slack_weights,
+                              const Eigen::VectorXi & bus_pv,
+                              const Eigen::VectorXi & bus_pq,
+                              const std::vector<int> & id_solver_to_me);
+
+        // solves all the steps when there are topology events: the steps are grouped by topology. For each
+        // distinct bus assignment of the branches, Ybus is computed with all the branches connected in at least
+        // one of its topologies, the other topologies are obtained by removing coefficients of this Ybus (the 
+        // sparsity pattern, and thus the symbolic factorization, is kept)
+        void compute_topo_steps(const CplxVect & Vinit, int max_iter, real_type tol);
+
+        // flows (see compute_flows) when there are topology events
+        void compute_topo_flows(bool amps);
+
+        // modification of the topology of the grid model (branches labelled as in TopoEvent)
+        void set_branch_status(int branch_id, bool connected);
+        void set_branch_bus(int branch_id, int side, int new_bus_id);
+        bool get_branch_status(int branch_id) const;
+        int get_branch_bus(int branch_id, int side) const;
+
+        // changes V (solution of the last step) into the initial voltages of the next step (see PredictorType),
+        // V_prev (resp. V_prev2) being the solution of the step before (resp. two steps before).
+        // nb_history is the number of consecutive steps already solved, including the last one.
+        void predict_V(ChooseSolver & solver,
+                       const Eigen::SparseMatrix<cplx_type> & Ybus,
+                       CplxVect & V,
+                       const CplxVect & V_prev,
+                       const CplxVect & V_prev2,
+                       int nb_history,
+                       const CplxVect & Sbus,
+                       const Eigen::VectorXi & slack_ids,
+                       const RealVect & slack_weights,
+                       const Eigen::VectorXi & bus_pv,
+                       const Eigen::VectorXi & bus_pq,
+                       double & timer_solver) const;
+
+        // initial voltages of a chunk that does not start at the first step (or of a step following a
+        // divergence): the magnitudes of Vinit_solver and the angles of a DC powerflow for Sbus
+        // (Vinit_solver is returned if dcYbus is empty, see same_ac_dc_buses)
+        CplxVect dc_init_chunk(const Eigen::SparseMatrix<cplx_type> & dcYbus,
+                               const CplxVect & Vinit_solver,
+                               const CplxVect & Sbus,
+                               const Eigen::VectorXi & slack_ids,
+                               const RealVect & slack_weights,
+                               const Eigen::VectorXi & bus_pv,
+                               const Eigen::VectorXi & bus_pq,
+                               double & timer_solver);
+        // whether the AC and the DC solvers label the buses the same way (they can differ, even with
+        // the same number of buses, if the topology or the slack changed since the last DC powerflow)
+        bool same_ac_dc_buses() const {return _grid_model.id_me_to_ac_solver() == _grid_model.id_me_to_dc_solver();}
+
         template<class T>
         void fill_SBus_real(CplxMat & Sbuses,
                             const T & structure_data,
@@ -124,9 +301,21 @@ class TimeSeries: public BaseBatchSolverSynch
 
         // outputs
         int _status;
+        IntVect _steps_status;
+        IntVect _steps_nb_iter;
+        IntVect _steps_error;
+
+        // topology
+        std::vector<TopoEvent> _topo_events;
+        IntVect _steps_topology;
+        int _nb_topologies;
+        std::vector<BranchFlowData> _topo_flow_data;  // connected branches of each topology (empty without topology events)
 
         // parameters
         bool _compute_flows;
+        bool _continue_on_divergence;
+        PredictorType _predictor;
+        int _nb_thread;  // number of workers used in "compute_Vs" (1 = everything is done in the calling thread)
 
         //timers
         double _timer_total;
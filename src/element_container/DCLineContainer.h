@@ -162,11 +162,13 @@ class DCLineContainer : public GenericContainer
 
     // accessor / modifiers
     void deactivate(int dcline_id, SolverControl & solver_control) {
+        if(status_[dcline_id]) _tell_sbus_changed(dcline_id);
         _deactivate(dcline_id, status_);
         from_gen_.deactivate(dcline_id, solver_control);
         to_gen_.deactivate(dcline_id, solver_control);
         }
     void reactivate(int dcline_id, SolverControl & solver_control) {
+        if(!status_[dcline_id]) _tell_sbus_changed(dcline_id);
         _reactivate(dcline_id, status_);
         from_gen_.reactivate(dcline_id, solver_control);
         to_gen_.reactivate(dcline_id, solver_control);
@@ -177,6 +179,10 @@ class DCLineContainer : public GenericContainer
         to_gen_.change_bus(dcline_id, new_bus_id, solver_control, nb_bus);}
     int get_bus_or(int dcline_id) {return from_gen_.get_bus(dcline_id);}
     int get_bus_ex(int dcline_id) {return to_gen_.get_bus(dcline_id);}
+    // active power setpoint (as given to change_p) and voltage setpoints
+    real_type get_p_mw(int dcline_id) const {return -1.0 * from_gen_.get_p_mw(dcline_id);}
+    real_type get_vm_or_pu(int dcline_id) const {return from_gen_.get_vm_pu(dcline_id);}
+    real_type get_vm_ex_pu(int dcline_id) const {return to_gen_.get_vm_pu(dcline_id);}
 
     // for buses only connected through dc line, i don't add them
     // they are not in the same "connected component"
@@ -208,6 +214,7 @@ class DCLineContainer : public GenericContainer
         return new_p_ext;
     }
     void change_p(int dcline_id, real_type new_p, SolverControl & sovler_control){
+        _tell_sbus_changed(dcline_id);
         from_gen_.change_p(dcline_id, -1.0 * new_p, sovler_control);
 
         to_gen_.change_p(dcline_id, -1.0 * get_to_mw(dcline_id, new_p), sovler_control);
@@ -219,6 +226,14 @@ class DCLineContainer : public GenericContainer
         to_gen_.change_v(dcline_id, new_v_pu, sovler_control);
     }
 
+    // the two "generators" of a dc line contribute to Sbus, so get_sbus_contribution cannot be used
+    // for this class (its changes are tracked with get_sbus_changed though)
+    virtual void clear_sbus_changed(){
+        GenericContainer::clear_sbus_changed();
+        from_gen_.clear_sbus_changed();
+        to_gen_.clear_sbus_changed();
+    }
+
     // solver stuff
     virtual void fillSbus(CplxVect & Sbus, const std::vector<int> & id_grid_to_solver, bool ac) const{
         from_gen_.fillSbus(Sbus, id_grid_to_solver, ac);   
@@ -126,6 +126,14 @@ void GeneratorContainer::set_state(GeneratorContainer::StateRes & my_state)
 }
 
 RealVect GeneratorContainer::get_slack_weights_solver(Eigen::Index nb_bus_solver, const std::vector<int> & id_grid_to_solver){
+    RealVect res = get_raw_slack_weights_solver(nb_bus_solver, id_grid_to_solver);
+    bus_slack_weight_ = res;
+    real_type sum_res = res.sum();
+    res /= sum_res;
+    return res;
+}
+
+RealVect GeneratorContainer::get_raw_slack_weights_solver(Eigen::Index nb_bus_solver, const std::vector<int> & id_grid_to_solver) const{
     const int nb_gen = nb();
     int bus_id_me, bus_id_solver;
     RealVect res = RealVect::Zero(nb_bus_solver);
@@ -144,39 +152,42 @@ RealVect GeneratorContainer::get_slack_weights_solver(Eigen::Index nb_bus_solver
         }
         if(gen_slackbus_[gen_id]) res.coeffRef(bus_id_solver) += gen_slack_weight_[gen_id];
     }
-    bus_slack_weight_ = res;
-    real_type sum_res = res.sum();
-    res /= sum_res;
     return res;
 }
 
 void GeneratorContainer::fillSbus(CplxVect & Sbus, const std::vector<int> & id_grid_to_solver, bool ac) const {
     const int nb_gen = nb();
-    int bus_id_me, bus_id_solver;
+    int bus_id_solver;
     cplx_type tmp;
     for(int gen_id = 0; gen_id < nb_gen; ++gen_id){
-        //  i don't do anything if the load is disconnected
-        if(!status_[gen_id]) continue;
-
-        bus_id_me = bus_id_(gen_id);
-        bus_id_solver = id_grid_to_solver[bus_id_me];
-        if(bus_id_solver == _deactivated_bus_id){
-            // TODO DEBUG MODE only this in debug mode
-            std::ostringstream exc_;
-            exc_ << "GeneratorContainer::fillSbus: Generator with id ";
-            exc_ << gen_id;
-            exc_ << " is connected to a disconnected bus while being connected to the grid.";
-            throw std::runtime_error(exc_.str());
-        }
-        tmp = {p_mw_(gen_id), 0.};
-        if(!voltage_regulator_on_[gen_id]){
-            // gen is pq if voltage regulaton is off
-            tmp += my_i * q_mvar_(gen_id);
-        }
+        bus_id_solver = get_sbus_contribution(gen_id, id_grid_to_solver, ac, tmp);
+        //  i don't do anything if the generator is disconnected
+        if(bus_id_solver == _deactivated_bus_id) continue;
         Sbus.coeffRef(bus_id_solver) += tmp;
     }
 }
 
+int GeneratorContainer::get_sbus_contribution(int gen_id, const std::vector<int> & id_grid_to_solver, bool ac, cplx_type & res) const {
+    if(!status_[gen_id]) return _deactivated_bus_id;
+
+    int bus_id_me = bus_id_(gen_id);
+    int bus_id_solver = id_grid_to_solver[bus_id_me];
+    if(bus_id_solver == _deactivated_bus_id){
+        // TODO DEBUG MODE only this in debug mode
+        std::ostringstream exc_;
+        exc_ << "GeneratorContainer::fillSbus: Generator with id ";
+        exc_ << gen_id;
+        exc_ << " is connected to a disconnected bus while being connected to the grid.";
+        throw std::runtime_error(exc_.str());
+    }
+    res = {p_mw_(gen_id), 0.};
+    if(!voltage_regulator_on_[gen_id]){
+        // gen is pq if voltage regulaton is off
+        res += my_i * q_mvar_(gen_id);
+    }
+    return bus_id_solver;
+}
+
 void GeneratorContainer::fillpv(std::vector<int> & bus_pv,
                                 std::vector<bool> & has_bus_been_added,
                                 const Eigen::VectorXi & slack_bus_id_solver,
@@ -282,6 +293,7 @@ void GeneratorContainer::change_p(int gen_id, real_type new_p, SolverControl & s
     }
     if (p_mw_(gen_id) != new_p){
         solver_control.tell_recompute_sbus();
+        _tell_sbus_changed(gen_id);
         p_mw_(gen_id) = new_p;
     }
 }
@@ -302,6 +314,7 @@ void GeneratorContainer::change_q(int gen_id, real_type new_q, SolverControl & s
     // this would have not effect
     if (q_mvar_(gen_id) != new_q){
         solver_control.tell_recompute_sbus();
+        _tell_sbus_changed(gen_id);
         q_mvar_(gen_id) = new_q;
     }
 }
@@ -385,6 +398,14 @@ void GeneratorContainer::set_p_slack(const RealVect& node_mismatch,
         // TODO DEBUG MODE: perform this check only in debug mode
         throw std::runtime_error("Generator::set_p_slack: Impossible to set the active value of generators for the slack bus: no known slack (you should haved called Generator::get_slack_weights_solver first)");
     }
+    add_p_slack(node_mismatch, id_grid_to_solver, bus_slack_weight_, res_p_);
+}
+
+void GeneratorContainer::add_p_slack(const Eigen::Ref<const RealVect> & node_mismatch,
+                                     const std::vector<int> & id_grid_to_solver,
+                                     const RealVect & bus_slack_weight,
+                                     Eigen::Ref<RealVect> res_p) const
+{
     const auto nb_gen = nb();
     for(int gen_id = 0; gen_id < nb_gen; ++gen_id){
         if(!status_[gen_id]) continue;  // nothing to do if gen is disconnected
@@ -393,10 +414,10 @@ void GeneratorContainer::set_p_slack(const RealVect& node_mismatch,
         const auto bus_id_me = bus_id_(gen_id);
         const auto bus_id_solver = id_grid_to_solver[bus_id_me];
         // TODO DEBUG MODE: check bus_id_solver >= 0
-        // TODO DEBUG MODE: check bus_slack_weight_[bus_id_solver] > 0
-        const auto total_contrib_slack = bus_slack_weight_(bus_id_solver);
+        // TODO DEBUG MODE: check bus_slack_weight[bus_id_solver] > 0
+        const auto total_contrib_slack = bus_slack_weight(bus_id_solver);
         const auto my_contrib_slack = gen_slack_weight_[gen_id];
-        res_p_(gen_id) += node_mismatch(bus_id_solver) * my_contrib_slack / total_contrib_slack;
+        res_p(gen_id) += node_mismatch(bus_id_solver) * my_contrib_slack / total_contrib_slack;
     }
 }
 
@@ -426,11 +447,22 @@ void GeneratorContainer::set_q(const RealVect & reactive_mismatch,
                                const Eigen::VectorXi & total_gen_per_bus,
                                const RealVect & total_q_min_per_bus,
                                const RealVect & total_q_max_per_bus)
+{
+    compute_q(reactive_mismatch, id_grid_to_solver, ac, total_gen_per_bus, total_q_min_per_bus, total_q_max_per_bus, res_q_);
+}
+
+void GeneratorContainer::compute_q(const Eigen::Ref<const RealVect> & reactive_mismatch,
+                                   const std::vector<int> & id_grid_to_solver,
+                                   bool ac,
+                                   const Eigen::VectorXi & total_gen_per_bus,
+                                   const RealVect & total_q_min_per_bus,
+                                   const RealVect & total_q_max_per_bus,
+                                   Eigen::Ref<RealVect> res_q) const
 {
     const int nb_gen = nb();
     if(!ac){
         // do not consider Q values in dc mode
-        for(int gen_id = 0; gen_id < nb_gen; ++gen_id) res_q_(gen_id) = 0.;
+        for(int gen_id = 0; gen_id < nb_gen; ++gen_id) res_q(gen_id) = 0.;
         return;
     }
     
@@ -439,18 +471,18 @@ void GeneratorContainer::set_q(const RealVect & reactive_mismatch,
     {
         if(!status_[gen_id]){
             // set at 0 for disconnected generators
-            res_q_(gen_id) = 0.;
+            res_q(gen_id) = 0.;
             continue;  
         }
         real_type real_q = 0.;
         if (!voltage_regulator_on_[gen_id]){
             // gen is purposedly not pv
-            res_q_(gen_id) = 0.;
+            res_q(gen_id) = 0.;
             continue;
         } 
         if ((!turnedoff_gen_pv_) && p_mw_(gen_id) == 0.) {
             // in this case turned off generators are not pv
-            res_q_(gen_id) = 0.;
+            res_q(gen_id) = 0.;
             continue;
         }  
 
@@ -469,7 +501,7 @@ void GeneratorContainer::set_q(const RealVect & reactive_mismatch,
             real_type ratio = (max_q_me - min_q_me + eps_q) / (max_q_bus - min_q_bus + nb_gen_with_me * eps_q) ;
             real_q = q_to_absorb * ratio ;
         }
-        res_q_(gen_id) = real_q;
+        res_q(gen_id) = real_q;
     }
 }
 
@@ -222,9 +222,17 @@ class GeneratorContainer: public GenericContainer
     Retrieve the normalized (=sum to 1.000) slack weights for all the buses
     **/
     RealVect get_slack_weights_solver(Eigen::Index nb_bus_solver, const std::vector<int> & id_grid_to_solver);
+    // same as above, but the weights are not normalized (and the generators are not modified)
+    RealVect get_raw_slack_weights_solver(Eigen::Index nb_bus_solver, const std::vector<int> & id_grid_to_solver) const;
 
     Eigen::VectorXi get_slack_bus_id() const;
     void set_p_slack(const RealVect& node_mismatch, const std::vector<int> & id_grid_to_solver);
+    // add the active power absorbed by each slack generator (given the raw bus_slack_weight, 
+    // see get_raw_slack_weights_solver) to res_p instead of the results of the generators
+    void add_p_slack(const Eigen::Ref<const RealVect> & node_mismatch,
+                     const std::vector<int> & id_grid_to_solver,
+                     const RealVect & bus_slack_weight,
+                     Eigen::Ref<RealVect> res_p) const;
 
     // modification
     void turnedoff_no_pv(SolverControl & solver_control){
@@ -244,6 +252,7 @@ class GeneratorContainer: public GenericContainer
     void deactivate(int gen_id, SolverControl & solver_control) {
         if (status_[gen_id]){
             solver_control.tell_recompute_sbus();
+            _tell_sbus_changed(gen_id);
             solver_control.tell_pq_changed();  // bus might now be pq
             if(voltage_regulator_on_[gen_id]) solver_control.tell_v_changed();
             solver_control.tell_pv_changed();
@@ -257,6 +266,7 @@ class GeneratorContainer: public GenericContainer
     void reactivate(int gen_id, SolverControl & solver_control) {
         if(!status_[gen_id]){
             solver_control.tell_recompute_sbus();
+            _tell_sbus_changed(gen_id);
             solver_control.tell_pq_changed();  // bus might now be pv
             if(voltage_regulator_on_[gen_id]) solver_control.tell_v_changed();
             solver_control.tell_pv_changed();
@@ -273,6 +283,8 @@ class GeneratorContainer: public GenericContainer
         }
         _change_bus(gen_id, new_bus_id, bus_id_, solver_control, nb_bus);}
     int get_bus(int gen_id) {return _get_bus(gen_id, status_, bus_id_);}
+    real_type get_p_mw(int gen_id) const {return p_mw_.coeff(gen_id);}
+    real_type get_vm_pu(int gen_id) const {return vm_pu_.coeff(gen_id);}
     virtual void reconnect_connected_buses(std::vector<bool> & bus_status) const;
     virtual void disconnect_if_not_in_main_component(std::vector<bool> & busbar_in_main_component);
     virtual void update_bus_status(std::vector<bool> & bus_status) const {
@@ -290,6 +302,7 @@ class GeneratorContainer: public GenericContainer
     void change_q(int gen_id, real_type new_q, SolverControl & solver_control);
 
     virtual void fillSbus(CplxVect & Sbus, const std::vector<int> & id_grid_to_solver, bool ac) const;
+    virtual int get_sbus_contribution(int el_id, const std::vector<int> & id_grid_to_solver, bool ac, cplx_type & res) const;
     virtual void fillpv(std::vector<int>& bus_pv,
                         std::vector<bool> & has_bus_been_added,
                         const Eigen::VectorXi & slack_bus_id_solver,
@@ -313,6 +326,14 @@ class GeneratorContainer: public GenericContainer
                const Eigen::VectorXi & total_gen_per_bus,
                const RealVect & total_q_min_per_bus,
                const RealVect & total_q_max_per_bus);
+    // same as set_q, but the reactive power of each generator is written in res_q
+    void compute_q(const Eigen::Ref<const RealVect> & reactive_mismatch,
+                   const std::vector<int> & id_grid_to_solver,
+                   bool ac,
+                   const Eigen::VectorXi & total_gen_per_bus,
+                   const RealVect & total_q_min_per_bus,
+                   const RealVect & total_q_max_per_bus,
+                   Eigen::Ref<RealVect> res_q) const;
 
     void get_vm_for_dc(RealVect & Vm);
     /**
@@ -87,6 +87,11 @@ class GenericContainer : public BaseConstants
         virtual void fillYbus(Eigen::SparseMatrix<cplx_type> & res, bool ac, const std::vector<int> & id_grid_to_solver) const {};
 
         virtual void fillSbus(CplxVect & Sbus, const std::vector<int> & id_grid_to_solver, bool ac) const {};
+        // contribution (not divided by sn_mva) of the element el_id to Sbus, returns the solver id of the bus where
+        // it should be added (_deactivated_bus_id if the element does not contribute, for example if it is disconnected)
+        virtual int get_sbus_contribution(int el_id, const std::vector<int> & id_grid_to_solver, bool ac, cplx_type & res) const {
+            return _deactivated_bus_id;
+        };
         virtual void fillpv(std::vector<int>& bus_pv,
                             std::vector<bool> & has_bus_been_added,
                             const Eigen::VectorXi & slack_bus_id_solver,
@@ -110,10 +115,40 @@ class GenericContainer : public BaseConstants
             names_ = names;
         }
         
+        /**
+        elements whose coefficients in Ybus changed (without changing its sparsity pattern) since the last
+        call to "clear_ybus_changed", used by the GridModel to update the Ybus matrix in place
+        **/
+        const std::vector<int> & get_ybus_changed() const {return ybus_changed_;}
+        void clear_ybus_changed(){
+            for(auto el_id : ybus_changed_) is_ybus_changed_[el_id] = false;
+            ybus_changed_.clear();
+        }
+
+        /**
+        elements whose contribution to Sbus (value or status) changed since the last call to "clear_sbus_changed",
+        used by the GridModel to update only these contributions
+        **/
+        const std::vector<int> & get_sbus_changed() const {return sbus_changed_;}
+        // incremented each time an element is modified (even if it is already in get_sbus_changed), never reset
+        unsigned long get_sbus_change_serial() const {return sbus_change_serial_;}
+        virtual void clear_sbus_changed(){
+            for(auto el_id : sbus_changed_) is_sbus_changed_[el_id] = false;
+            sbus_changed_.clear();
+        }
+
         /**"define" the destructor for compliance with clang (otherwise lots of warnings)**/
         virtual ~GenericContainer() {};
     protected:
-        std::vector<std::string> names_;
+        CopyOnWrite<std::vector<std::string>> names_;
+
+        // see get_ybus_changed
+        std::vector<int> ybus_changed_;
+        std::vector<bool> is_ybus_changed_;
+        // see get_sbus_changed
+        std::vector<int> sbus_changed_;
+        std::vector<bool> is_sbus_changed_;
+        unsigned long sbus_change_serial_ = 0;
 
     protected:
         template<typename Cont, typename FunName, typename IntType>
@@ -150,6 +185,19 @@ class GenericContainer : public BaseConstants
         void _reactivate(int el_id, std::vector<bool> & status);
         void _deactivate(int el_id, std::vector<bool> & status);
         void _change_bus(int el_id, int new_bus_me_id, Eigen::VectorXi & el_bus_ids, SolverControl & solver_control, int nb_bus);
+        void _tell_ybus_changed(int el_id){
+            if(static_cast<int>(is_ybus_changed_.size()) <= el_id) is_ybus_changed_.resize(el_id + 1, false);
+            if(is_ybus_changed_[el_id]) return;
+            is_ybus_changed_[el_id] = true;
+            ybus_changed_.push_back(el_id);
+        }
+        void _tell_sbus_changed(int el_id){
+            ++sbus_change_serial_;
+            if(static_cast<int>(is_sbus_changed_.size()) <= el_id) is_sbus_changed_.resize(el_id + 1, false);
+            if(is_sbus_changed_[el_id]) return;
+            is_sbus_changed_[el_id] = true;
+            sbus_changed_.push_back(el_id);
+        }
         int _get_bus(int el_id, const std::vector<bool> & status_, const Eigen::VectorXi & bus_id_) const;
 
         /**
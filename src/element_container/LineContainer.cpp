@@ -138,6 +138,15 @@ void LineContainer::_update_model_coeffs()
     ydc_ft_ = CplxVect::Zero(my_size);
     ydc_tf_ = CplxVect::Zero(my_size);
     ydc_tt_ = CplxVect::Zero(my_size);
+    // freshly allocated above, so none of these is shared with a copy of this container
+    CplxVect & yac_ff = yac_ff_.mut();
+    CplxVect & yac_ft = yac_ft_.mut();
+    CplxVect & yac_tf = yac_tf_.mut();
+    CplxVect & yac_tt = yac_tt_.mut();
+    CplxVect & ydc_ff = ydc_ff_.mut();
+    CplxVect & ydc_ft = ydc_ft_.mut();
+    CplxVect & ydc_tf = ydc_tf_.mut();
+    CplxVect & ydc_tt = ydc_tt_.mut();
     for(int i = 0; i < my_size; ++i)
     {
         // for AC
@@ -145,19 +154,19 @@ void LineContainer::_update_model_coeffs()
         const cplx_type ys = 1. / (powerlines_r_(i) + my_i * powerlines_x_(i));
         const cplx_type h_or = powerlines_h_or_(i);
         const cplx_type h_ex = powerlines_h_ex_(i);
-        yac_ff_(i) = (ys + h_or);
-        yac_tt_(i) = (ys + h_ex);
-        yac_tf_(i) = -ys;
-        yac_ft_(i) = -ys;
+        yac_ff(i) = (ys + h_or);
+        yac_tt(i) = (ys + h_ex);
+        yac_tf(i) = -ys;
+        yac_ft(i) = -ys;
 
         // for DC
         // see https://matpower.org/docs/MATPOWER-manual.pdf eq. 3.21
         // except here I only care about the real part, so I remove the "1/j"
         cplx_type tmp = 1. / (powerlines_x_(i));
-        ydc_ff_(i) = tmp;
-        ydc_tt_(i) = tmp;
-        ydc_tf_(i) = -tmp;
-        ydc_ft_(i) = -tmp;
+        ydc_ff(i) = tmp;
+        ydc_tt(i) = tmp;
+        ydc_tf(i) = -tmp;
+        ydc_ft(i) = -tmp;
     }
 }
 
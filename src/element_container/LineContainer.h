@@ -256,15 +256,15 @@ class LineContainer : public GenericContainer
     Eigen::Ref<const Eigen::VectorXi> get_bus_to() const {return bus_ex_id_;}
 
     // model paramters
-    Eigen::Ref<const CplxVect> yac_ff() const {return yac_ff_;}
-    Eigen::Ref<const CplxVect> yac_ft() const {return yac_ft_;}
-    Eigen::Ref<const CplxVect> yac_tf() const {return yac_tf_;}
-    Eigen::Ref<const CplxVect> yac_tt() const {return yac_tt_;}
+    Eigen::Ref<const CplxVect> yac_ff() const {return *yac_ff_;}
+    Eigen::Ref<const CplxVect> yac_ft() const {return *yac_ft_;}
+    Eigen::Ref<const CplxVect> yac_tf() const {return *yac_tf_;}
+    Eigen::Ref<const CplxVect> yac_tt() const {return *yac_tt_;}
 
-    Eigen::Ref<const CplxVect> ydc_ff() const {return ydc_ff_;}
-    Eigen::Ref<const CplxVect> ydc_ft() const {return ydc_ft_;}
-    Eigen::Ref<const CplxVect> ydc_tf() const {return ydc_tf_;}
-    Eigen::Ref<const CplxVect> ydc_tt() const {return ydc_tt_;}
+    Eigen::Ref<const CplxVect> ydc_ff() const {return *ydc_ff_;}
+    Eigen::Ref<const CplxVect> ydc_ft() const {return *ydc_ft_;}
+    Eigen::Ref<const CplxVect> ydc_tf() const {return *ydc_tf_;}
+    Eigen::Ref<const CplxVect> ydc_tt() const {return *ydc_tt_;}
     // for consistency with trafo, when used for example in BaseMultiplePowerflow...
     Eigen::Ref<const RealVect> dc_x_tau_shift() const {return RealVect();}
 
@@ -273,10 +273,10 @@ class LineContainer : public GenericContainer
 
     protected:
         // physical properties
-        RealVect powerlines_r_;
-        RealVect powerlines_x_;
-        CplxVect powerlines_h_or_;
-        CplxVect powerlines_h_ex_;
+        CopyOnWrite<RealVect> powerlines_r_;
+        CopyOnWrite<RealVect> powerlines_x_;
+        CopyOnWrite<CplxVect> powerlines_h_or_;
+        CopyOnWrite<CplxVect> powerlines_h_ex_;
 
         // input data
         Eigen::VectorXi bus_or_id_;
@@ -296,15 +296,15 @@ class LineContainer : public GenericContainer
         RealVect res_powerline_thetaex_; // in degree
 
         // model coefficients
-        CplxVect yac_ff_;
-        CplxVect yac_ft_;
-        CplxVect yac_tf_;
-        CplxVect yac_tt_;
+        CopyOnWrite<CplxVect> yac_ff_;
+        CopyOnWrite<CplxVect> yac_ft_;
+        CopyOnWrite<CplxVect> yac_tf_;
+        CopyOnWrite<CplxVect> yac_tt_;
 
-        CplxVect ydc_ff_;
-        CplxVect ydc_ft_;
-        CplxVect ydc_tf_;
-        CplxVect ydc_tt_;
+        CopyOnWrite<CplxVect> ydc_ff_;
+        CopyOnWrite<CplxVect> ydc_ft_;
+        CopyOnWrite<CplxVect> ydc_tf_;
+        CopyOnWrite<CplxVect> ydc_tt_;
 };
 
 #endif  //LINE_CONTAINER_H
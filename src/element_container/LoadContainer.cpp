@@ -58,25 +58,36 @@ void LoadContainer::fillSbus(CplxVect & Sbus,
                              bool ac) const
 {
     int nb_load = nb();
-    int bus_id_me, bus_id_solver;
+    int bus_id_solver;
     cplx_type tmp;
     for(int load_id = 0; load_id < nb_load; ++load_id){
+        bus_id_solver = get_sbus_contribution(load_id, id_grid_to_solver, ac, tmp);
         //  i don't do anything if the load is disconnected
-        if(!status_[load_id]) continue;
+        if(bus_id_solver == _deactivated_bus_id) continue;
+        Sbus.coeffRef(bus_id_solver) += tmp;
+    }
+}
 
-        bus_id_me = bus_id_(load_id);
-        bus_id_solver = id_grid_to_solver[bus_id_me];
-        if(bus_id_solver == _deactivated_bus_id){
-            std::ostringstream exc_;
-            exc_ << "LoadContainer::fillSbus: the load with id ";
-            exc_ << load_id;
-            exc_ << " is connected to a disconnected bus while being connected";
-            throw std::runtime_error(exc_.str());
-        }
-        tmp = static_cast<cplx_type>(p_mw_(load_id));
-        tmp += my_i * q_mvar_(load_id);
-        Sbus.coeffRef(bus_id_solver) -= tmp;
+int LoadContainer::get_sbus_contribution(int load_id,
+                                         const std::vector<int> & id_grid_to_solver,
+                                         bool ac,
+                                         cplx_type & res) const
+{
+    if(!status_[load_id]) return _deactivated_bus_id;
+
+    int bus_id_me = bus_id_(load_id);
+    int bus_id_solver = id_grid_to_solver[bus_id_me];
+    if(bus_id_solver == _deactivated_bus_id){
+        std::ostringstream exc_;
+        exc_ << "LoadContainer::fillSbus: the load with id ";
+        exc_ << load_id;
+        exc_ << " is connected to a disconnected bus while being connected";
+        throw std::runtime_error(exc_.str());
     }
+    res = static_cast<cplx_type>(p_mw_(load_id));
+    res += my_i * q_mvar_(load_id);
+    res = -res;  // load convention
+    return bus_id_solver;
 }
 
 void LoadContainer::compute_results(const Eigen::Ref<const RealVect> & Va,
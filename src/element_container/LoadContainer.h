@@ -141,22 +141,27 @@ class LoadContainer : public GenericContainer
     void deactivate(int load_id, SolverControl & solver_control) {
         if(status_[load_id]){
             solver_control.tell_recompute_sbus();
+            _tell_sbus_changed(load_id);
         }
         _deactivate(load_id, status_);
     }
     void reactivate(int load_id, SolverControl & solver_control) {
         if(!status_[load_id]){
             solver_control.tell_recompute_sbus();
+            _tell_sbus_changed(load_id);
         }
         _reactivate(load_id, status_);
     }
     void change_bus(int load_id, int new_bus_id, SolverControl & solver_control, int nb_bus) {_change_bus(load_id, new_bus_id, bus_id_, solver_control, nb_bus);}
     int get_bus(int load_id) {return _get_bus(load_id, status_, bus_id_);}
+    real_type get_p_mw(int load_id) const {return p_mw_.coeff(load_id);}
+    real_type get_q_mvar(int load_id) const {return q_mvar_.coeff(load_id);}
     void change_p(int load_id, real_type new_p, SolverControl & solver_control);
     void change_p_nothrow(int load_id, real_type new_p, SolverControl & solver_control)
     {
         if (p_mw_(load_id) != new_p) {
             solver_control.tell_recompute_sbus();
+            _tell_sbus_changed(load_id);
             p_mw_(load_id) = new_p;
         }
     }
@@ -165,6 +170,7 @@ class LoadContainer : public GenericContainer
     {
         if (q_mvar_(load_id) != new_q) {
             solver_control.tell_recompute_sbus();
+            _tell_sbus_changed(load_id);
             q_mvar_(load_id) = new_q;
         }
     }
@@ -172,6 +178,7 @@ class LoadContainer : public GenericContainer
     virtual void disconnect_if_not_in_main_component(std::vector<bool> & busbar_in_main_component);
 
     virtual void fillSbus(CplxVect & Sbus, const std::vector<int> & id_grid_to_solver, bool ac) const;
+    virtual int get_sbus_contribution(int el_id, const std::vector<int> & id_grid_to_solver, bool ac, cplx_type & res) const;
     virtual void update_bus_status(std::vector<bool> & bus_status) const {
         const int nb_ = nb();
         for(int el_id = 0; el_id < nb_; ++el_id)
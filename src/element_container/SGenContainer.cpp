@@ -86,26 +86,32 @@ void SGenContainer::set_state(SGenContainer::StateRes & my_state )
 
 void SGenContainer::fillSbus(CplxVect & Sbus, const std::vector<int> & id_grid_to_solver, bool ac) const {
     const int nb_sgen = nb();
-    int bus_id_me, bus_id_solver;
+    int bus_id_solver;
     cplx_type tmp;
     for(int sgen_id = 0; sgen_id < nb_sgen; ++sgen_id){
+        bus_id_solver = get_sbus_contribution(sgen_id, id_grid_to_solver, ac, tmp);
         //  i don't do anything if the static generator is disconnected
-        if(!status_[sgen_id]) continue;
-
-        bus_id_me = bus_id_(sgen_id);
-        bus_id_solver = id_grid_to_solver[bus_id_me];
-        if(bus_id_solver == _deactivated_bus_id){
-            std::ostringstream exc_;
-            exc_ << "SGenContainer::fillSbus: Static Generator with id ";
-            exc_ << sgen_id;
-            exc_ << " is connected to a disconnected bus while being connected to the grid.";
-            throw std::runtime_error(exc_.str());
-        }
-        tmp = {p_mw_(sgen_id), q_mvar_(sgen_id)};
+        if(bus_id_solver == _deactivated_bus_id) continue;
         Sbus.coeffRef(bus_id_solver) += tmp;
     }
 }
 
+int SGenContainer::get_sbus_contribution(int sgen_id, const std::vector<int> & id_grid_to_solver, bool ac, cplx_type & res) const {
+    if(!status_[sgen_id]) return _deactivated_bus_id;
+
+    int bus_id_me = bus_id_(sgen_id);
+    int bus_id_solver = id_grid_to_solver[bus_id_me];
+    if(bus_id_solver == _deactivated_bus_id){
+        std::ostringstream exc_;
+        exc_ << "SGenContainer::fillSbus: Static Generator with id ";
+        exc_ << sgen_id;
+        exc_ << " is connected to a disconnected bus while being connected to the grid.";
+        throw std::runtime_error(exc_.str());
+    }
+    res = {p_mw_(sgen_id), q_mvar_(sgen_id)};
+    return bus_id_solver;
+}
+
 void SGenContainer::compute_results(const Eigen::Ref<const RealVect> & Va,
                                     const Eigen::Ref<const RealVect> & Vm,
                                     const Eigen::Ref<const CplxVect> & V,
@@ -145,6 +151,7 @@ void SGenContainer::change_p(int sgen_id, real_type new_p, SolverControl & solve
     }
     if (p_mw_(sgen_id) != new_p){
         solver_control.tell_recompute_sbus();
+        _tell_sbus_changed(sgen_id);
         p_mw_(sgen_id) = new_p;
     }
 }
@@ -162,6 +169,7 @@ void SGenContainer::change_q(int sgen_id, real_type new_q, SolverControl & solve
     }
     if (q_mvar_(sgen_id) != new_q){
         solver_control.tell_recompute_sbus();
+        _tell_sbus_changed(sgen_id);
         q_mvar_(sgen_id) = new_q;
     }
 }
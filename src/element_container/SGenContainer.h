@@ -161,23 +161,28 @@ class SGenContainer: public GenericContainer
     void deactivate(int sgen_id, SolverControl & solver_control) {
         if(status_[sgen_id]){
             solver_control.tell_recompute_sbus();
+            _tell_sbus_changed(sgen_id);
         }
         _deactivate(sgen_id, status_);
     }
     void reactivate(int sgen_id, SolverControl & solver_control) {
         if(!status_[sgen_id]){
             solver_control.tell_recompute_sbus();
+            _tell_sbus_changed(sgen_id);
         }
         _reactivate(sgen_id, status_);
     }
     void change_bus(int sgen_id, int new_bus_id, SolverControl & solver_control, int nb_bus) {_change_bus(sgen_id, new_bus_id, bus_id_, solver_control, nb_bus);}
     int get_bus(int sgen_id) {return _get_bus(sgen_id, status_, bus_id_);}
+    real_type get_p_mw(int sgen_id) const {return p_mw_.coeff(sgen_id);}
+    real_type get_q_mvar(int sgen_id) const {return q_mvar_.coeff(sgen_id);}
     void change_p(int sgen_id, real_type new_p, SolverControl & solver_control);
     void change_q(int sgen_id, real_type new_q, SolverControl & solver_control);
     virtual void reconnect_connected_buses(std::vector<bool> & bus_status) const;
     virtual void disconnect_if_not_in_main_component(std::vector<bool> & busbar_in_main_component);
     
     virtual void fillSbus(CplxVect & Sbus, const std::vector<int> & id_grid_to_solver, bool ac) const ;
+    virtual int get_sbus_contribution(int el_id, const std::vector<int> & id_grid_to_solver, bool ac, cplx_type & res) const;
     virtual void gen_p_per_bus(std::vector<real_type> & res) const;
     virtual void update_bus_status(std::vector<bool> & bus_status) const {
         const int nb_ = nb();
@@ -64,13 +64,19 @@ void ShuntContainer::fillYbus(std::vector<Eigen::Triplet<cplx_type> > & res,
     cplx_type tmp;
     int bus_id_me, bus_id_solver;
     for(Eigen::Index shunt_id=0; shunt_id < nb_shunt; ++shunt_id){
-        // i don't do anything if the shunt is disconnected
-        if(!status_[shunt_id]) continue;
+        bus_id_me = bus_id_(shunt_id);
+        if(!status_[shunt_id]){
+            // a disconnected shunt adds a 0. on the diagonal (always there) if its bus is connected, so
+            // that the triplets do not change when the shunt is reconnected (see GridModel::updateYbus)
+            if((bus_id_me >= 0) && (id_grid_to_solver[bus_id_me] != _deactivated_bus_id)){
+                res.push_back(Eigen::Triplet<cplx_type> (id_grid_to_solver[bus_id_me], id_grid_to_solver[bus_id_me], 0.));
+            }
+            continue;
+        }
 
         // assign diagonal coefficient
         tmp = {p_mw_(shunt_id), -q_mvar_(shunt_id)};
 
-        bus_id_me = bus_id_(shunt_id);
         bus_id_solver = id_grid_to_solver[bus_id_me];
         if(bus_id_solver == _deactivated_bus_id){
             std::ostringstream exc_;
@@ -120,17 +126,27 @@ void ShuntContainer::fillSbus(CplxVect & Sbus, const std::vector<int> & id_grid_
     // - bus[:, GS] / baseMVA  # in pandapower
     // yish=gish+jbish -> so g is the MW !
     const int nb_shunt = static_cast<int>(q_mvar_.size());
-    int bus_id_me, bus_id_solver;
+    int bus_id_solver;
+    cplx_type tmp;
     for(int shunt_id=0; shunt_id < nb_shunt; ++shunt_id){
+        bus_id_solver = get_sbus_contribution(shunt_id, id_grid_to_solver, ac, tmp);
         // i don't do anything if the shunt is disconnected
-        if(!status_[shunt_id]) continue;
-        bus_id_me = bus_id_(shunt_id);
-        bus_id_solver = id_grid_to_solver[bus_id_me];
-        if(bus_id_solver == _deactivated_bus_id){
-            throw std::runtime_error("GridModel::fillSbus: A shunt is connected to a disconnected bus.");
-        }
-        Sbus.coeffRef(bus_id_solver) -= p_mw_(shunt_id);
+        if(bus_id_solver == _deactivated_bus_id) continue;
+        Sbus.coeffRef(bus_id_solver) += tmp;
+    }
+}
+
+int ShuntContainer::get_sbus_contribution(int shunt_id, const std::vector<int> & id_grid_to_solver, bool ac, cplx_type & res) const
+{
+    if(ac) return _deactivated_bus_id;  // in AC the shunts are in Ybus
+    if(!status_[shunt_id]) return _deactivated_bus_id;
+    int bus_id_me = bus_id_(shunt_id);
+    int bus_id_solver = id_grid_to_solver[bus_id_me];
+    if(bus_id_solver == _deactivated_bus_id){
+        throw std::runtime_error("GridModel::fillSbus: A shunt is connected to a disconnected bus.");
     }
+    res = {-p_mw_(shunt_id), my_zero_};
+    return bus_id_solver;
 }
 
 void ShuntContainer::fillYbus_spmat(Eigen::SparseMatrix<cplx_type> & res, bool ac, const std::vector<int> & id_grid_to_solver){
@@ -186,6 +202,8 @@ void ShuntContainer::change_p(int shunt_id, real_type new_p, SolverControl & sol
     if(p_mw_(shunt_id) != new_p){
         solver_control.tell_recompute_ybus();
         solver_control.tell_recompute_sbus();  // in dc mode sbus is modified
+        _tell_ybus_changed(shunt_id);
+        _tell_sbus_changed(shunt_id);
         p_mw_(shunt_id) = new_p;
     }
 }
@@ -196,6 +214,7 @@ void ShuntContainer::change_q(int shunt_id, real_type new_q, SolverControl & sol
     if(!my_status) throw std::runtime_error("Impossible to change the reactive value of a disconnected shunt");
     if(q_mvar_(shunt_id) != new_q){
         solver_control.tell_recompute_ybus();
+        _tell_ybus_changed(shunt_id);
         q_mvar_(shunt_id) = new_q;
     }
 }
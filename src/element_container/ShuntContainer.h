@@ -133,6 +133,8 @@ class ShuntContainer : public GenericContainer
         if(status_[shunt_id]){
             solver_control.tell_recompute_sbus();  // DC
             solver_control.tell_recompute_ybus();  // AC
+            _tell_ybus_changed(shunt_id);
+            _tell_sbus_changed(shunt_id);
         }
         _deactivate(shunt_id, status_);
     }
@@ -140,6 +142,8 @@ class ShuntContainer : public GenericContainer
         if(!status_[shunt_id]){
             solver_control.tell_recompute_sbus();  // DC
             solver_control.tell_recompute_ybus();  // AC
+            _tell_ybus_changed(shunt_id);
+            _tell_sbus_changed(shunt_id);
         }
         _reactivate(shunt_id, status_);
     }
@@ -163,6 +167,7 @@ class ShuntContainer : public GenericContainer
                             FDPFMethod xb_or_bx) const;
     virtual void fillYbus_spmat(Eigen::SparseMatrix<cplx_type> & res, bool ac, const std::vector<int> & id_grid_to_solver);
     virtual void fillSbus(CplxVect & Sbus, const std::vector<int> & id_grid_to_solver, bool ac) const;  // in DC i need that
+    virtual int get_sbus_contribution(int el_id, const std::vector<int> & id_grid_to_solver, bool ac, cplx_type & res) const;
     virtual void update_bus_status(std::vector<bool> & bus_status) const {
         const int nb_ = nb();
         for(int el_id = 0; el_id < nb_; ++el_id)
@@ -186,6 +191,8 @@ class ShuntContainer : public GenericContainer
     
     Eigen::Ref<const RealVect> get_theta() const {return res_theta_;}
     Eigen::Ref<const Eigen::VectorXi> get_bus_id() const {return bus_id_;}
+    Eigen::Ref<const RealVect> get_p_mw() const {return p_mw_;}
+    Eigen::Ref<const RealVect> get_q_mvar() const {return q_mvar_;}
     const std::vector<bool>& get_status() const {return status_;}
 
     protected:
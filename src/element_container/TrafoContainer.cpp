@@ -128,6 +128,16 @@ void TrafoContainer::_update_model_coeffs()
     ydc_tf_ = CplxVect::Zero(my_size);
     ydc_tt_ = CplxVect::Zero(my_size);
     dc_x_tau_shift_ = RealVect::Zero(my_size);
+    // freshly allocated above, so none of these is shared with a copy of this container
+    CplxVect & yac_ff = yac_ff_.mut();
+    CplxVect & yac_ft = yac_ft_.mut();
+    CplxVect & yac_tf = yac_tf_.mut();
+    CplxVect & yac_tt = yac_tt_.mut();
+    CplxVect & ydc_ff = ydc_ff_.mut();
+    CplxVect & ydc_ft = ydc_ft_.mut();
+    CplxVect & ydc_tf = ydc_tf_.mut();
+    CplxVect & ydc_tt = ydc_tt_.mut();
+    RealVect & dc_x_tau_shift = dc_x_tau_shift_.mut();
     for(Eigen::Index i = 0; i < my_size; ++i)
     {
         // for AC
@@ -147,20 +157,20 @@ void TrafoContainer::_update_model_coeffs()
             emitheta_shift = {cos_theta, -sin_theta};
         }
 
-        yac_ff_(i) = (ys + h) / (tau * tau);
-        yac_tt_(i) = (ys + h);
-        yac_tf_(i) = -ys / tau * emitheta_shift ;
-        yac_ft_(i) = -ys / tau * eitheta_shift;
+        yac_ff(i) = (ys + h) / (tau * tau);
+        yac_tt(i) = (ys + h);
+        yac_tf(i) = -ys / tau * emitheta_shift ;
+        yac_ft(i) = -ys / tau * eitheta_shift;
 
         // for DC
         // see https://matpower.org/docs/MATPOWER-manual.pdf eq. 3.21
         // except here I only care about the real part, so I remove the "1/j"
         cplx_type tmp = 1. / (tau * x_(i));
-        ydc_ff_(i) = tmp;
-        ydc_tt_(i) = tmp;
-        ydc_tf_(i) = -tmp;
-        ydc_ft_(i) = -tmp;
-        dc_x_tau_shift_(i) = std::real(tmp) * theta_shift;
+        ydc_ff(i) = tmp;
+        ydc_tt(i) = tmp;
+        ydc_tf(i) = -tmp;
+        ydc_ft(i) = -tmp;
+        dc_x_tau_shift(i) = std::real(tmp) * theta_shift;
     }
 }
 
@@ -245,16 +245,16 @@ class TrafoContainer : public GenericContainer
     Eigen::Ref<const Eigen::VectorXi> get_bus_to() const {return bus_lv_id_;}
 
     // model paramters
-    Eigen::Ref<const CplxVect> yac_ff() const {return yac_ff_;}
-    Eigen::Ref<const CplxVect> yac_ft() const {return yac_ft_;}
-    Eigen::Ref<const CplxVect> yac_tf() const {return yac_tf_;}
-    Eigen::Ref<const CplxVect> yac_tt() const {return yac_tt_;}
+    Eigen::Ref<const CplxVect> yac_ff() const {return *yac_ff_;}
+    Eigen::Ref<const CplxVect> yac_ft() const {return *yac_ft_;}
+    Eigen::Ref<const CplxVect> yac_tf() const {return *yac_tf_;}
+    Eigen::Ref<const CplxVect> yac_tt() const {return *yac_tt_;}
 
-    Eigen::Ref<const CplxVect> ydc_ff() const {return ydc_ff_;}
-    Eigen::Ref<const CplxVect> ydc_ft() const {return ydc_ft_;}
-    Eigen::Ref<const CplxVect> ydc_tf() const {return ydc_tf_;}
-    Eigen::Ref<const CplxVect> ydc_tt() const {return ydc_tt_;}
-    Eigen::Ref<const RealVect> dc_x_tau_shift() const {return dc_x_tau_shift_;}
+    Eigen::Ref<const CplxVect> ydc_ff() const {return *ydc_ff_;}
+    Eigen::Ref<const CplxVect> ydc_ft() const {return *ydc_ft_;}
+    Eigen::Ref<const CplxVect> ydc_tf() const {return *ydc_tf_;}
+    Eigen::Ref<const CplxVect> ydc_tt() const {return *ydc_tt_;}
+    Eigen::Ref<const RealVect> dc_x_tau_shift() const {return *dc_x_tau_shift_;}
     
     const std::vector<bool>& get_status() const {return status_;}
 
@@ -263,17 +263,17 @@ class TrafoContainer : public GenericContainer
         
     protected:
         // physical properties
-        RealVect r_;
-        RealVect x_;
-        CplxVect h_;
-        std::vector<bool> is_tap_hv_side_;  // whether the tap is hav side or not
+        CopyOnWrite<RealVect> r_;
+        CopyOnWrite<RealVect> x_;
+        CopyOnWrite<CplxVect> h_;
+        CopyOnWrite<std::vector<bool>> is_tap_hv_side_;  // whether the tap is hav side or not
 
         // input data
         Eigen::VectorXi bus_hv_id_;
         Eigen::VectorXi bus_lv_id_;
         std::vector<bool> status_;
-        RealVect ratio_;  // transformer ratio
-        RealVect shift_;  // phase shifter (in radian !)
+        CopyOnWrite<RealVect> ratio_;  // transformer ratio
+        CopyOnWrite<RealVect> shift_;  // phase shifter (in radian !)
 
         //output data
         RealVect res_p_hv_;  // in MW
@@ -288,16 +288,16 @@ class TrafoContainer : public GenericContainer
         RealVect res_theta_lv_;  // in degree
 
         // model coefficients
-        CplxVect yac_ff_;
-        CplxVect yac_ft_;
-        CplxVect yac_tf_;
-        CplxVect yac_tt_;
+        CopyOnWrite<CplxVect> yac_ff_;
+        CopyOnWrite<CplxVect> yac_ft_;
+        CopyOnWrite<CplxVect> yac_tf_;
+        CopyOnWrite<CplxVect> yac_tt_;
 
-        CplxVect ydc_ff_;
-        CplxVect ydc_ft_;
-        CplxVect ydc_tf_;
-        CplxVect ydc_tt_;
-        RealVect dc_x_tau_shift_;
+        CopyOnWrite<CplxVect> ydc_ff_;
+        CopyOnWrite<CplxVect> ydc_ft_;
+        CopyOnWrite<CplxVect> ydc_tf_;
+        CopyOnWrite<CplxVect> ydc_tt_;
+        CopyOnWrite<RealVect> dc_x_tau_shift_;
 };
 
 #endif  //TRAFO_CONTAINER_H
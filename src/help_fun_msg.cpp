@@ -146,6 +146,84 @@ const std::string DocSolver::get_timers = R"mydelimiter(
 
 )mydelimiter";
     
+const std::string DocSolver::get_timers_jacobian = R"mydelimiter(
+    Returns information about the time taken by some part of the Newton Raphson solvers (in seconds) during the 
+    last powerflow, as well as the number of factorizations of the jacobian matrix.
+
+    Values that do not make sense for the solver used are -1.
+
+    Returns
+    ---------
+    timer_Fx_: ``float``
+        Time spent to compute the mismatch at the KCL for each bus (both for active and reactive power)
+
+    timer_solve_: ``float``
+        Total time spent in the underlying linear solver
+
+    timer_initialize_: ``float``
+        Time spent to initialize the linear solver
+
+    timer_check_: ``float``
+        Time spent in checking whether or not the mismatch of the KCL met the specified tolerance
+
+    timer_dSbus_: ``float``
+        Time spent to prepare the computation of the derivatives of the power injections with respect to the voltages
+        (current injections at each bus)
+
+    timer_fillJ_: ``float``
+        Time spent to compute these derivatives and to fill the jacobian matrix with them
+
+    timer_Va_Vm_: ``float``
+        Time spent to update the voltages
+
+    timer_pre_proc_: ``float``
+        Time spent in the pre processing of the data
+
+    timer_total_: ``float``
+        Total time spent in the solver
+
+    nb_factorization: ``int``
+        Number of (re)factorizations of the jacobian matrix (lower than the number of iterations when 
+        the factorizations are reused, see `set_jacobian_reuse`)
+
+)mydelimiter";
+
+const std::string DocSolver::set_jacobian_reuse = R"mydelimiter(
+    Reuse the factorization of the jacobian matrix for multiple iterations of the Newton Raphson 
+    algorithm (sometimes called "dishonest" Newton Raphson). It has no effect on the other solvers.
+
+    A factorization is used for at most `refactor_every` iterations. They are counted over successive
+    powerflows as long as only the injections changed, so that a factorization can be reused from one step 
+    of a time series to the next (but not from one contingency, or one topology, to the next). The jacobian is 
+    computed and factorized again sooner when an iteration with an older factorization did not reduce the mismatch
+    by at least `refactor_ratio` (*ie* the new mismatch is above `refactor_ratio` times the previous one). Such an 
+    iteration is also reverted if the mismatch increased: it is then not counted in the maximum number of iterations.
+
+    More iterations are usually performed, but most of them are much cheaper. The results are the same, within
+    the tolerance of the solver.
+
+    By default `refactor_every` is 1: the jacobian is factorized at each iteration (usual Newton Raphson).
+
+    Parameters
+    -----------
+    refactor_every: ``int``
+        Maximum number of iterations that use the same factorization (>= 1)
+
+    refactor_ratio: ``float``
+        Minimum decrease (in ]0, 1]) of the mismatch for the factorization to be kept (default 0.1)
+
+)mydelimiter";
+
+const std::string DocSolver::get_refactor_every = R"mydelimiter(
+    Maximum number of iterations that use the same factorization of the jacobian matrix (see `set_jacobian_reuse`).
+
+)mydelimiter";
+
+const std::string DocSolver::get_refactor_ratio = R"mydelimiter(
+    Minimum decrease of the mismatch for a factorization of the jacobian matrix to be kept (see `set_jacobian_reuse`).
+
+)mydelimiter";
+
 const std::string DocSolver::SparseLUSolver = R"mydelimiter(
     This classes implements the Newton Raphson algorithm, allowing for distributed slack and using the default Eigen sparse solver available in Eigen
     for the linear algebra. 
@@ -1847,6 +1925,125 @@ const std::string DocGridModel::get_dc_solver = R"mydelimiter(
 
 )mydelimiter";
 
+const std::string DocGridModel::set_bus_reordering = R"mydelimiter(
+    Renumber (or not) the buses seen by the solvers with the reverse Cuthill McKee ordering of the graph of the grid.
+
+    This reduces the bandwidth of the Ybus matrix (and of the jacobian) which can speed up the powerflows
+    on large grids whose buses are not ordered "geographically", mainly for the `SparseLU` based solvers
+    (`KLU` and `NICSLU` already compute their own fill reducing ordering).
+
+    This does not change the results: everything labelled with the "gridmodel" bus ids is the same. Only
+    the "solver bus ids" (see :func:`lightsim2grid.gridmodel.GridModel.id_me_to_ac_solver`) and the
+    matrices / vectors returned by the `xxx_solver` functions (for example
+    :func:`lightsim2grid.gridmodel.GridModel.get_Ybus_solver`) are affected. It is ``False`` by default.
+
+    Parameters
+    ----------
+    bus_reordering: ``bool``
+        Whether to renumber the buses of the solvers
+
+    Examples
+    ---------
+
+    .. code-block:: python
+
+        import numpy as np
+        from lightsim2grid.gridmodel import init_from_pandapower
+        import pandapower.networks as pn
+        grid_model = init_from_pandapower(pn.case1888rte())
+        grid_model.set_bus_reordering(True)
+        V0 = np.full(grid_model.total_bus(), 1.04, dtype=complex)
+        V = grid_model.ac_pf(V0, 10, 1e-8)  # V is still labelled with the "gridmodel" bus ids
+
+)mydelimiter";
+
+const std::string DocGridModel::get_bus_reordering = R"mydelimiter(
+    Whether the buses seen by the solvers are renumbered to reduce the bandwidth of the Ybus matrix, 
+    see :func:`lightsim2grid.gridmodel.GridModel.set_bus_reordering`
+
+)mydelimiter";
+
+const std::string DocGridModel::get_ybus_fill_counters = R"mydelimiter(
+    Number of times the Ybus matrices (ac and dc) have been computed since the creation of this
+    grid model, as a tuple `(nb_full, nb_in_place)`:
+
+    - `nb_full` counts the complete computations of Ybus (new sparsity pattern, for example
+      after a change of topology)
+    - `nb_in_place` counts the times only the coefficients of the elements that changed 
+      (for example the shunts) have been updated, without modifying the sparsity pattern.
+
+    .. note::
+        This is mainly used for testing and benchmarking.
+
+)mydelimiter";
+
+const std::string DocGridModel::get_sbus_fill_counters = R"mydelimiter(
+    Number of times the Sbus vectors (ac and dc) have been computed since the creation of this
+    grid model, as a tuple `(nb_full, nb_delta, nb_touched)`:
+
+    - `nb_full` counts the complete computations of Sbus (for example after a change of topology)
+    - `nb_delta` counts the times only the difference between the new and the previous injections of
+      the elements that changed (for example after `update_loads_p`) have been added to Sbus
+    - `nb_touched` is the number of elements whose injection has been used by the last computation
+      (all the elements after a complete computation)
+
+    .. note::
+        This is mainly used for testing and benchmarking.
+
+)mydelimiter";
+
+const std::string DocGridModel::save_state = R"mydelimiter(
+    Saves the current state of the grid and returns an identifier (an `int`) that can be given
+    to :func:`GridModel.restore_state` to undo all the modifications made since then, without
+    copying the grid model.
+
+    The modifications of the elements (status, bus and setpoints, with the `deactivate_xxx`,
+    `reactivate_xxx`, `change_bus_xxx`, `change_p_xxx` etc. or `update_xxx` functions) are recorded
+    in a journal that is used to undo them. The status of the buses and the voltages computed by the
+    last (ac) powerflow are saved as well. Other modifications (of the solver, of the slack, of the
+    physical parameters of the elements etc.) are not.
+
+    The saved states nest like a stack: restoring (or forgetting) a state also removes the ones saved 
+    after it. The memory is reused, so that once a given "depth" has been reached saving and 
+    restoring a state does not allocate memory.
+
+    If no powerflow has been computed since the state was saved, restoring it keeps the Ybus matrix and
+    the solver as they are (the topology is the same as when they were computed).
+
+    Examples
+    ---------
+
+    .. code-block:: python
+
+        # init the grid model
+        from lightsim2grid.gridmodel import init_from_pandapower
+        pp_net = ...  # any pandapower grid
+        gridmodel = init_from_pandapower(pp_net)
+        V = gridmodel.ac_pf(Vinit, 10, 1e-8)
+
+        token = gridmodel.save_state()
+        gridmodel.deactivate_powerline(0)
+        V_n1 = gridmodel.ac_pf(V, 10, 1e-8)
+        gridmodel.restore_state(token)  # powerline 0 is connected again, and `gridmodel.get_V()` is `V`
+
+)mydelimiter";
+
+const std::string DocGridModel::restore_state = R"mydelimiter(
+    Undo all the modifications made since the state `token` (returned by :func:`GridModel.save_state`) 
+    has been saved. This state, and all the states saved after it, are then removed.
+
+    See :func:`GridModel.save_state` for more information.
+
+)mydelimiter";
+
+const std::string DocGridModel::forget_state = R"mydelimiter(
+    Removes the state `token` (returned by :func:`GridModel.save_state`) and all the states saved after 
+    it, without modifying the grid.
+
+    See :func:`GridModel.save_state` for more information.
+
+)mydelimiter";
+
 const std::string DocGridModel::get_lines = R"mydelimiter(
     This function allows to retrieve the powerlines (as a 
     :class:`lightsim2grid.elements.LineContainer` object,
@@ -2895,6 +3092,11 @@ const std::string DocGridModel::ac_pf = R"mydelimiter(
     .. warning::
         The input vector `V` is modified (and is equal to the resulting vector `V`)
 
+    .. note::
+        The python GIL is released during the computation: powerflows on different grid models
+        (for example obtained with :func:`lightsim2grid.gridmodel.GridModel.copy`) can be run in parallel with the 
+        python `threading` module. The same grid model should not be used (nor modified) by two threads at the same time.
+
     Parameters
     ------------
     V:
@@ -3194,6 +3396,14 @@ const std::string DocComputers::amps_computation_time = R"mydelimiter(
 
 )mydelimiter";
 
+const std::string DocComputers::results_computation_time = R"mydelimiter(
+    Time spent in the last call to `compute_results` (branches, generators, shunts and buses results computed
+    from the voltages)
+    
+    It is given in seconds (``float``).
+
+)mydelimiter";
+
 const std::string DocComputers::preprocessing_time = R"mydelimiter(
     Time spent in pre processing the data (this involves, but is not limited to the computation of the Sbus)
     
@@ -3214,6 +3424,226 @@ const std::string DocComputers::get_status = R"mydelimiter(
 
 )mydelimiter";
 
+const std::string DocComputers::get_steps_status = R"mydelimiter(
+    Status of each step of the last call to :func:`lightsim2grid.timeSerie.Computers.compute_Vs`: 
+    1 if the powerflow converged, 0 if it diverged and -1 if it has not been computed (after a divergence, 
+    the next steps of the same chunk are not computed, unless 
+    :func:`lightsim2grid.timeSerie.Computers.set_continue_on_divergence` is used).
+
+    It is a ``numpy.ndarray`` of integers with as many elements as the number of steps.
+
+)mydelimiter";
+
+const std::string DocComputers::get_steps_nb_iter = R"mydelimiter(
+    Number of iterations performed by the solver at each step of the last call to 
+    :func:`lightsim2grid.timeSerie.Computers.compute_Vs` (0 for the steps not computed, 1 for DC solvers).
+
+    It is a ``numpy.ndarray`` of integers with as many elements as the number of steps.
+
+)mydelimiter";
+
+const std::string DocComputers::get_steps_error = R"mydelimiter(
+    Error encountered by the solver at each step of the last call to :func:`lightsim2grid.timeSerie.Computers.compute_Vs`.
+
+    It is a ``numpy.ndarray`` of integers with as many elements as the number of steps, each value being the
+    integer value of a :class:`lightsim2grid.solver.ErrorType` (*eg* ``int(ErrorType.TooManyIterations)``).
+    It is ``int(ErrorType.NoError)`` for the steps that converged and for the steps not computed.
+
+)mydelimiter";
+
+const std::string DocComputers::set_continue_on_divergence = R"mydelimiter(
+    Whether :func:`lightsim2grid.timeSerie.Computers.compute_Vs` goes on when a step diverges.
+
+    By default (``False``) the computation stops at the first step that diverges: the following steps
+    (of the same chunk if multiple threads are used) are not computed. 
+    
+    When it is ``True``, all the steps are computed. The status, number of iterations and error of each 
+    step can be retrieved with :func:`lightsim2grid.timeSerie.Computers.get_steps_status`, 
+    :func:`lightsim2grid.timeSerie.Computers.get_steps_nb_iter` and 
+    :func:`lightsim2grid.timeSerie.Computers.get_steps_error`. The step following a divergence does not start 
+    from the diverged voltages but from the magnitudes of `Vinit` and the voltage angles of a DC powerflow 
+    computed for this step (the solver is also reset).
+
+    Parameters
+    -----------
+    continue_on_divergence:  ``bool``
+        Whether to continue after a divergence
+
+)mydelimiter";
+
+const std::string DocComputers::get_continue_on_divergence = R"mydelimiter(
+    Whether :func:`lightsim2grid.timeSerie.Computers.compute_Vs` goes on when a step diverges 
+    (see :func:`lightsim2grid.timeSerie.Computers.set_continue_on_divergence`).
+
+)mydelimiter";
+
+const std::string DocComputers::total_nb_iter = R"mydelimiter(
+    Total number of iterations performed by the solver during the last call to 
+    :func:`lightsim2grid.timeSerie.Computers.compute_Vs` (sum of :func:`lightsim2grid.timeSerie.Computers.get_steps_nb_iter`).
+
+    The newton step made by the predictor `PredictorType.Jacobian` (see 
+    :func:`lightsim2grid.timeSerie.Computers.set_predictor`) is not counted.
+
+)mydelimiter";
+
+const std::string DocComputers::set_predictor = R"mydelimiter(
+    Choose how the initial voltages of each step are guessed (AC solvers only).
+
+    It is one of:
+
+    - `PredictorType.NoPredictor` (default): the voltages found at the previous step
+    - `PredictorType.Linear`: linear extrapolation of the voltage magnitudes and angles found at the 2
+      previous steps
+    - `PredictorType.Quadratic`: quadratic extrapolation of the voltage magnitudes and angles found at the 3
+      previous steps (linear if only 2 are available)
+    - `PredictorType.Jacobian`: one newton step from the voltages of the previous step for the injections of
+      the current step, using the jacobian factorized at the previous step (nothing is factorized for this step). 
+      The voltages of the previous step are kept if it does not reduce the mismatch. This is only 
+      available for the Newton Raphson based solvers (it has no effect with the others).
+
+    The extrapolations only use the steps that converged just before the current one, with the same topology (see
+    :func:`lightsim2grid.timeSerie.Computers.add_branch_status_event`) and in the same chunk (see 
+    :func:`lightsim2grid.timeSerie.Computers.set_nb_thread`).
+
+    On time series where the injections vary smoothly, `PredictorType.Quadratic` and `PredictorType.Jacobian` can 
+    save one solver iteration per step. The effect can be checked with 
+    :func:`lightsim2grid.timeSerie.Computers.total_nb_iter`.
+
+    Parameters
+    -----------
+    predictor:  :class:`lightsim2grid_cpp.PredictorType`
+        The predictor to use
+
+)mydelimiter";
+
+const std::string DocComputers::get_predictor = R"mydelimiter(
+    The predictor used to guess the initial voltages of each step 
+    (see :func:`lightsim2grid.timeSerie.Computers.set_predictor`).
+
+)mydelimiter";
+
+const std::string DocComputers::set_nb_thread = R"mydelimiter(
+    Set the number of threads used to compute the time series (in :func:`lightsim2grid.timeSerie.Computers.compute_Vs`).
+
+    By default, everything is computed in the calling thread (`nb_thread` is 1) and the voltages found at one step are used
+    as the initial guess of the next step. When it is higher, the steps are split in `nb_thread` contiguous chunks, 
+    each solved in its own thread with its own solver. The first chunk starts from the `Vinit` given to `compute_Vs`, the
+    others start from the magnitudes of `Vinit` and the voltage angles of a DC powerflow computed at their first step. 
+    Inside a chunk the voltages are then propagated from one step to the next.
+
+    .. note::
+        As the initial guesses are not the same, the results can differ slightly (within the solver tolerance) 
+        from the ones computed with a single thread.
+
+    .. note::
+        With a DC solver, all the steps are solved at once (with a single factorization) in the calling thread,
+        whatever the number of threads.
+
+    .. note::
+        The timers (for example :func:`lightsim2grid.timeSerie.Computers.solver_time`) are summed over 
+        all threads, they can be higher than :func:`lightsim2grid.timeSerie.Computers.total_time`
+
+    Parameters
+    -----------
+    nb_thread:  ``int``
+        Number of threads to use (>= 1 integer)
+
+)mydelimiter";
+
+const std::string DocComputers::get_nb_thread = R"mydelimiter(
+    Get the number of threads used to compute the time series. 
+    
+    See :func:`lightsim2grid.timeSerie.Computers.set_nb_thread` for more information.
+
+)mydelimiter";
+
+const std::string DocComputers::add_branch_status_event = R"mydelimiter(
+    Connect or disconnect a branch (powerline or trafo) at a given step of the time series.
+
+    The modification is applied at the beginning of `step` and is kept for all the following steps (until
+    another event modifies the same branch). The topology of the grid model given when this object was 
+    built is used before the first event.
+
+    When there are topology events, the steps are grouped by topology in 
+    :func:`lightsim2grid.timeSerie.Computers.compute_Vs`: the admittance matrix is updated (and factorized)
+    once per distinct topology and not once per step. Disconnecting or reconnecting branches does not modify 
+    the sparsity pattern of the admittance matrix, so the symbolic factorization is kept between the topologies
+    that only differ by the status of some branches.
+
+    .. note::
+        With topology events, the steps are solved in the calling thread (the number of threads is not used)
+        and :func:`lightsim2grid.timeSerie.Computers.compute_results` is not available.
+
+    .. warning::
+        The powerflow diverges (for the steps concerned) if an event splits the grid in multiple islands.
+
+    Parameters
+    -----------
+    step:  ``int``
+        Step at which the branch is connected / disconnected
+
+    branch_id:  ``int``
+        Id of the branch: powerlines are labelled from 0 to `nb_powerline - 1` and trafos from 
+        `nb_powerline` to `nb_powerline + nb_trafo - 1` (same as the columns of the flows)
+
+    connected: ``bool``
+        New status of the branch
+
+)mydelimiter";
+
+const std::string DocComputers::add_branch_bus_event = R"mydelimiter(
+    Change the bus to which one side of a branch (powerline or trafo) is connected at a given step of 
+    the time series.
+
+    See :func:`lightsim2grid.timeSerie.Computers.add_branch_status_event` for more information about the 
+    topology events.
+
+    .. note::
+        If `new_bus_id` is not active in the grid model, it is activated for the steps concerned. Conversely, 
+        a bus left without any element by the events is deactivated for these steps (its voltage is 0.).
+
+    Parameters
+    -----------
+    step:  ``int``
+        Step at which the branch changes bus
+
+    branch_id:  ``int``
+        Id of the branch (powerlines then trafos)
+
+    side:  ``int``
+        0 for the "from" side (origin side of powerlines, high voltage side of trafos), 1 for the "to" side 
+        (extremity side of powerlines, low voltage side of trafos)
+
+    new_bus_id:  ``int``
+        Id of the bus (in the grid model) to connect this side to
+
+)mydelimiter";
+
+const std::string DocComputers::clear_topo_events = R"mydelimiter(
+    Remove all the topology events (see :func:`lightsim2grid.timeSerie.Computers.add_branch_status_event`).
+    The topology of the grid model is then used for all the steps.
+
+)mydelimiter";
+
+const std::string DocComputers::nb_topo_events = R"mydelimiter(
+    Number of topology events added (see :func:`lightsim2grid.timeSerie.Computers.add_branch_status_event`).
+
+)mydelimiter";
+
+const std::string DocComputers::get_steps_topology = R"mydelimiter(
+    Get the id of the topology used at each step in the last call to :func:`lightsim2grid.timeSerie.Computers.compute_Vs`.
+
+    Topologies are numbered in the order they first appear (0 for the topology of the first step). Steps with the same
+    topology id have been solved with the same admittance matrix.
+
+)mydelimiter";
+
+const std::string DocComputers::nb_topologies = R"mydelimiter(
+    Get the number of distinct topologies in the last call to :func:`lightsim2grid.timeSerie.Computers.compute_Vs`
+    (see :func:`lightsim2grid.timeSerie.Computers.get_steps_topology`).
+
+)mydelimiter";
+
 const std::string DocComputers::compute_Vs = R"mydelimiter(
     Compute the voltages (at each bus of the grid model) for some time series of injections (productions, loads, storage units, etc.)
 
@@ -3256,7 +3686,8 @@ const std::string DocComputers::compute_Vs = R"mydelimiter(
     ----------
     status: ``int``
         The status of the computation. 1 means "success": all powerflows were computed sucessfully, 0 means there were some errors and that 
-        the computation stopped after a certain number of steps.
+        the computation stopped after a certain number of steps (see :func:`lightsim2grid.timeSerie.Computers.get_steps_status`
+        for the status of each step).
 
 )mydelimiter";
 
@@ -3288,6 +3719,43 @@ const std::string DocComputers::compute_power_flows = R"mydelimiter(
 
 )mydelimiter";
 
+const std::string DocComputers::compute_results = R"mydelimiter(
+    Compute, from the voltages found by :func:`lightsim2grid.timeSerie.Computers.compute_Vs`, the results 
+    of each step for the families of elements requested. All the steps are computed at once (using the threads
+    set by :func:`lightsim2grid.timeSerie.Computers.set_nb_thread`) and each family is stored in its own matrix 
+    (one row per step).
+
+    The steps that have not converged are left to 0.
+
+    Parameters
+    ----------
+    branch_results: ``bool``
+        Active power (MW), reactive power (MVAr) and current (kA) at both sides of each powerline then each 
+        transformer, see :func:`lightsim2grid.timeSerie.Computers.get_p_or` (and `get_q_or`, `get_a_or`,
+        `get_p_ex`, `get_q_ex`, `get_a_ex`)
+
+    gen_results: ``bool``
+        Reactive power of each generator and active power absorbed by the slack generators, 
+        see :func:`lightsim2grid.timeSerie.Computers.get_gen_q` and :func:`lightsim2grid.timeSerie.Computers.get_gen_p_slack`
+
+    shunt_results: ``bool``
+        Reactive power of each shunt, see :func:`lightsim2grid.timeSerie.Computers.get_shunt_q`
+
+    bus_results: ``bool``
+        Voltage magnitude (kV) of each bus, see :func:`lightsim2grid.timeSerie.Computers.get_bus_v_kv`
+
+    Examples
+    --------
+
+    .. code-block:: python
+
+        time_series.compute_Vs(gen_p, sgen_p, load_p, load_q, v_init, max_iter, tol)
+        time_series.compute_results(True, True, False, False)
+        p_or = time_series.get_p_or()  # matrix nb_step x (nb_line + nb_trafo)
+        gen_q = time_series.get_gen_q()  # matrix nb_step x nb_gen
+
+)mydelimiter";
+
 const std::string DocComputers::get_flows = R"mydelimiter(
     Get the current flows (in kA) at the origin side / high voltage side of each transformers / powerlines.
 
@@ -3320,6 +3788,59 @@ const std::string DocComputers::get_power_flows = R"mydelimiter(
 
 )mydelimiter";
 
+const std::string DocComputers::get_branch_results = R"mydelimiter(
+    Get the active power (MW, `get_p_or` and `get_p_ex`), reactive power (MVAr, `get_q_or` and `get_q_ex`) or current 
+    (kA, `get_a_or` and `get_a_ex`) at the origin side / high voltage side (`_or`) or at the extremity side / low voltage
+    side (`_ex`) of each powerline then each transformer.
+
+    Each rows correspond to a time step, each column to a powerline / transformer.
+
+    .. warning::
+        This function must be called after `compute_results` has been called with `branch_results=True`
+
+)mydelimiter";
+
+const std::string DocComputers::get_gen_q = R"mydelimiter(
+    Get the reactive power (in MVAr) of each generator (0. in DC).
+
+    Each rows correspond to a time step, each column to a generator.
+
+    .. warning::
+        This function must be called after `compute_results` has been called with `gen_results=True`
+
+)mydelimiter";
+
+const std::string DocComputers::get_gen_p_slack = R"mydelimiter(
+    Get the active power (in MW) absorbed by each slack generator, to be added to their active power setpoint
+    (0. for the generators that do not participate to the slack).
+
+    Each rows correspond to a time step, each column to a generator.
+
+    .. warning::
+        This function must be called after `compute_results` has been called with `gen_results=True`
+
+)mydelimiter";
+
+const std::string DocComputers::get_shunt_q = R"mydelimiter(
+    Get the reactive power (in MVAr) of each shunt (0. in DC).
+
+    Each rows correspond to a time step, each column to a shunt.
+
+    .. warning::
+        This function must be called after `compute_results` has been called with `shunt_results=True`
+
+)mydelimiter";
+
+const std::string DocComputers::get_bus_v_kv = R"mydelimiter(
+    Get the voltage magnitude (in kV) at each bus of the powergrid (0. for disconnected buses).
+
+    Each rows correspond to a time step, each column to a bus.
+
+    .. warning::
+        This function must be called after `compute_results` has been called with `bus_results=True`
+
+)mydelimiter";
+
 const std::string DocComputers::get_voltages = R"mydelimiter(
     Get the complex voltage angles at each bus of the powergrid.
 
@@ -3343,6 +3864,10 @@ const std::string DocComputers::get_sbuses = R"mydelimiter(
 
     Each rows correspond to a time step, each column to a bus (bus are identified by their solver id !)
 
+    .. note::
+        The solver id are the ones of the topology of the grid model, topology events (see 
+        :func:`lightsim2grid.timeSerie.Computers.add_branch_status_event`) are not taken into account.
+
     .. warning::
         This function must be called after :func:`lightsim2grid.timeSerie.Computers.compute_Vs`.
 
@@ -3412,6 +3937,31 @@ const std::string DocSecurityAnalysis::modif_Ybus_time = R"mydelimiter(
 
 )mydelimiter";
 
+const std::string DocSecurityAnalysis::set_nb_thread = R"mydelimiter(
+    Set the number of threads used to simulate the contingencies (in :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute`).
+
+    By default, everything is computed in the calling thread (`nb_thread` is 1). When it is higher,
+    the contingencies are split between the different threads, each having its own solver. 
+    The results are exactly the same as the ones computed with a single thread.
+
+    .. note::
+        The timers (for example :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.solver_time`) are summed over 
+        all threads, they can be higher than :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.total_time`
+
+    Parameters
+    -----------
+    nb_thread:  ``int``
+        Number of threads to use (>= 1 integer)
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::get_nb_thread = R"mydelimiter(
+    Get the number of threads used to simulate the contingencies. 
+    
+    See :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.set_nb_thread` for more information.
+
+)mydelimiter";
+
 const std::string DocSecurityAnalysis::add_all_n1 = R"mydelimiter(
     This allows to add all the "n-1" in the contingency list to simulate.
 
@@ -3556,6 +4106,312 @@ const std::string DocSecurityAnalysis::compute = R"mydelimiter(
 
 )mydelimiter";
 
+const std::string DocSecurityAnalysis::compute_lodf = R"mydelimiter(
+    Compute the active power flows (in MW, at the origin of each powerlines / high voltage side of each transformers) 
+    after each contingency, in the DC approximation, using the LODF (Line Outage Distribution Factors).
+
+    The flows and the PTDF of the base case are computed once, then the flows after each contingency are obtained with 
+    a single matrix vector product (or with the "generalized" LODF when multiple elements are disconnected at once). 
+    No powerflow is run, unless the LODF cannot be used for a given contingency (*ie* when `1 - LODF_ii` is
+    bellow :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_lodf_tol`).
+
+    Results can be retrieved with :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_power_flows`. The voltages
+    are not computed (and :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_flows` cannot be used after this function).
+    
+    If a contingency disconnects the grid, the flows for this contingency will be `NaN`.
+
+    .. note::
+        The results do not depend on the solver used (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.change_solver`), 
+        they are always computed in the DC approximation.
+
+    .. note::
+        During this computation, the GIL is released, allowing easier parrallel computation
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::set_lodf_tol = R"mydelimiter(
+    Tolerance used in :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_lodf`: when `1 - LODF_ii` is bellow this
+    value (in absolute value) a DC powerflow is run for this contingency instead of using the LODF.
+
+    It defaults to `1e-8`.
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::compute_screened = R"mydelimiter(
+    Perform a contingency analysis in two stages.
+
+    First all the contingencies are "screened" with the LODF (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_lodf`),
+    the current on each branch is estimated from these DC flows (assuming all voltage magnitudes are 1 pu) and compared to
+    the `thermal_limits` (in kA, same unit as :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_flows`). 
+    The loading of the most loaded branch for each contingency can be retrieved with 
+    :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_screening_loading` (it is `inf` if the grid is split, 
+    in this case the contingency is never simulated with the solver).
+
+    Then a "real" powerflow (with the solver of this class, see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.change_solver`)
+    is run only for the contingencies with a loading above `loading_threshold`, and at most for `max_nb_verified` of them 
+    (the most loaded ones). Use a negative `max_nb_verified` to simulate all the contingencies above the threshold.
+
+    Results are then retrieved the same way as after :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute`. Only the
+    contingencies flagged by :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_verified` have been simulated, the 
+    voltages of the other ones are 0.
+
+    .. note::
+        During this computation, the GIL is released, allowing easier parrallel computation
+
+    Parameters
+    ----------
+    Vinit: ``numpy.ndarray``, complex
+        The initial voltage vector (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute`)
+
+    max_iter: ``int``
+        The maximum number of iterations of the solver
+
+    tol: ``float``
+        The tolerance of the solver
+
+    thermal_limits: ``numpy.ndarray``, float
+        The thermal limits (in kA) of all the powerlines then all the transformers
+
+    loading_threshold: ``float``
+        Contingencies with an estimated loading bellow this value are not simulated (eg `0.9` for 90% of the thermal limit)
+
+    max_nb_verified: ``int``
+        Maximum number of contingencies simulated with the solver (no limit if negative)
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::get_verified = R"mydelimiter(
+    For each contingency, whether (1) or not (0) it has been simulated with the solver at the last 
+    call to :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute` (always 1 in this case, unless the powerflow of 
+    the base case diverged) or :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_screened`.
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::set_result_sink = R"mydelimiter(
+    Use a "streaming" mode: the results of each contingency are sent to the `sink` as soon as it is 
+    simulated (by :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute` or 
+    :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_screened`) instead of being stored in 
+    a dense "nb contingencies x nb buses" matrix. The memory used does not depend on the number of contingencies.
+
+    In this mode, :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_voltages` is empty
+    (and :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_flows` cannot be used).
+
+    .. note::
+        The sink is never called concurrently, even if multiple threads are used 
+        (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.set_nb_thread`), but the contingencies
+        are then not necessarily received in order.
+
+    Parameters
+    ----------
+    sink: :class:`lightsim2grid_cpp.ContingencyResultSink`
+        Where to send the results, for example a :class:`lightsim2grid_cpp.ContingencyCallbackSink`, a 
+        :class:`lightsim2grid_cpp.ContingencyQueueSink` or a :class:`lightsim2grid_cpp.ContingencyFileSink`
+
+    with_flows: ``bool``
+        Whether to also send the current flows (in kA, same as :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_flows`)
+        of each contingency
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::clear_result_sink = R"mydelimiter(
+    Go back to the default mode: results are stored in dense matrices 
+    (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.set_result_sink`)
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::has_result_sink = R"mydelimiter(
+    Whether the results are sent to a sink (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.set_result_sink`)
+    instead of being stored in dense matrices.
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::ContingencyResultSink = R"mydelimiter(
+    Base class of the objects receiving the results of a contingency analysis one contingency at a time, 
+    see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.set_result_sink`
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::ContingencyCallbackSink = R"mydelimiter(
+    Calls the given function for each contingency with the arguments `(cont_id, converged, V, amps_flows)`:
+
+    - `cont_id` (``int``): the index of the contingency (in :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.my_defaults`)
+    - `converged` (``bool``): whether the powerflow converged (`V` is 0. otherwise)
+    - `V` (``numpy.ndarray``, complex): the voltage at each bus of the grid
+    - `amps_flows` (``numpy.ndarray``, float): the current flows, empty if they are not requested
+
+    .. warning::
+        The GIL is acquired each time the function is called, this sink is the slowest one.
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::ContingencyQueueSink = R"mydelimiter(
+    Stores the results in a queue of at most `max_size` elements, to be consumed with 
+    :func:`lightsim2grid_cpp.ContingencyQueueSink.pop`. The computation waits while the queue is full, 
+    so the queue should be consumed from another thread than the one performing the computation.
+
+    Examples
+    --------
+
+    .. code-block:: python
+
+        import threading
+        from lightsim2grid_cpp import ContingencyQueueSink
+
+        sink = ContingencyQueueSink(100)
+        SA.set_result_sink(sink, True)
+        th = threading.Thread(target=SA.compute, args=(V, max_iter, tol))
+        th.start()
+        while (res := sink.pop()) is not None:
+            cont_id, converged, V, amps_flows = res
+            ...
+        th.join()
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::ContingencyQueueSink_pop = R"mydelimiter(
+    Wait for the next result and returns the tuple `(cont_id, converged, V, amps_flows)` 
+    (see :class:`lightsim2grid_cpp.ContingencyCallbackSink`), or `None` when the computation is over 
+    and all the results have been consumed.
+
+    .. note::
+        The GIL is released while waiting.
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::ContingencyQueueSink_max_size = R"mydelimiter(
+    Maximum number of results waiting to be consumed (the `max_size` given when the sink was created): 
+    the computation waits when it is reached.
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::ContingencyQueueSink_size = R"mydelimiter(
+    Number of results currently waiting to be consumed with :func:`lightsim2grid_cpp.ContingencyQueueSink.pop`.
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::ContingencyFileSink = R"mydelimiter(
+    Writes the results to a binary file, each contingency being stored in a fixed size record
+    (cont_id: int64, converged: int64, V: nb_bus complex128 and, if requested, amps_flows: nb_branch float64).
+
+    The file is overwritten at the beginning of each computation: it only contains the results of the last one
+    (all its records then have the same size, see :func:`lightsim2grid_cpp.ContingencyFileSink.record_size`).
+
+    The file can be read without being loaded in memory with:
+
+    .. code-block:: python
+
+        import numpy as np
+        dtype = np.dtype([("cont_id", np.int64), ("converged", np.int64), 
+                          ("V", np.complex128, nb_bus), ("amps_flows", np.float64, nb_branch)])
+        res = np.memmap(path, dtype=dtype, mode="r")
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::update_grid = R"mydelimiter(
+    Modify the base case of the contingency analysis (the internal grid model), with the same arguments as the 
+    corresponding method of :class:`lightsim2grid.gridmodel.GridModel`. 
+
+    This is much faster than creating a new :class:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP`: the powerflow of 
+    the base case is performed again at the next computation, but the list of contingencies is kept and, if only the injections
+    are modified, the coefficients of the admittance matrix to modify for each contingency, the analysis of the 
+    connectivity of the grid and the symbolic factorization of the solver are reused.
+
+    .. seealso:: :func:`lightsim2grid.contingencyAnalysis.ContingencyAnalysis.update_grid` to use it directly with
+        a grid2op action.
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::set_aggregation = R"mydelimiter(
+    Reduce the results "online": each time a contingency converges (in :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute`
+    or :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_screened`) the following results are updated:
+
+    - the maximum current flow of each branch (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_max_flows`)
+    - the contingency responsible for it (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_max_flows_cont`)
+    - the number of contingencies for which the current flow of each branch is above `loading_threshold * thermal_limits`
+      (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_nb_violations`)
+    - the minimum and maximum voltage magnitude of each bus (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_min_vm`
+      and :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_max_vm`)
+
+    These are the same as the reductions of the results of :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_flows`
+    and :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.get_voltages`, but they can be used with 
+    :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.set_result_sink` so that no dense matrix is ever stored.
+
+    Parameters
+    ----------
+    thermal_limits: ``numpy.ndarray``, float
+        The thermal limit (in kA) of each powerline then each trafo. Branches with a limit <= 0. are never in violation.
+
+    loading_threshold: ``float``
+        A branch is in violation if its current is strictly above `loading_threshold * thermal_limits`
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::clear_aggregation = R"mydelimiter(
+    Stop reducing the results (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.set_aggregation`)
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::has_aggregation = R"mydelimiter(
+    Whether the results are reduced "online" (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.set_aggregation`).
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::get_max_flows = R"mydelimiter(
+    For each branch (powerlines then trafos) the maximum current flow (in kA) over all the converged contingencies 
+    (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.set_aggregation`)
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::get_max_flows_cont = R"mydelimiter(
+    For each branch (powerlines then trafos) the index of the contingency (in :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.my_defaults`)
+    responsible for its maximum current flow, or -1 if the flow is always 0. (in case of equality, the lowest index is returned)
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::get_nb_violations = R"mydelimiter(
+    For each branch (powerlines then trafos) the number of converged contingencies for which the current flow is above 
+    the limit (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.set_aggregation`)
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::get_min_vm = R"mydelimiter(
+    For each bus, the minimum voltage magnitude (in pu) over all the converged contingencies (`NaN` if the bus 
+    is never connected)
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::get_max_vm = R"mydelimiter(
+    For each bus, the maximum voltage magnitude (in pu) over all the converged contingencies (`NaN` if the bus 
+    is never connected)
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::ContingencyFileSink_path = R"mydelimiter(
+    Path of the file in which the results are written.
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::ContingencyFileSink_record_size = R"mydelimiter(
+    Size (in bytes) of the record of one contingency, with the settings of the last computation: 
+    `16 + 16 * nb_bus`, plus `8 * nb_branch` if the flows were requested. It is 16 before any computation.
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::get_screening_loading = R"mydelimiter(
+    For each contingency, the loading of its most loaded branch estimated by the screening stage of the last call to 
+    :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_screened`: current flow computed from the DC flows 
+    (all voltage magnitudes at 1 pu) divided by the `thermal_limits`. It is `inf` if the contingency splits the grid.
+
+    It is empty if the last computation was not :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_screened`.
+
+)mydelimiter";
+
+const std::string DocSecurityAnalysis::get_lodf_tol = R"mydelimiter(
+    Tolerance currently used in :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute_lodf` 
+    (see :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.set_lodf_tol`).
+
+)mydelimiter";
+
 const std::string DocSecurityAnalysis::compute_flows = R"mydelimiter(
     Compute the current flows (in amps, at the origin of each powerlines / high voltage size of each transformers.
 
@@ -3625,6 +4481,18 @@ const std::string DocSecurityAnalysis::get_voltages = R"mydelimiter(
 
 )mydelimiter";
 
+const std::string DocSecurityAnalysis::compute_results = R"mydelimiter(
+    Compute, from the voltages found by :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.compute`, the 
+    results of each contingency for the families of elements requested (see 
+    :func:`lightsim2grid.timeSerie.Computers.compute_results` for the meaning of each argument and the
+    functions to retrieve the results). There is one row per contingency, in the order of 
+    :func:`lightsim2grid.securityAnalysis.SecurityAnalysisCPP.my_defaults`.
+
+    The branches disconnected by a contingency have no flows, the contingencies that did not converge
+    are left to 0.
+
+)mydelimiter";
+
 const std::string DocSecurityAnalysis::get_power_flows = R"mydelimiter(
     Get the active flows (in MW) at the origin side / high voltage side of each transformers / powerlines.
 
@@ -27,6 +27,10 @@ struct DocSolver
     static const std::string converged;
     static const std::string compute_pf;
     static const std::string get_timers;
+    static const std::string get_timers_jacobian;
+    static const std::string set_jacobian_reuse;
+    static const std::string get_refactor_every;
+    static const std::string get_refactor_ratio;
 
     // solver description
     static const std::string SparseLUSolver;
@@ -179,6 +183,13 @@ struct DocGridModel
     static const std::string get_dc_solver_type;
     static const std::string get_solver;
     static const std::string get_dc_solver;
+    static const std::string set_bus_reordering;
+    static const std::string get_bus_reordering;
+    static const std::string get_ybus_fill_counters;
+    static const std::string get_sbus_fill_counters;
+    static const std::string save_state;
+    static const std::string restore_state;
+    static const std::string forget_state;
 
     // accessor
     static const std::string get_lines;
@@ -246,17 +257,42 @@ struct DocComputers
     static const std::string solver_time;
     static const std::string preprocessing_time;
     static const std::string amps_computation_time;
+    static const std::string results_computation_time;
     static const std::string nb_solved;
     static const std::string get_status;
+    static const std::string get_steps_status;
+    static const std::string get_steps_nb_iter;
+    static const std::string get_steps_error;
+    static const std::string set_continue_on_divergence;
+    static const std::string get_continue_on_divergence;
+    static const std::string total_nb_iter;
+    static const std::string set_predictor;
+    static const std::string get_predictor;
+
+    static const std::string set_nb_thread;
+    static const std::string get_nb_thread;
+
+    static const std::string add_branch_status_event;
+    static const std::string add_branch_bus_event;
+    static const std::string clear_topo_events;
+    static const std::string nb_topo_events;
+    static const std::string get_steps_topology;
+    static const std::string nb_topologies;
 
     static const std::string compute_Vs;
     static const std::string compute_flows;
     static const std::string compute_power_flows;
+    static const std::string compute_results;
 
     static const std::string get_flows;
     static const std::string get_power_flows;
     static const std::string get_voltages;
     static const std::string get_sbuses;
+    static const std::string get_branch_results;
+    static const std::string get_gen_q;
+    static const std::string get_gen_p_slack;
+    static const std::string get_shunt_q;
+    static const std::string get_bus_v_kv;
     static const std::string clear;
 };
 
@@ -267,6 +303,9 @@ struct DocSecurityAnalysis
     static const std::string preprocessing_time;
     static const std::string modif_Ybus_time;
 
+    static const std::string set_nb_thread;
+    static const std::string get_nb_thread;
+
     static const std::string add_all_n1;
     static const std::string add_n1;
     static const std::string add_nk;
@@ -281,6 +320,37 @@ struct DocSecurityAnalysis
     static const std::string compute;
     static const std::string compute_flows;
     static const std::string compute_power_flows;
+    static const std::string compute_results;
+    static const std::string compute_lodf;
+    static const std::string set_lodf_tol;
+    static const std::string compute_screened;
+    static const std::string get_verified;
+    static const std::string get_screening_loading;
+    static const std::string get_lodf_tol;
+
+    static const std::string set_result_sink;
+    static const std::string clear_result_sink;
+    static const std::string has_result_sink;
+    static const std::string ContingencyResultSink;
+    static const std::string ContingencyCallbackSink;
+    static const std::string ContingencyQueueSink;
+    static const std::string ContingencyQueueSink_pop;
+    static const std::string ContingencyQueueSink_max_size;
+    static const std::string ContingencyQueueSink_size;
+    static const std::string ContingencyFileSink;
+    static const std::string ContingencyFileSink_path;
+    static const std::string ContingencyFileSink_record_size;
+
+    static const std::string update_grid;
+
+    static const std::string set_aggregation;
+    static const std::string clear_aggregation;
+    static const std::string has_aggregation;
+    static const std::string get_max_flows;
+    static const std::string get_max_flows_cont;
+    static const std::string get_nb_violations;
+    static const std::string get_min_vm;
+    static const std::string get_max_vm;
 
     static const std::string get_flows;
     static const std::string get_voltages;
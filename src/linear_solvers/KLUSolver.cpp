@@ -10,7 +10,7 @@
 
 #include <iostream>
 
-const bool KLULinearSolver::CAN_SOLVE_MAT = false;
+const bool KLULinearSolver::CAN_SOLVE_MAT = true;
 
 ErrorType KLULinearSolver::reset(){
     klu_free_symbolic(&symbolic_, &common_);
@@ -76,3 +76,21 @@ ErrorType KLULinearSolver::solve(const Eigen::SparseMatrix<real_type>& J, RealVe
     }
     return err;
 }
+
+ErrorType KLULinearSolver::solve(const Eigen::SparseMatrix<real_type>& J, RealMat & B, bool doesnt_need_refactor){
+    // solves (for X) the linear system J.X = B, all the columns of B are solved in a single call to klu_solve
+    int ok;
+    if(!doesnt_need_refactor){
+        ok = klu_refactor(const_cast<Eigen::SparseMatrix<real_type>::StorageIndex *>(J.outerIndexPtr()),
+                          const_cast<Eigen::SparseMatrix<real_type>::StorageIndex *>(J.innerIndexPtr()),
+                          const_cast<real_type*>(J.valuePtr()),
+                          symbolic_, numeric_, &common_);
+        if (ok != 1) return ErrorType::SolverReFactor;
+    }
+    if(B.cols() == 0) return ErrorType::NoError;
+    // B is column major, so the leading dimension is the number of rows
+    const auto n = J.cols();
+    ok = klu_solve(symbolic_, numeric_, n, B.cols(), B.data(), &common_);
+    if (ok != 1) return ErrorType::SolverSolve;
+    return ErrorType::NoError;
+}
@@ -103,3 +103,15 @@ ErrorType NICSLULinearSolver::solve(const Eigen::SparseMatrix<real_type> & J, Re
     }
     return err;
 }
+
+ErrorType NICSLULinearSolver::solve(const Eigen::SparseMatrix<real_type> & J, RealMat & B, bool doesnt_need_refactor){
+    // solves (for X) the linear system J.X = B, one column at a time (the matrix is refactorized at most once)
+    RealVect b;
+    for(Eigen::Index col_id = 0; col_id < B.cols(); ++col_id){
+        b = B.col(col_id);
+        ErrorType err = solve(J, b, doesnt_need_refactor || (col_id > 0));
+        if(err != ErrorType::NoError) return err;
+        B.col(col_id) = b;
+    }
+    return ErrorType::NoError;
+}
@@ -55,6 +55,8 @@ class NICSLULinearSolver
         ErrorType reset();
         ErrorType initialize(const Eigen::SparseMatrix<real_type> & J);
         ErrorType solve(const Eigen::SparseMatrix<real_type> & J, RealVect & b, bool doesnt_need_refactor);
+        // same as above, with one right hand side per column of B
+        ErrorType solve(const Eigen::SparseMatrix<real_type> & J, RealMat & B, bool doesnt_need_refactor);
 
         // can this linear solver solve problem where RHS is a matrix
         static const bool CAN_SOLVE_MAT;
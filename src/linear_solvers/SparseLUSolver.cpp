@@ -48,3 +48,15 @@ ErrorType SparseLULinearSolver::solve(const Eigen::SparseMatrix<real_type> & J,
     }
     return err;
 }
+
+ErrorType SparseLULinearSolver::solve(const Eigen::SparseMatrix<real_type> & J, RealMat & B, bool doesnt_need_refactor){
+    // solves (for X) the linear system J.X = B
+    if(!doesnt_need_refactor){
+        solver_.factorize(J);
+        if (solver_.info() != Eigen::Success) return ErrorType::SolverFactor;
+    }
+    RealMat X = solver_.solve(B);
+    if (solver_.info() != Eigen::Success) return ErrorType::SolverSolve;
+    B = X;
+    return ErrorType::NoError;
+}
@@ -35,6 +35,8 @@ class SparseLULinearSolver
         // public api
         ErrorType initialize(const Eigen::SparseMatrix<real_type> & J);
         ErrorType solve(const Eigen::SparseMatrix<real_type> & J, RealVect & b, bool doesnt_need_refactor);
+        // same as above, with one right hand side per column of B
+        ErrorType solve(const Eigen::SparseMatrix<real_type> & J, RealMat & B, bool doesnt_need_refactor);
         ErrorType reset(){return ErrorType::NoError; }
 
         // can this linear solver solve problem where RHS is a matrix
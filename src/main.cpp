@@ -9,6 +9,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
 #include <pybind11/stl.h>
+#include <pybind11/functional.h>
 
 #include "ChooseSolver.h"
 #include "DataConverter.h"
@@ -132,6 +133,7 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
         .def("converged", &SparseLUSolver::converged, DocSolver::converged.c_str())  // whether the solver has converged
         .def("compute_pf", &SparseLUSolver::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str())  // perform the newton raphson optimization
         .def("get_timers", &SparseLUSolver::get_timers, DocSolver::get_timers.c_str())  // returns the timers corresponding to times the solver spent in different part
+        .def("set_jacobian_reuse", &SparseLUSolver::set_jacobian_reuse, DocSolver::set_jacobian_reuse.c_str())
         .def("solve", &SparseLUSolver::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str());  // perform the newton raphson optimization
     
     py::class_<SparseLUSolverSingleSlack>(m, "SparseLUSolverSingleSlack", DocSolver::SparseLUSolverSingleSlack.c_str())
@@ -146,6 +148,7 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
         .def("converged", &SparseLUSolverSingleSlack::converged, DocSolver::converged.c_str())  // whether the solver has converged
         .def("compute_pf", &SparseLUSolverSingleSlack::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str())  // perform the newton raphson optimization
         .def("get_timers", &SparseLUSolverSingleSlack::get_timers, DocSolver::get_timers.c_str())  // returns the timers corresponding to times the solver spent in different part
+        .def("set_jacobian_reuse", &SparseLUSolverSingleSlack::set_jacobian_reuse, DocSolver::set_jacobian_reuse.c_str())
         .def("solve", &SparseLUSolverSingleSlack::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str());  // perform the newton raphson optimization
 
     py::class_<DCSolver>(m, "DCSolver", DocSolver::DCSolver.c_str())
@@ -204,6 +207,7 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
             .def("converged", &KLUSolver::converged, DocSolver::converged.c_str())  // whether the solver has converged
             .def("compute_pf", &KLUSolver::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str())  // perform the newton raphson optimization
             .def("get_timers", &KLUSolver::get_timers, DocSolver::get_timers.c_str())  // returns the timers corresponding to times the solver spent in different part
+            .def("set_jacobian_reuse", &KLUSolver::set_jacobian_reuse, DocSolver::set_jacobian_reuse.c_str())
             .def("solve", &KLUSolver::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str() );  // perform the newton raphson optimization
         
         py::class_<KLUSolverSingleSlack>(m, "KLUSolverSingleSlack", DocSolver::KLUSolverSingleSlack.c_str())
@@ -218,6 +222,7 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
             .def("converged", &KLUSolverSingleSlack::converged, DocSolver::converged.c_str())  // whether the solver has converged
             .def("compute_pf", &KLUSolverSingleSlack::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str())  // perform the newton raphson optimization
             .def("get_timers", &KLUSolverSingleSlack::get_timers, DocSolver::get_timers.c_str())  // returns the timers corresponding to times the solver spent in different part
+            .def("set_jacobian_reuse", &KLUSolverSingleSlack::set_jacobian_reuse, DocSolver::set_jacobian_reuse.c_str())
             .def("solve", &KLUSolverSingleSlack::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str());  // perform the newton raphson optimization
         
         py::class_<KLUDCSolver>(m, "KLUDCSolver", DocSolver::KLUDCSolver.c_str())
@@ -274,6 +279,7 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
             .def("converged", &NICSLUSolver::converged, DocSolver::converged.c_str())  // whether the solver has converged
             .def("compute_pf", &NICSLUSolver::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str())  // perform the newton raphson optimization
             .def("get_timers", &NICSLUSolver::get_timers, DocSolver::get_timers.c_str())  // returns the timers corresponding to times the solver spent in different part
+            .def("set_jacobian_reuse", &NICSLUSolver::set_jacobian_reuse, DocSolver::set_jacobian_reuse.c_str())
             .def("solve", &NICSLUSolver::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str());  // perform the newton raphson optimization
         
         py::class_<NICSLUSolverSingleSlack>(m, "NICSLUSolverSingleSlack", DocSolver::NICSLUSolverSingleSlack.c_str())
@@ -288,6 +294,7 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
             .def("converged", &NICSLUSolverSingleSlack::converged, DocSolver::converged.c_str())  // whether the solver has converged
             .def("compute_pf", &NICSLUSolverSingleSlack::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str())  // perform the newton raphson optimization
             .def("get_timers", &NICSLUSolverSingleSlack::get_timers, DocSolver::get_timers.c_str())  // returns the timers corresponding to times the solver spent in different part
+            .def("set_jacobian_reuse", &NICSLUSolverSingleSlack::set_jacobian_reuse, DocSolver::set_jacobian_reuse.c_str())
             .def("solve", &NICSLUSolverSingleSlack::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str());  // perform the newton raphson optimization
         
         py::class_<NICSLUDCSolver>(m, "NICSLUDCSolver", DocSolver::NICSLUDCSolver.c_str())
@@ -344,6 +351,7 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
             .def("converged", &CKTSOSolver::converged, DocSolver::converged.c_str())  // whether the solver has converged
             .def("compute_pf", &CKTSOSolver::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str())  // perform the newton raphson optimization
             .def("get_timers", &CKTSOSolver::get_timers, DocSolver::get_timers.c_str())  // returns the timers corresponding to times the solver spent in different part
+            .def("set_jacobian_reuse", &CKTSOSolver::set_jacobian_reuse, DocSolver::set_jacobian_reuse.c_str())
             .def("solve", &CKTSOSolver::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str());  // perform the newton raphson optimization
         
         py::class_<CKTSOSolverSingleSlack>(m, "CKTSOSolverSingleSlack", DocSolver::CKTSOSolverSingleSlack.c_str())
@@ -358,6 +366,7 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
             .def("converged", &CKTSOSolverSingleSlack::converged, DocSolver::converged.c_str())  // whether the solver has converged
             .def("compute_pf", &CKTSOSolverSingleSlack::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str())  // perform the newton raphson optimization
             .def("get_timers", &CKTSOSolverSingleSlack::get_timers, DocSolver::get_timers.c_str())  // returns the timers corresponding to times the solver spent in different part
+            .def("set_jacobian_reuse", &CKTSOSolverSingleSlack::set_jacobian_reuse, DocSolver::set_jacobian_reuse.c_str())
             .def("solve", &CKTSOSolverSingleSlack::compute_pf, py::call_guard<py::gil_scoped_release>(), DocSolver::compute_pf.c_str());  // perform the newton raphson optimization
         
         py::class_<CKTSODCSolver>(m, "CKTSODCSolver", DocSolver::CKTSODCSolver.c_str())
@@ -445,7 +454,7 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
         .def("converged", &ChooseSolver::converged, DocSolver::converged.c_str()) 
         .def("get_computation_time", &ChooseSolver::get_computation_time, DocSolver::get_computation_time.c_str())
         .def("get_timers", &ChooseSolver::get_timers, "TODO")
-        .def("get_timers_jacobian", &ChooseSolver::get_timers_jacobian, "TODO")
+        .def("get_timers_jacobian", &ChooseSolver::get_timers_jacobian, DocSolver::get_timers_jacobian.c_str())
         .def("get_timers_ptdf_lodf", &ChooseSolver::get_timers_ptdf_lodf, "TODO")
         .def("get_fdpf_xb_lu", &ChooseSolver::get_fdpf_xb_lu, py::return_value_policy::reference, DocGridModel::_internal_do_not_use.c_str())  // TODO this for all solver !
         .def("get_fdpf_bx_lu", &ChooseSolver::get_fdpf_bx_lu, py::return_value_policy::reference, DocGridModel::_internal_do_not_use.c_str());
@@ -722,6 +731,8 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
         .def("get_dc_solver_type", &GridModel::get_dc_solver_type, DocGridModel::get_dc_solver_type.c_str())  // get the type of solver used
         .def("get_solver", &GridModel::get_solver, py::return_value_policy::reference, DocGridModel::get_solver.c_str())  // get the solver (AnySolver type python side) used
         .def("get_dc_solver", &GridModel::get_dc_solver, py::return_value_policy::reference, DocGridModel::get_dc_solver.c_str())  // get the solver (AnySolver type python side) used
+        .def("set_bus_reordering", &GridModel::set_bus_reordering, py::arg("bus_reordering"), DocGridModel::set_bus_reordering.c_str())
+        .def("get_bus_reordering", &GridModel::get_bus_reordering, DocGridModel::get_bus_reordering.c_str())
 
         // init the grid
         .def("init_bus", &GridModel::init_bus, DocGridModel::_internal_do_not_use.c_str())
@@ -875,7 +886,7 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
         .def("get_Sbus_solver", &GridModel::get_Sbus_solver, DocGridModel::get_Sbus_solver.c_str())
         .def("get_dcSbus_solver", &GridModel::get_dcSbus_solver, DocGridModel::get_dcSbus_solver.c_str())
 
-        .def("check_solution", &GridModel::check_solution, DocGridModel::check_solution.c_str())
+        .def("check_solution", &GridModel::check_solution, py::call_guard<py::gil_scoped_release>(), DocGridModel::check_solution.c_str())
 
         // TODO optimize that for speed, results are copied apparently
         .def("get_loads_res", &GridModel::get_loads_res, DocGridModel::_internal_do_not_use.c_str())
@@ -920,18 +931,24 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
         // do something with the grid
         .def("deactivate_result_computation", &GridModel::deactivate_result_computation, DocGridModel::deactivate_result_computation.c_str())
         .def("reactivate_result_computation", &GridModel::reactivate_result_computation, DocGridModel::reactivate_result_computation.c_str())
-        .def("dc_pf", &GridModel::dc_pf, DocGridModel::dc_pf.c_str())
-        .def("ac_pf", &GridModel::ac_pf, DocGridModel::ac_pf.c_str())
+        .def("dc_pf", &GridModel::dc_pf, py::call_guard<py::gil_scoped_release>(), DocGridModel::dc_pf.c_str())
+        .def("ac_pf", &GridModel::ac_pf, py::call_guard<py::gil_scoped_release>(), DocGridModel::ac_pf.c_str())
         .def("unset_changes", &GridModel::unset_changes, DocGridModel::_internal_do_not_use.c_str())
         .def("tell_recompute_ybus", &GridModel::tell_recompute_ybus, DocGridModel::_internal_do_not_use.c_str())
         .def("tell_recompute_sbus", &GridModel::tell_recompute_sbus, DocGridModel::_internal_do_not_use.c_str())
         .def("tell_solver_need_reset", &GridModel::tell_solver_need_reset, DocGridModel::_internal_do_not_use.c_str())
         .def("tell_ybus_change_sparsity_pattern", &GridModel::tell_ybus_change_sparsity_pattern, DocGridModel::_internal_do_not_use.c_str())
         .def("get_solver_control", &GridModel::get_solver_control, "TODO")
-        .def("compute_newton", &GridModel::ac_pf, DocGridModel::ac_pf.c_str())
-        .def("get_ptdf", &GridModel::get_ptdf, DocGridModel::get_ptdf.c_str()) 
-        .def("get_ptdf_solver", &GridModel::get_ptdf_solver, DocGridModel::get_ptdf_solver.c_str())
-        .def("get_lodf", &GridModel::get_lodf, DocGridModel::get_lodf.c_str())
+        .def("get_ybus_fill_counters", &GridModel::get_ybus_fill_counters, DocGridModel::get_ybus_fill_counters.c_str())
+        .def("get_sbus_fill_counters", &GridModel::get_sbus_fill_counters, DocGridModel::get_sbus_fill_counters.c_str())
+        .def("save_state", &GridModel::save_state, DocGridModel::save_state.c_str())
+        .def("restore_state", &GridModel::restore_state, py::arg("token"), DocGridModel::restore_state.c_str())
+        .def("forget_state", &GridModel::forget_state, py::arg("token"), DocGridModel::forget_state.c_str())
+        .def("nb_saved_states", &GridModel::nb_saved_states, DocGridModel::_internal_do_not_use.c_str())
+        .def("compute_newton", &GridModel::ac_pf, py::call_guard<py::gil_scoped_release>(), DocGridModel::ac_pf.c_str())
+        .def("get_ptdf", &GridModel::get_ptdf, py::call_guard<py::gil_scoped_release>(), DocGridModel::get_ptdf.c_str()) 
+        .def("get_ptdf_solver", &GridModel::get_ptdf_solver, py::call_guard<py::gil_scoped_release>(), DocGridModel::get_ptdf_solver.c_str())
+        .def("get_lodf", &GridModel::get_lodf, py::call_guard<py::gil_scoped_release>(), DocGridModel::get_lodf.c_str())
         .def("get_Bf", &GridModel::get_Bf, DocGridModel::get_Bf.c_str())
         .def("get_Bf_solver", &GridModel::get_Bf_solver, DocGridModel::get_Bf_solver.c_str())
 
@@ -969,6 +986,13 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
         .def("debug_get_Bpp_python", &GridModel::debug_get_Bpp_python, DocGridModel::_internal_do_not_use.c_str())
         ;
 
+    py::enum_<PredictorType>(m, "PredictorType", "This enum controls how the initial voltages of each step of a time series are guessed (see :func:`lightsim2grid.timeSerie.Computers.set_predictor`)")
+        .value("NoPredictor", PredictorType::NoPredictor, "the voltages found at the previous step are used")
+        .value("Linear", PredictorType::Linear, "linear extrapolation of the voltages found at the 2 previous steps")
+        .value("Quadratic", PredictorType::Quadratic, "quadratic extrapolation of the voltages found at the 3 previous steps")
+        .value("Jacobian", PredictorType::Jacobian, "one newton step with the jacobian factorized at the previous step (Newton Raphson solvers only)")
+        .export_values();
+
     py::class_<TimeSeries>(m, "TimeSeriesCPP", DocComputers::Computers.c_str())
         .def(py::init<const GridModel &>())
 
@@ -976,16 +1000,38 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
         .def("change_solver", &TimeSeries::change_solver, DocGridModel::change_solver.c_str())
         .def("available_solvers", &TimeSeries::available_solvers, DocGridModel::available_solvers.c_str())
         .def("get_solver_type", &TimeSeries::get_solver_type, DocGridModel::get_solver_type.c_str())
+        .def("set_jacobian_reuse", &TimeSeries::set_jacobian_reuse, DocSolver::set_jacobian_reuse.c_str())
+        .def("get_refactor_every", &TimeSeries::get_refactor_every, DocSolver::get_refactor_every.c_str())
+        .def("get_refactor_ratio", &TimeSeries::get_refactor_ratio, DocSolver::get_refactor_ratio.c_str())
+        .def("set_nb_thread", &TimeSeries::set_nb_thread, DocComputers::set_nb_thread.c_str())
+        .def("get_nb_thread", &TimeSeries::get_nb_thread, DocComputers::get_nb_thread.c_str())
+        .def("add_branch_status_event", &TimeSeries::add_branch_status_event, DocComputers::add_branch_status_event.c_str(),
+             py::arg("step"), py::arg("branch_id"), py::arg("connected"))
+        .def("add_branch_bus_event", &TimeSeries::add_branch_bus_event, DocComputers::add_branch_bus_event.c_str(),
+             py::arg("step"), py::arg("branch_id"), py::arg("side"), py::arg("new_bus_id"))
+        .def("clear_topo_events", &TimeSeries::clear_topo_events, DocComputers::clear_topo_events.c_str())
+        .def("nb_topo_events", &TimeSeries::nb_topo_events, DocComputers::nb_topo_events.c_str())
+        .def("get_steps_topology", &TimeSeries::get_steps_topology, DocComputers::get_steps_topology.c_str(), py::return_value_policy::reference_internal)
+        .def("nb_topologies", &TimeSeries::nb_topologies, DocComputers::nb_topologies.c_str())
 
         // timers
         .def("total_time", &TimeSeries::total_time, DocComputers::total_time.c_str())
         .def("solver_time", &TimeSeries::solver_time, DocComputers::solver_time.c_str())
         .def("preprocessing_time", &TimeSeries::preprocessing_time, DocComputers::preprocessing_time.c_str())
         .def("amps_computation_time", &TimeSeries::amps_computation_time, DocComputers::amps_computation_time.c_str())
+        .def("results_computation_time", &TimeSeries::results_computation_time, DocComputers::results_computation_time.c_str())
         .def("nb_solved", &TimeSeries::nb_solved, DocComputers::nb_solved.c_str())
 
         // status
         .def("get_status", &TimeSeries::get_status, DocComputers::get_status.c_str())
+        .def("get_steps_status", &TimeSeries::get_steps_status, DocComputers::get_steps_status.c_str(), py::return_value_policy::reference_internal)
+        .def("get_steps_nb_iter", &TimeSeries::get_steps_nb_iter, DocComputers::get_steps_nb_iter.c_str(), py::return_value_policy::reference_internal)
+        .def("get_steps_error", &TimeSeries::get_steps_error, DocComputers::get_steps_error.c_str(), py::return_value_policy::reference_internal)
+        .def("set_continue_on_divergence", &TimeSeries::set_continue_on_divergence, DocComputers::set_continue_on_divergence.c_str())
+        .def("get_continue_on_divergence", &TimeSeries::get_continue_on_divergence, DocComputers::get_continue_on_divergence.c_str())
+        .def("total_nb_iter", &TimeSeries::total_nb_iter, DocComputers::total_nb_iter.c_str())
+        .def("set_predictor", &TimeSeries::set_predictor, DocComputers::set_predictor.c_str())
+        .def("get_predictor", &TimeSeries::get_predictor, DocComputers::get_predictor.c_str())
         .def("clear", &TimeSeries::clear, DocComputers::clear.c_str())
         .def("close", &TimeSeries::clear, DocComputers::clear.c_str())
 
@@ -993,6 +1039,8 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
         .def("compute_Vs", &TimeSeries::compute_Vs, py::call_guard<py::gil_scoped_release>(), DocComputers::compute_Vs.c_str())
         .def("compute_flows", &TimeSeries::compute_flows, DocComputers::compute_flows.c_str())
         .def("compute_power_flows", &TimeSeries::compute_power_flows, DocComputers::compute_power_flows.c_str())  // need to be done after "compute_Vs"  and "compute_flows"
+        .def("compute_results", &TimeSeries::compute_results, py::call_guard<py::gil_scoped_release>(), DocComputers::compute_results.c_str(),
+             py::arg("branch_results") = true, py::arg("gen_results") = true, py::arg("shunt_results") = true, py::arg("bus_results") = true)
         
         // results (for now only flow (at each -line origin- or voltages -at each buses)
         // see https://pybind11.readthedocs.io/en/stable/advanced/cast/eigen.html#returning-values-to-python
@@ -1000,14 +1048,60 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
         .def("get_power_flows", &TimeSeries::get_power_flows, DocComputers::get_power_flows.c_str(), py::return_value_policy::reference_internal)  // need to be done after "compute_Vs"  and "compute_flows"
         .def("get_voltages", &TimeSeries::get_voltages, DocComputers::get_voltages.c_str(), py::return_value_policy::reference_internal)  // need to be done after "compute_Vs" 
         .def("get_sbuses", &TimeSeries::get_sbuses, DocComputers::get_sbuses.c_str(), py::return_value_policy::reference_internal)  // need to be done after "compute_Vs" 
+        .def("get_p_or", &TimeSeries::get_p_or, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_q_or", &TimeSeries::get_q_or, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_a_or", &TimeSeries::get_a_or, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_p_ex", &TimeSeries::get_p_ex, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_q_ex", &TimeSeries::get_q_ex, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_a_ex", &TimeSeries::get_a_ex, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_gen_q", &TimeSeries::get_gen_q, DocComputers::get_gen_q.c_str(), py::return_value_policy::reference_internal)
+        .def("get_gen_p_slack", &TimeSeries::get_gen_p_slack, DocComputers::get_gen_p_slack.c_str(), py::return_value_policy::reference_internal)
+        .def("get_shunt_q", &TimeSeries::get_shunt_q, DocComputers::get_shunt_q.c_str(), py::return_value_policy::reference_internal)
+        .def("get_bus_v_kv", &TimeSeries::get_bus_v_kv, DocComputers::get_bus_v_kv.c_str(), py::return_value_policy::reference_internal)
         ;
 
+    py::class_<ContingencyResultSink, std::shared_ptr<ContingencyResultSink> >(m, "ContingencyResultSink", DocSecurityAnalysis::ContingencyResultSink.c_str());
+
+    py::class_<ContingencyCallbackSink, ContingencyResultSink, std::shared_ptr<ContingencyCallbackSink> >(m, "ContingencyCallbackSink", DocSecurityAnalysis::ContingencyCallbackSink.c_str())
+        .def(py::init<const ContingencyCallbackSink::CallbackType &>());
+
+    py::class_<ContingencyQueueSink, ContingencyResultSink, std::shared_ptr<ContingencyQueueSink> >(m, "ContingencyQueueSink", DocSecurityAnalysis::ContingencyQueueSink.c_str())
+        .def(py::init<int>())
+        .def("pop", [](ContingencyQueueSink & self) -> py::object {
+            ContingencyResult res;
+            bool has_res;
+            {
+                py::gil_scoped_release release;
+                has_res = self.pop(res);
+            }
+            if(!has_res) return py::none();
+            return py::make_tuple(res.cont_id, res.converged, res.V, res.amps_flows);
+        }, DocSecurityAnalysis::ContingencyQueueSink_pop.c_str())
+        .def("max_size", &ContingencyQueueSink::max_size, DocSecurityAnalysis::ContingencyQueueSink_max_size.c_str())
+        .def("size", &ContingencyQueueSink::size, DocSecurityAnalysis::ContingencyQueueSink_size.c_str());
+
+    py::class_<ContingencyFileSink, ContingencyResultSink, std::shared_ptr<ContingencyFileSink> >(m, "ContingencyFileSink", DocSecurityAnalysis::ContingencyFileSink.c_str())
+        .def(py::init<const std::string &>())
+        .def("path", &ContingencyFileSink::path, DocSecurityAnalysis::ContingencyFileSink_path.c_str())
+        .def("record_size", &ContingencyFileSink::record_size, DocSecurityAnalysis::ContingencyFileSink_record_size.c_str());
+
     py::class_<ContingencyAnalysis>(m, "ContingencyAnalysisCPP", DocSecurityAnalysis::SecurityAnalysis.c_str())
         .def(py::init<const GridModel &>())
         // solver control
         .def("change_solver", &ContingencyAnalysis::change_solver, DocGridModel::change_solver.c_str())
         .def("available_solvers", &ContingencyAnalysis::available_solvers, DocGridModel::available_solvers.c_str())
         .def("get_solver_type", &ContingencyAnalysis::get_solver_type, DocGridModel::get_solver_type.c_str())
+        .def("set_jacobian_reuse", &ContingencyAnalysis::set_jacobian_reuse, DocSolver::set_jacobian_reuse.c_str())
+        .def("get_refactor_every", &ContingencyAnalysis::get_refactor_every, DocSolver::get_refactor_every.c_str())
+        .def("get_refactor_ratio", &ContingencyAnalysis::get_refactor_ratio, DocSolver::get_refactor_ratio.c_str())
+        .def("set_nb_thread", &ContingencyAnalysis::set_nb_thread, DocSecurityAnalysis::set_nb_thread.c_str())
+        .def("get_nb_thread", &ContingencyAnalysis::get_nb_thread, DocSecurityAnalysis::get_nb_thread.c_str())
+        .def("set_result_sink", &ContingencyAnalysis::set_result_sink, DocSecurityAnalysis::set_result_sink.c_str())
+        .def("clear_result_sink", &ContingencyAnalysis::clear_result_sink, DocSecurityAnalysis::clear_result_sink.c_str())
+        .def("has_result_sink", &ContingencyAnalysis::has_result_sink, DocSecurityAnalysis::has_result_sink.c_str())
+        .def("set_aggregation", &ContingencyAnalysis::set_aggregation, DocSecurityAnalysis::set_aggregation.c_str())
+        .def("clear_aggregation", &ContingencyAnalysis::clear_aggregation, DocSecurityAnalysis::clear_aggregation.c_str())
+        .def("has_aggregation", &ContingencyAnalysis::has_aggregation, DocSecurityAnalysis::has_aggregation.c_str())
 
         // add some defaults
         .def("add_all_n1", &ContingencyAnalysis::add_all_n1, DocSecurityAnalysis::add_all_n1.c_str())
@@ -1024,26 +1118,65 @@ PYBIND11_MODULE(lightsim2grid_cpp, m)
         .def("remove_nk", &ContingencyAnalysis::remove_nk, DocSecurityAnalysis::remove_nk.c_str())
         .def("remove_multiple_n1", &ContingencyAnalysis::remove_multiple_n1, DocSecurityAnalysis::remove_multiple_n1.c_str())
         
+        // incremental update of the base case (see DocSecurityAnalysis::update_grid)
+        .def("update_gens_p", &ContingencyAnalysis::update_gens_p, DocSecurityAnalysis::update_grid.c_str())
+        .def("update_sgens_p", &ContingencyAnalysis::update_sgens_p, DocSecurityAnalysis::update_grid.c_str())
+        .def("update_gens_v", &ContingencyAnalysis::update_gens_v, DocSecurityAnalysis::update_grid.c_str())
+        .def("update_loads_p", &ContingencyAnalysis::update_loads_p, DocSecurityAnalysis::update_grid.c_str())
+        .def("update_loads_q", &ContingencyAnalysis::update_loads_q, DocSecurityAnalysis::update_grid.c_str())
+        .def("update_storages_p", &ContingencyAnalysis::update_storages_p, DocSecurityAnalysis::update_grid.c_str())
+        .def("update_topo", &ContingencyAnalysis::update_topo, DocSecurityAnalysis::update_grid.c_str())
+        .def("change_p_shunt", &ContingencyAnalysis::change_p_shunt, DocSecurityAnalysis::update_grid.c_str())
+        .def("change_q_shunt", &ContingencyAnalysis::change_q_shunt, DocSecurityAnalysis::update_grid.c_str())
+        .def("change_bus_shunt", &ContingencyAnalysis::change_bus_shunt, DocSecurityAnalysis::update_grid.c_str())
+        .def("deactivate_shunt", &ContingencyAnalysis::deactivate_shunt, DocSecurityAnalysis::update_grid.c_str())
+        .def("reactivate_shunt", &ContingencyAnalysis::reactivate_shunt, DocSecurityAnalysis::update_grid.c_str())
+        .def("update_slack_weights", &ContingencyAnalysis::update_slack_weights, DocSecurityAnalysis::update_grid.c_str())
+
         // inspect the class
         .def("my_defaults", &ContingencyAnalysis::my_defaults_vect, DocSecurityAnalysis::my_defaults_vect.c_str())
         .def("is_grid_connected_after_contingency", &ContingencyAnalysis::is_grid_connected_after_contingency, DocGridModel::_internal_do_not_use.c_str())  // TODO
 
         // perform the computation
         .def("compute", &ContingencyAnalysis::compute, py::call_guard<py::gil_scoped_release>(), DocSecurityAnalysis::compute.c_str())
+        .def("compute_lodf", &ContingencyAnalysis::compute_lodf, py::call_guard<py::gil_scoped_release>(), DocSecurityAnalysis::compute_lodf.c_str())
+        .def("set_lodf_tol", &ContingencyAnalysis::set_lodf_tol, DocSecurityAnalysis::set_lodf_tol.c_str())
+        .def("get_lodf_tol", &ContingencyAnalysis::get_lodf_tol, DocSecurityAnalysis::get_lodf_tol.c_str())
+        .def("compute_screened", &ContingencyAnalysis::compute_screened, py::call_guard<py::gil_scoped_release>(), DocSecurityAnalysis::compute_screened.c_str())
+        .def("get_verified", &ContingencyAnalysis::get_verified, DocSecurityAnalysis::get_verified.c_str())
+        .def("get_screening_loading", &ContingencyAnalysis::get_screening_loading, DocSecurityAnalysis::get_screening_loading.c_str())
         .def("compute_flows", &ContingencyAnalysis::compute_flows, DocSecurityAnalysis::compute_flows.c_str())
         .def("compute_power_flows", &ContingencyAnalysis::compute_power_flows, DocSecurityAnalysis::compute_power_flows.c_str())
+        .def("compute_results", &ContingencyAnalysis::compute_results, py::call_guard<py::gil_scoped_release>(), DocSecurityAnalysis::compute_results.c_str(),
+             py::arg("branch_results") = true, py::arg("gen_results") = true, py::arg("shunt_results") = true, py::arg("bus_results") = true)
 
         // results (for now only flow (at each -line origin- or voltages -at each buses)
         // see https://pybind11.readthedocs.io/en/stable/advanced/cast/eigen.html#returning-values-to-python
         .def("get_flows", &ContingencyAnalysis::get_flows, DocSecurityAnalysis::get_flows.c_str(), py::return_value_policy::reference_internal)
         .def("get_voltages", &ContingencyAnalysis::get_voltages, DocSecurityAnalysis::get_voltages.c_str(), py::return_value_policy::reference_internal)
         .def("get_power_flows", &ContingencyAnalysis::get_power_flows, DocSecurityAnalysis::get_power_flows.c_str(), py::return_value_policy::reference_internal)
+        .def("get_p_or", &ContingencyAnalysis::get_p_or, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_q_or", &ContingencyAnalysis::get_q_or, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_a_or", &ContingencyAnalysis::get_a_or, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_p_ex", &ContingencyAnalysis::get_p_ex, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_q_ex", &ContingencyAnalysis::get_q_ex, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_a_ex", &ContingencyAnalysis::get_a_ex, DocComputers::get_branch_results.c_str(), py::return_value_policy::reference_internal)
+        .def("get_gen_q", &ContingencyAnalysis::get_gen_q, DocComputers::get_gen_q.c_str(), py::return_value_policy::reference_internal)
+        .def("get_gen_p_slack", &ContingencyAnalysis::get_gen_p_slack, DocComputers::get_gen_p_slack.c_str(), py::return_value_policy::reference_internal)
+        .def("get_shunt_q", &ContingencyAnalysis::get_shunt_q, DocComputers::get_shunt_q.c_str(), py::return_value_policy::reference_internal)
+        .def("get_bus_v_kv", &ContingencyAnalysis::get_bus_v_kv, DocComputers::get_bus_v_kv.c_str(), py::return_value_policy::reference_internal)
+        .def("get_max_flows", &ContingencyAnalysis::get_max_flows, DocSecurityAnalysis::get_max_flows.c_str(), py::return_value_policy::reference_internal)
+        .def("get_max_flows_cont", &ContingencyAnalysis::get_max_flows_cont, DocSecurityAnalysis::get_max_flows_cont.c_str(), py::return_value_policy::reference_internal)
+        .def("get_nb_violations", &ContingencyAnalysis::get_nb_violations, DocSecurityAnalysis::get_nb_violations.c_str(), py::return_value_policy::reference_internal)
+        .def("get_min_vm", &ContingencyAnalysis::get_min_vm, DocSecurityAnalysis::get_min_vm.c_str(), py::return_value_policy::reference_internal)
+        .def("get_max_vm", &ContingencyAnalysis::get_max_vm, DocSecurityAnalysis::get_max_vm.c_str(), py::return_value_policy::reference_internal)
 
         // timers
         .def("total_time", &ContingencyAnalysis::total_time, DocComputers::total_time.c_str())
         .def("solver_time", &ContingencyAnalysis::solver_time, DocComputers::solver_time.c_str())
         .def("preprocessing_time", &ContingencyAnalysis::preprocessing_time, DocSecurityAnalysis::preprocessing_time.c_str())
         .def("amps_computation_time", &ContingencyAnalysis::amps_computation_time, DocComputers::amps_computation_time.c_str())
+        .def("results_computation_time", &ContingencyAnalysis::results_computation_time, DocComputers::results_computation_time.c_str())
         .def("modif_Ybus_time", &ContingencyAnalysis::modif_Ybus_time, DocSecurityAnalysis::modif_Ybus_time.c_str())
         .def("nb_solved", &ContingencyAnalysis::nb_solved, DocComputers::nb_solved.c_str())
         ;
@@ -27,40 +27,75 @@ void BaseAlgo::reset(){
 }
 
 
-RealVect BaseAlgo::_evaluate_Fx(const Eigen::SparseMatrix<cplx_type> &  Ybus,
-                                const CplxVect & V,
-                                const CplxVect & Sbus,
-                                const Eigen::VectorXi & pv,
-                                const Eigen::VectorXi & pq)
+void BaseAlgo::compute_Ibus(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                            const CplxVect & V,
+                            CplxVect & Ibus)
+{
+    /**
+    Ibus = Ybus * V, Ybus being in (the default Eigen) column major format.
+
+    The complex numbers are handled through their real and imaginary parts (std::complex is guaranteed
+    to be stored as two contiguous real_type) so that the inner loop only performs products and sums
+    of real_type, without the overhead of the complex product (checks for nans and infinities)
+    **/
+    const Eigen::Index nb_bus = Ybus.cols();
+    Ibus.resize(nb_bus);
+    Ibus.setZero();
+    real_type * Ibus_ptr = reinterpret_cast<real_type *>(Ibus.data());
+    const real_type * V_ptr = reinterpret_cast<const real_type *>(V.data());
+    const real_type * Y_ptr = reinterpret_cast<const real_type *>(Ybus.valuePtr());
+    const auto * inner_ptr = Ybus.innerIndexPtr();
+    const auto * outer_ptr = Ybus.outerIndexPtr();
+    const auto * nnz_ptr = Ybus.innerNonZeroPtr();  // nullptr if Ybus is compressed
+    for(Eigen::Index col_id = 0; col_id < nb_bus; ++col_id){
+        const real_type v_r = V_ptr[2 * col_id];
+        const real_type v_i = V_ptr[2 * col_id + 1];
+        const Eigen::Index start_id = outer_ptr[col_id];
+        const Eigen::Index end_id = nnz_ptr ? start_id + nnz_ptr[col_id] : outer_ptr[col_id + 1];
+        for(Eigen::Index obj_id = start_id; obj_id < end_id; ++obj_id){
+            const real_type y_r = Y_ptr[2 * obj_id];
+            const real_type y_i = Y_ptr[2 * obj_id + 1];
+            const Eigen::Index row_id = inner_ptr[obj_id];
+            Ibus_ptr[2 * row_id] += y_r * v_r - y_i * v_i;
+            Ibus_ptr[2 * row_id + 1] += y_r * v_i + y_i * v_r;
+        }
+    }
+}
+
+void BaseAlgo::_evaluate_Fx(const Eigen::SparseMatrix<cplx_type> &  Ybus,
+                            const CplxVect & V,
+                            const CplxVect & Sbus,
+                            const Eigen::VectorXi & pv,
+                            const Eigen::VectorXi & pq,
+                            RealVect & F)
 {
     auto timer = CustTimer();
-    auto npv = pv.size();
-    auto npq = pq.size();
-
-    // compute the mismatch
-    CplxVect tmp = Ybus * V;  // this is a vector
-    tmp = tmp.array().conjugate();  // i take the conjugate
-    auto mis = V.array() * tmp.array() - Sbus.array();
-    auto real_ = mis.real();
-    auto imag_ = mis.imag();
-
-    // build and fill the result
-    RealVect res(npv + 2*npq);
-    res.segment(0,npv) = real_(pv);
-    res.segment(npv,npq) = real_(pq);
-    res.segment(npv+npq, npq) = imag_(pq);
+    const auto npv = pv.size();
+    const auto npq = pq.size();
+
+    // compute the current injections (the mismatch is computed only for the buses needed)
+    compute_Ibus(Ybus, V, Ibus_);
+
+    // fill the result
+    F.resize(npv + 2*npq);
+    for(Eigen::Index i = 0; i < npv; ++i) F(i) = _mismatch_p(V, Sbus, pv(i));
+    for(Eigen::Index i = 0; i < npq; ++i){
+        const Eigen::Index bus_id = pq(i);
+        F(npv + i) = _mismatch_p(V, Sbus, bus_id);
+        F(npv + npq + i) = _mismatch_q(V, Sbus, bus_id);
+    }
     timer_Fx_ += timer.duration();
-    return res;
 }
 
-RealVect BaseAlgo::_evaluate_Fx(const Eigen::SparseMatrix<cplx_type> &  Ybus,
-                                  const CplxVect & V,
-                                  const CplxVect & Sbus,
-                                  Eigen::Index slack_id,  // id of the ref slack bus
-                                  real_type slack_absorbed,
-                                  const RealVect & slack_weights,
-                                  const Eigen::VectorXi & pv,
-                                  const Eigen::VectorXi & pq)
+void BaseAlgo::_evaluate_Fx(const Eigen::SparseMatrix<cplx_type> &  Ybus,
+                            const CplxVect & V,
+                            const CplxVect & Sbus,
+                            Eigen::Index slack_id,  // id of the ref slack bus
+                            real_type slack_absorbed,
+                            const RealVect & slack_weights,
+                            const Eigen::VectorXi & pv,
+                            const Eigen::VectorXi & pq,
+                            RealVect & F)
 {
     /**
     Remember, when this function is used:
@@ -93,28 +128,26 @@ RealVect BaseAlgo::_evaluate_Fx(const Eigen::SparseMatrix<cplx_type> &  Ybus,
     - then it's Vm of pq buses
 
     **/
-
-    // TODO factorize with above (ugly copy paste)
     auto timer = CustTimer();
-    auto npv = pv.size();
-    auto npq = pq.size();
-
-    // compute the mismatch
-    CplxVect tmp = Ybus * V;  // this is a vector
-    tmp = tmp.array().conjugate();  // i take the conjugate
-    auto mis = V.array() * tmp.array() - Sbus.array() + slack_absorbed * slack_weights.array();
-    RealVect real_ = mis.real();
-    RealVect imag_ = mis.imag();
-
-    // build and fill the result
-    RealVect res(npv + 2 * npq + 1); // slack adds one component hence the '+1' also bellow)
-    res.segment(1, npv) = real_(pv);
-    res.segment(npv + 1, npq) = real_(pq);
-    res.segment(npv + npq + 1, npq) = imag_(pq);
-    res(0) = real_(slack_id);  // slack bus is first variable
+    const auto npv = pv.size();
+    const auto npq = pq.size();
+
+    // compute the current injections (the mismatch is computed only for the buses needed)
+    compute_Ibus(Ybus, V, Ibus_);
+
+    // fill the result
+    F.resize(npv + 2 * npq + 1); // slack adds one component hence the '+1' also bellow)
+    F(0) = _mismatch_p(V, Sbus, slack_id) + slack_absorbed * slack_weights(slack_id);  // slack bus is first variable
+    for(Eigen::Index i = 0; i < npv; ++i){
+        const Eigen::Index bus_id = pv(i);
+        F(i + 1) = _mismatch_p(V, Sbus, bus_id) + slack_absorbed * slack_weights(bus_id);
+    }
+    for(Eigen::Index i = 0; i < npq; ++i){
+        const Eigen::Index bus_id = pq(i);
+        F(npv + i + 1) = _mismatch_p(V, Sbus, bus_id) + slack_absorbed * slack_weights(bus_id);
+        F(npv + npq + i + 1) = _mismatch_q(V, Sbus, bus_id);
+    }
     timer_Fx_ += timer.duration();
-    return res;
-    
 }
 
 bool BaseAlgo::_check_for_convergence(const RealVect & F,
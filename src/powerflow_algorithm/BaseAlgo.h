@@ -32,7 +32,7 @@ class GridModel;
 
 typedef std::tuple<double, double, double, double, 
                    double, double, double, double, 
-                   double> TimerJacType;
+                   double, int> TimerJacType;
 typedef std::tuple<double, double, double> TimerPTDFLODFType;
 
 /**
@@ -82,6 +82,14 @@ class BaseAlgo : public BaseConstants
             return err_ == ErrorType::NoError;
         }
 
+        // set back the results of a previous (converged) powerflow, see GridModel::restore_state
+        void set_V(const CplxVect & V, const RealVect & Vm, const RealVect & Va){
+            V_ = V;
+            Vm_ = Vm;
+            Va_ = Va;
+            err_ = ErrorType::NoError;
+        }
+
         std::tuple<double, double, double, double> get_timers() const
         {
             // TODO change the order of the timers here!
@@ -101,7 +109,8 @@ class BaseAlgo : public BaseConstants
                 -1.,  // not available for non NR solver, so I put -1
                 -1.,  // not available for non NR solver, so I put -1
                 -1.,  // not available for non NR solver, so I put -1
-                timer_total_nr_
+                timer_total_nr_,
+                -1  // number of factorizations of the jacobian, not available for non NR solver
             };
             return res;
         }
@@ -143,9 +152,37 @@ class BaseAlgo : public BaseConstants
             throw std::runtime_error("Impossible to get the BSDF matrix with this solver type.");
         }
 
+        // Ibus = Ybus * V (Ibus is resized if needed, no other allocation)
+        static void compute_Ibus(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                                 const CplxVect & V,
+                                 CplxVect & Ibus);
+
         virtual void update_internal_Ybus(const Coeff & new_coeffs, bool add){
             throw std::runtime_error("Function update_internal_Ybus not implemented in general.");
         }
+
+        // improves V (typically the solution of the previous powerflow) for the new injections Sbus
+        // before a call to compute_pf, returns false (and V is not modified) if it cannot
+        virtual bool predict_V(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                               CplxVect & V,
+                               const CplxVect & Sbus,
+                               const Eigen::VectorXi & slack_ids,
+                               const RealVect & slack_weights,
+                               const Eigen::VectorXi & pv,
+                               const Eigen::VectorXi & pq){
+            return false;
+        }
+
+        virtual bool compute_pf_multi(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                                      const CplxVect & V,
+                                      const RealMat & Sbuses,
+                                      const Eigen::VectorXi & slack_ids,
+                                      const RealVect & slack_weights,
+                                      const Eigen::VectorXi & pv,
+                                      const Eigen::VectorXi & pq,
+                                      RealMat & Va){
+            throw std::runtime_error("Function compute_pf_multi is only available for DC solvers.");
+        }
         
     protected:
         virtual void reset_timer(){
@@ -161,20 +198,31 @@ class BaseAlgo : public BaseConstants
             // return res;
             return (err_ != ErrorType::LicenseError);
         }
-        RealVect _evaluate_Fx(const Eigen::SparseMatrix<cplx_type> &  Ybus,
-                              const CplxVect & V,
-                              const CplxVect & Sbus,
-                              Eigen::Index slack_id,  // id of the slack bus
-                              real_type slack_absorbed,
-                              const RealVect & slack_weights,
-                              const Eigen::VectorXi & pv,
-                              const Eigen::VectorXi & pq);
-
-        RealVect _evaluate_Fx(const Eigen::SparseMatrix<cplx_type> &  Ybus,
-                              const CplxVect & V,
-                              const CplxVect & Sbus,
-                              const Eigen::VectorXi & pv,
-                              const Eigen::VectorXi & pq);
+        // compute the mismatch F (resized if needed, no other allocation) for the NR solvers
+        void _evaluate_Fx(const Eigen::SparseMatrix<cplx_type> &  Ybus,
+                          const CplxVect & V,
+                          const CplxVect & Sbus,
+                          Eigen::Index slack_id,  // id of the slack bus
+                          real_type slack_absorbed,
+                          const RealVect & slack_weights,
+                          const Eigen::VectorXi & pv,
+                          const Eigen::VectorXi & pq,
+                          RealVect & F);
+
+        void _evaluate_Fx(const Eigen::SparseMatrix<cplx_type> &  Ybus,
+                          const CplxVect & V,
+                          const CplxVect & Sbus,
+                          const Eigen::VectorXi & pv,
+                          const Eigen::VectorXi & pq,
+                          RealVect & F);
+
+        // real (resp. imaginary) part of V * conj(Ibus_) - Sbus at bus bus_id (Ibus_ should be computed before)
+        real_type _mismatch_p(const CplxVect & V, const CplxVect & Sbus, Eigen::Index bus_id) const {
+            return std::real(V(bus_id)) * std::real(Ibus_(bus_id)) + std::imag(V(bus_id)) * std::imag(Ibus_(bus_id)) - std::real(Sbus(bus_id));
+        }
+        real_type _mismatch_q(const CplxVect & V, const CplxVect & Sbus, Eigen::Index bus_id) const {
+            return std::imag(V(bus_id)) * std::real(Ibus_(bus_id)) - std::real(V(bus_id)) * std::imag(Ibus_(bus_id)) - std::imag(Sbus(bus_id));
+        }
 
         bool _check_for_convergence(const RealVect & F,
                                     real_type tol);
@@ -257,6 +305,8 @@ class BaseAlgo : public BaseConstants
         // 3: i can't solve the system (klu_solve)
         // 4: end of possible iterations (divergence because nr_iter_ >= max_iter)
 
+        CplxVect Ibus_;  // Ybus * V, computed in _evaluate_Fx
+
         // timers
         double timer_Fx_;
         double timer_solve_;
@@ -19,6 +19,7 @@ class BaseDCAlgo: public BaseAlgo
             BaseAlgo(false),
             _linear_solver(),
             need_factorize_(true),
+            ybus_factorized_(false),
             timer_ptdf_(0.),
             timer_lodf_(0.),
             sizeYbus_with_slack_(0),
@@ -56,20 +57,51 @@ class BaseDCAlgo: public BaseAlgo
                         real_type tol
                         );
 
+        /**
+        Solves the DC powerflow for multiple injections at once: each column of `Sbuses` (size nb_bus x nb_rhs,
+        only the real part of the injections is used for the DC powerflow) is a right hand side, 
+        and `dcYbus_noslack_` is factorized (at most) once.
+
+        `Va` (size nb_bus x nb_rhs) contains the voltage angles found, the columns for which the
+        powerflow diverged are filled with NaN. V is used the same way as in `compute_pf` (only the slack angle).
+
+        The results of `get_V`, `get_Va` etc. are not modified by this function.
+        **/
+        virtual
+        bool compute_pf_multi(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                              const CplxVect & V,
+                              const RealMat & Sbuses,
+                              const Eigen::VectorXi & slack_ids,
+                              const RealVect & slack_weights,  // currently unused
+                              const Eigen::VectorXi & pv,
+                              const Eigen::VectorXi & pq,
+                              RealMat & Va
+                              );
+
         virtual RealMat get_ptdf();
         virtual RealMat get_lodf(const IntVect & from_bus,
                                  const IntVect & to_bus);
         virtual Eigen::SparseMatrix<real_type> get_bsdf();  // TODO BSDF
         
+        /**
+        Modifies the internal dc Ybus (eg. to simulate a contingency). The matrix stored (and
+        factorized) by the linear solver is NOT modified: the modifications are kept aside and 
+        taken into account with a low rank (Sherman-Morrison-Woodbury) update at the next 
+        call to `compute_pf`.
+
+        Calling it with `add=true` with the same coefficient as a previous call with `add=false` 
+        cancels exactly this previous modification.
+        **/
         virtual void update_internal_Ybus(const Coeff & coeff, bool add){
-            int row_res = static_cast<int>(coeff.row_id);
-            row_res = mat_bus_id_(row_res);
-            if(row_res == -1) return;
-            int col_res = static_cast<int>(coeff.col_id);
-            col_res = mat_bus_id_(col_res);
-            if(col_res == -1) return;
-            auto val = add ? std::real(coeff.value) : - std::real(coeff.value);
-            dcYbus_noslack_.coeffRef(row_res, col_res) += val;
+            const real_type val = add ? std::real(coeff.value) : - std::real(coeff.value);
+            for(auto it = ybus_modifs_.begin(); it != ybus_modifs_.end(); ++it){
+                if((it->row_id == coeff.row_id) && (it->col_id == coeff.col_id) && (std::real(it->value) == -val)){
+                    // this modification cancels a previous one
+                    ybus_modifs_.erase(it);
+                    return;
+                }
+            }
+            ybus_modifs_.push_back({coeff.row_id, coeff.col_id, {val, 0.}});
         }
 
     private:
@@ -78,9 +110,23 @@ class BaseDCAlgo: public BaseAlgo
         BaseDCAlgo & operator=( const BaseDCAlgo & ) =delete;
 
     protected:
+        // everything that depends only on Ybus (and pv / pq / slack buses) and not on Sbus
+        void prepare_dcYbus(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                            const Eigen::VectorXi & slack_ids,
+                            const Eigen::VectorXi & pv,
+                            const Eigen::VectorXi & pq);
+        // factorize dcYbus_noslack_ (only if needed)
+        bool factorize_dcYbus();
+
         void fill_mat_bus_id(int nb_bus_solver);
         void fill_dcYbus_noslack(int nb_bus_solver, const Eigen::SparseMatrix<cplx_type> & ref_mat);
 
+        // solves in place (dcYbus_noslack_ + ybus_modifs_) . x = rhs, when Va_dc_without_slack is
+        // dcYbus_noslack_^{-1} . rhs (dcYbus_noslack_ must be factorized)
+        // rhs can have multiple columns: the correction is computed once for all of them
+        template<typename va_type>  // va_type should be `RealVect` or `RealMat`
+        ErrorType apply_ybus_modifs(va_type & Va_dc_without_slack);
+
         // remove_slack_buses: res_mat is initialized and make_compressed in this function
         template<typename ref_mat_type>  // ref_mat_type should be `real_type` or `cplx_type`
         void remove_slack_buses(int nb_bus_solver, const Eigen::SparseMatrix<ref_mat_type> & ref_mat, Eigen::SparseMatrix<real_type> & res_mat);
@@ -88,6 +134,7 @@ class BaseDCAlgo: public BaseAlgo
     protected:
         LinearSolver  _linear_solver;
         bool need_factorize_;
+        bool ybus_factorized_;  // the linear solver holds a factorization of dcYbus_noslack_
 
         double timer_ptdf_;
         double timer_lodf_;
@@ -102,6 +149,10 @@ class BaseDCAlgo: public BaseAlgo
         // -1 if bus is slack , else the id of the row / column used in the linear solver representing this bus
         Eigen::VectorXi mat_bus_id_;   // formerly `ybus_to_me`
 
+        // modifications of the dc Ybus (see `update_internal_Ybus`), in the solver labelling (with slack)
+        // they are cleared by `reset`: whoever resets the solver should tell them again
+        std::vector<Coeff> ybus_modifs_;
+
 };
 
 #include "BaseDCAlgo.tpp"
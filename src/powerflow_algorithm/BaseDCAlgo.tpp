@@ -9,6 +9,7 @@
 // #include "DCSolver.h"
 #include <limits>  // for nans
 #include <cmath>  // for nans
+#include <algorithm>  // for std::sort
 
 // TODO SLACK !!!
 template<class LinearSolver>
@@ -33,57 +34,9 @@ bool BaseDCAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<cplx_type> &
         return false;
     }
     BaseAlgo::reset_timer();
-    bool has_just_been_factorized = false;
 
     auto timer = CustTimer();
-    if(need_factorize_ ||
-       _solver_control.need_reset_solver() || 
-       _solver_control.has_dimension_changed() ||
-       _solver_control.has_slack_participate_changed() ||  // the full "ybus without slack" has changed, everything needs to be recomputed_solver_control.ybus_change_sparsity_pattern()
-       _solver_control.ybus_change_sparsity_pattern() ||
-       _solver_control.has_ybus_some_coeffs_zero()
-       ){
-       reset();
-    }
-    
-    sizeYbus_with_slack_ = static_cast<int>(Ybus.rows());
-
-    #ifdef __COUT_TIMES
-        auto timer_preproc = CustTimer();
-    #endif // __COUT_TIMES
-
-    if(need_factorize_ || 
-       _solver_control.has_pv_changed() || 
-       _solver_control.has_pq_changed()) {    
-
-        // TODO SLACK (for now i put all slacks as PV, except the first one)
-        // this should be handled in Sbus, because we know the amount of power absorbed by the slack
-        // so we can compute it correctly !
-        // std::cout << "\t\t\tneed to retrieve slack\n";
-        my_pv_ = retrieve_pv_with_slack(slack_ids, pv);
-
-        // find the slack buses
-        slack_buses_ids_solver_ = extract_slack_bus_id(my_pv_, pq, sizeYbus_with_slack_);
-        sizeYbus_without_slack_ = sizeYbus_with_slack_ - slack_buses_ids_solver_.size();
-
-        // corresp bus -> solverbus
-        fill_mat_bus_id(sizeYbus_with_slack_);
-    }
-
-    // remove the slack bus from Ybus
-    if(need_factorize_ || 
-       _solver_control.need_recompute_ybus() ||
-       _solver_control.ybus_change_sparsity_pattern() ||
-       _solver_control.has_ybus_some_coeffs_zero()) {
-        // std::cout << "\t\t\tneed to sizeYbus_with_slack_\n";
-        fill_dcYbus_noslack(sizeYbus_with_slack_, Ybus);
-        has_just_been_factorized = false;  // force a call to "factor" the linear solver as the lhs (ybus) changed
-        // no need to refactor if ybus did not change
-    }
-    
-    #ifdef __COUT_TIMES
-        std::cout << "\t dc: preproc: " << 1000. * timer_preproc.duration() << "ms" << std::endl;
-    #endif // __COUT_TIMES
+    prepare_dcYbus(Ybus, slack_ids, pv, pq);
     
     // initialize the solver (only if needed)
     #ifdef __COUT_TIMES
@@ -102,16 +55,7 @@ bool BaseDCAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<cplx_type> &
     }
 
     // initialize the solver if needed
-    if(need_factorize_){
-        // std::cout << "\t\t\tneed to factorize\n";
-        ErrorType status_init = _linear_solver.initialize(dcYbus_noslack_);
-        if(status_init != ErrorType::NoError){
-            err_ = status_init;
-            return false;
-        }
-        need_factorize_ = false;
-        has_just_been_factorized = true;
-    }
+    if(!factorize_dcYbus()) return false;
 
     // solve for theta: Sbus = dcY . theta (make a copy to keep dcSbus_noslack_)
     RealVect Va_dc_without_slack = dcSbus_noslack_;       
@@ -121,12 +65,24 @@ bool BaseDCAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<cplx_type> &
     // std::cout << "\t\tBaseDCAlgo.tpp: Va_dc_without_slack (l1 norm): " << Va_dc_without_slack.lpNorm<1>() << std::endl;  // TODO DEBUG WINDOWS
     // std::cout << "\t\tBaseDCAlgo.tpp:  V (l1 norm): " <<  V.lpNorm<1>() << std::endl;  // TODO DEBUG WINDOWS
     // std::cout << "\t\tBaseDCAlgo.tpp:  Sbus (l1 norm): " <<  Sbus.lpNorm<1>() << std::endl;  // TODO DEBUG WINDOWS
-    ErrorType error = _linear_solver.solve(dcYbus_noslack_, Va_dc_without_slack, has_just_been_factorized);
+    ErrorType error = _linear_solver.solve(dcYbus_noslack_, Va_dc_without_slack, ybus_factorized_);
     if(error != ErrorType::NoError){
         err_ = error;
+        ybus_factorized_ = false;
         timer_total_nr_ += timer.duration();
         return false;
     }
+    ybus_factorized_ = true;
+
+    // take into account the modifications of the dc ybus (if any) without refactorizing it
+    if(!ybus_modifs_.empty()){
+        error = apply_ybus_modifs(Va_dc_without_slack);
+        if(error != ErrorType::NoError){
+            err_ = error;
+            timer_total_nr_ += timer.duration();
+            return false;
+        }
+    }
     
     if(!Va_dc_without_slack.array().allFinite() || (Va_dc_without_slack.lpNorm<Eigen::Infinity>() >= 1e6)){
         // for convergence, all values should be finite
@@ -182,6 +138,218 @@ bool BaseDCAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<cplx_type> &
     return true;
 }
 
+template<class LinearSolver>
+void BaseDCAlgo<LinearSolver>::prepare_dcYbus(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                                              const Eigen::VectorXi & slack_ids,
+                                              const Eigen::VectorXi & pv,
+                                              const Eigen::VectorXi & pq)
+{
+    if(need_factorize_ ||
+       _solver_control.need_reset_solver() || 
+       _solver_control.has_dimension_changed() ||
+       _solver_control.has_slack_participate_changed() ||  // the full "ybus without slack" has changed, everything needs to be recomputed_solver_control.ybus_change_sparsity_pattern()
+       _solver_control.ybus_change_sparsity_pattern() ||
+       _solver_control.has_ybus_some_coeffs_zero()
+       ){
+       reset();
+    }
+    err_ = ErrorType::NoError;  // reset the error if previous error happened
+    
+    sizeYbus_with_slack_ = static_cast<int>(Ybus.rows());
+
+    #ifdef __COUT_TIMES
+        auto timer_preproc = CustTimer();
+    #endif // __COUT_TIMES
+
+    if(need_factorize_ || 
+       _solver_control.has_pv_changed() || 
+       _solver_control.has_pq_changed()) {    
+
+        // TODO SLACK (for now i put all slacks as PV, except the first one)
+        // this should be handled in Sbus, because we know the amount of power absorbed by the slack
+        // so we can compute it correctly !
+        // std::cout << "\t\t\tneed to retrieve slack\n";
+        my_pv_ = retrieve_pv_with_slack(slack_ids, pv);
+
+        // find the slack buses
+        slack_buses_ids_solver_ = extract_slack_bus_id(my_pv_, pq, sizeYbus_with_slack_);
+        sizeYbus_without_slack_ = sizeYbus_with_slack_ - slack_buses_ids_solver_.size();
+
+        // corresp bus -> solverbus
+        fill_mat_bus_id(sizeYbus_with_slack_);
+    }
+
+    // remove the slack bus from Ybus
+    if(need_factorize_ || 
+       _solver_control.need_recompute_ybus() ||
+       _solver_control.ybus_change_sparsity_pattern() ||
+       _solver_control.has_ybus_some_coeffs_zero()) {
+        // std::cout << "\t\t\tneed to sizeYbus_with_slack_\n";
+        fill_dcYbus_noslack(sizeYbus_with_slack_, Ybus);
+        ybus_factorized_ = false;  // force a call to "factor" the linear solver as the lhs (ybus) changed
+        // no need to refactor if ybus did not change
+    }
+    
+    #ifdef __COUT_TIMES
+        std::cout << "\t dc: preproc: " << 1000. * timer_preproc.duration() << "ms" << std::endl;
+    #endif // __COUT_TIMES
+}
+
+template<class LinearSolver>
+bool BaseDCAlgo<LinearSolver>::factorize_dcYbus()
+{
+    if(!need_factorize_) return true;
+    // std::cout << "\t\t\tneed to factorize\n";
+    ErrorType status_init = _linear_solver.initialize(dcYbus_noslack_);
+    if(status_init != ErrorType::NoError){
+        err_ = status_init;
+        return false;
+    }
+    need_factorize_ = false;
+    ybus_factorized_ = true;
+    return true;
+}
+
+template<class LinearSolver>
+bool BaseDCAlgo<LinearSolver>::compute_pf_multi(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                                                const CplxVect & V,
+                                                const RealMat & Sbuses,
+                                                const Eigen::VectorXi & slack_ids,
+                                                const RealVect & slack_weights,
+                                                const Eigen::VectorXi & pv,
+                                                const Eigen::VectorXi & pq,
+                                                RealMat & Va
+                                                )
+{
+    if(!is_linear_solver_valid()) return false;
+    BaseAlgo::reset_timer();
+
+    auto timer = CustTimer();
+    prepare_dcYbus(Ybus, slack_ids, pv, pq);
+    if(!factorize_dcYbus()){
+        timer_total_nr_ += timer.duration();
+        return false;
+    }
+
+    // remove the slack buses from the right hand sides
+    const Eigen::Index nb_rhs = Sbuses.cols();
+    RealMat Va_dc_without_slack(sizeYbus_without_slack_, nb_rhs);
+    for (int k=0; k < sizeYbus_with_slack_; ++k){
+        if(mat_bus_id_(k) == -1) continue;  // I don't add anything to the slack bus
+        Va_dc_without_slack.row(mat_bus_id_(k)) = Sbuses.row(k);
+    }
+
+    // solve for all theta at once
+    ErrorType error = _linear_solver.solve(dcYbus_noslack_, Va_dc_without_slack, ybus_factorized_);
+    if(error != ErrorType::NoError){
+        err_ = error;
+        ybus_factorized_ = false;
+        timer_total_nr_ += timer.duration();
+        return false;
+    }
+    ybus_factorized_ = true;
+
+    // take into account the modifications of the dc ybus (if any) without refactorizing it
+    if(!ybus_modifs_.empty()){
+        error = apply_ybus_modifs(Va_dc_without_slack);
+        if(error != ErrorType::NoError){
+            err_ = error;
+            timer_total_nr_ += timer.duration();
+            return false;
+        }
+    }
+
+    // retrieve back the results in the proper shape (add back the slack bus)
+    Va = RealMat::Constant(sizeYbus_with_slack_, nb_rhs, std::arg(V(slack_buses_ids_solver_(0))));
+    for (int ybus_id=0; ybus_id < sizeYbus_with_slack_; ++ybus_id){
+        if(mat_bus_id_(ybus_id) == -1) continue;  // slack bus is handled elsewhere
+        Va.row(ybus_id) += Va_dc_without_slack.row(mat_bus_id_(ybus_id));
+    }
+
+    // same criteria as in compute_pf for each right hand side
+    for(Eigen::Index col_id = 0; col_id < nb_rhs; ++col_id){
+        const auto Va_col = Va_dc_without_slack.col(col_id);
+        if(Va_col.array().allFinite() && (Va_col.template lpNorm<Eigen::Infinity>() < 1e6)) continue;
+        Va.col(col_id).array() = std::numeric_limits<real_type>::quiet_NaN();
+    }
+    nr_iter_ = 1;
+
+    // dcSbus_noslack_ does not correspond to any of the Sbuses
+    _solver_control.tell_none_changed();
+    _solver_control.tell_recompute_sbus();
+    timer_total_nr_ += timer.duration();
+    return true;
+}
+
+template<class LinearSolver>
+template<typename va_type>  // va_type should be `RealVect` or `RealMat`
+ErrorType BaseDCAlgo<LinearSolver>::apply_ybus_modifs(va_type & Va_dc_without_slack){
+    // dcYbus_noslack_ + ybus_modifs_ = B + E . D . E^T where E selects the (non slack) buses 
+    // concerned by the modifications and D is a small dense matrix.
+    // D is decomposed with a rank revealing LU as D = L . R (L has r columns and R has r rows, r being the 
+    // rank of D) so that, with U = E . L and W^T = R . E^T, the Woodbury identity gives:
+    // (B + U.W^T)^{-1} = B^{-1} - Z . (I + W^T . Z)^{-1} . W^T . B^{-1}  with Z = B^{-1} . U
+    // For a "n-k" the rank of D is (at most) k: only k linear systems (with the factorization of B) are solved.
+    std::vector<int> buses;
+    buses.reserve(2 * ybus_modifs_.size());
+    for(const Coeff & coeff : ybus_modifs_){
+        const int row_res = mat_bus_id_(static_cast<int>(coeff.row_id));
+        const int col_res = mat_bus_id_(static_cast<int>(coeff.col_id));
+        if((row_res == -1) || (col_res == -1)) continue;  // slack buses are not in dcYbus_noslack_
+        buses.push_back(row_res);
+        buses.push_back(col_res);
+    }
+    std::sort(buses.begin(), buses.end());
+    buses.erase(std::unique(buses.begin(), buses.end()), buses.end());
+    const Eigen::Index nb_bus = buses.size();
+    if(nb_bus == 0) return ErrorType::NoError;
+
+    RealMat D = RealMat::Zero(nb_bus, nb_bus);
+    for(const Coeff & coeff : ybus_modifs_){
+        const int row_res = mat_bus_id_(static_cast<int>(coeff.row_id));
+        const int col_res = mat_bus_id_(static_cast<int>(coeff.col_id));
+        if((row_res == -1) || (col_res == -1)) continue;
+        const auto row_id = std::lower_bound(buses.begin(), buses.end(), row_res) - buses.begin();
+        const auto col_id = std::lower_bound(buses.begin(), buses.end(), col_res) - buses.begin();
+        D(row_id, col_id) += std::real(coeff.value);
+    }
+
+    const real_type tol = 1e-12;  // relative tolerance to consider a pivot of D is 0.
+    if(D.cwiseAbs().maxCoeff() == 0.) return ErrorType::NoError;
+    // D = P^{-1} . LU_l . LU_u . Q^{-1} (full pivoting): only the first "rank" columns of LU_l 
+    // (resp. rows of LU_u) are used
+    Eigen::FullPivLU<RealMat> d_lu(nb_bus, nb_bus);
+    d_lu.setThreshold(tol);
+    d_lu.compute(D);
+    const Eigen::Index rank = d_lu.rank();
+    if(rank == 0) return ErrorType::NoError;
+    RealMat L = RealMat::Identity(nb_bus, rank);
+    L.triangularView<Eigen::StrictlyLower>() = d_lu.matrixLU().leftCols(rank);
+    L = d_lu.permutationP().transpose() * L;
+    RealMat R = d_lu.matrixLU().topRows(rank).triangularView<Eigen::Upper>();  // W^T restricted to the buses concerned
+    R = R * d_lu.permutationQ().transpose();
+
+    // Z = B^{-1} . U (one linear system per column)
+    RealMat Z(sizeYbus_without_slack_, rank);
+    RealVect rhs;
+    for(Eigen::Index j = 0; j < rank; ++j){
+        rhs = RealVect::Zero(sizeYbus_without_slack_);
+        rhs(buses) = L.col(j);
+        ErrorType error = _linear_solver.solve(dcYbus_noslack_, rhs, true);
+        if(error != ErrorType::NoError) return error;
+        Z.col(j) = rhs;
+    }
+
+    // capacitance matrix (singular if the modified matrix is, eg. the grid is split)
+    RealMat capacitance = R * Z(buses, Eigen::all);
+    capacitance.diagonal().array() += 1.;
+    Eigen::FullPivLU<RealMat> lu(capacitance);
+    if(!lu.isInvertible()) return ErrorType::SingularMatrix;
+    const RealMat tmp = lu.solve(R * Va_dc_without_slack(buses, Eigen::all));
+    Va_dc_without_slack -= Z * tmp;
+    return ErrorType::NoError;
+}
+
 template<class LinearSolver>
 void BaseDCAlgo<LinearSolver>::fill_mat_bus_id(int nb_bus_solver){
     mat_bus_id_ = Eigen::VectorXi::Constant(nb_bus_solver, -1);
@@ -229,6 +397,7 @@ void BaseDCAlgo<LinearSolver>::reset(){
     BaseAlgo::reset();
     _linear_solver.reset();
     need_factorize_ = true;
+    ybus_factorized_ = false;
     sizeYbus_with_slack_ = 0;
     sizeYbus_without_slack_ = 0;
     dcSbus_noslack_ = RealVect();
@@ -236,6 +405,7 @@ void BaseDCAlgo<LinearSolver>::reset(){
     my_pv_ = Eigen::VectorXi();
     slack_buses_ids_solver_ = Eigen::VectorXi();
     mat_bus_id_ = Eigen::VectorXi();
+    ybus_modifs_.clear();  // see update_internal_Ybus
 }
 
 template<class LinearSolver>
@@ -79,9 +79,8 @@ class BaseFDPFAlgo: public BaseAlgo
                                    real_type slack_absorbed,
                                    const RealVect & slack_weights)
         {
-            CplxVect tmp = Ybus * V;  // this is a vector
-            tmp = tmp.array().conjugate();  // i take the conjugate
-            auto mis = V.array() * tmp.array() - Sbus.array() + slack_absorbed * slack_weights.array();
+            compute_Ibus(Ybus, V, Ibus_);
+            auto mis = V.array() * Ibus_.array().conjugate() - Sbus.array() + slack_absorbed * slack_weights.array();
             return mis;
         }
         
@@ -9,6 +9,9 @@
 #ifndef BASE_NR_ALGO_H
 #define BASE_NR_ALGO_H
 
+#include <limits>
+#include <algorithm>  // for std::lower_bound
+
 #include "BaseAlgo.h"
 
 /**
@@ -21,6 +24,11 @@ class BaseNRAlgo : public BaseAlgo
         BaseNRAlgo():
             BaseAlgo(true),
             need_factorize_(true),
+            refactor_every_(1),
+            refactor_ratio_(0.1),
+            nb_iter_since_refactor_(0),
+            ybus_values_changed_(false),
+            nb_factorization_(0),
             timer_initialize_(0.),
             timer_dSbus_(0.),
             timer_fillJ_(0.),
@@ -50,10 +58,40 @@ class BaseNRAlgo : public BaseAlgo
                                     timer_fillJ_,
                                     timer_Va_Vm_,
                                     timer_pre_proc_,
-                                    timer_total_nr_);
+                                    timer_total_nr_,
+                                    nb_factorization_);
             return res;
         }
 
+        // jacobian reuse ("dishonest" Newton): a factorization of the jacobian is used for at most
+        // refactor_every iterations (counted over successive calls to compute_pf, if nothing but Sbus changed:
+        // the values of Ybus should not have been modified, see tell_ybus_values_changed).
+        // It is computed again sooner if an iteration using an older factorization does not reduce the mismatch
+        // by at least refactor_ratio (and this iteration is reverted, and not counted in max_iter, if the mismatch
+        // did not decrease).
+        // refactor_every = 1 (default) is the usual Newton Raphson.
+        void set_jacobian_reuse(int refactor_every, real_type refactor_ratio){
+            if(refactor_every < 1){
+                std::ostringstream exc_;
+                exc_ << "BaseNRAlgo::set_jacobian_reuse: refactor_every should be >= 1, you provided " << refactor_every << ".";
+                throw std::runtime_error(exc_.str());
+            }
+            if(!(refactor_ratio > 0.) || refactor_ratio > 1.){
+                std::ostringstream exc_;
+                exc_ << "BaseNRAlgo::set_jacobian_reuse: refactor_ratio should be in ]0, 1], you provided " << refactor_ratio << ".";
+                throw std::runtime_error(exc_.str());
+            }
+            refactor_every_ = refactor_every;
+            refactor_ratio_ = refactor_ratio;
+        }
+        int get_refactor_every() const {return refactor_every_;}
+        real_type get_refactor_ratio() const {return refactor_ratio_;}
+
+        // the values (but not the sparsity pattern) of Ybus have been modified in place since the last call
+        // to compute_pf: the last factorization of the jacobian cannot be reused (see set_jacobian_reuse),
+        // everything else (eg. j_scatter_) stays valid.
+        void tell_ybus_values_changed(){ybus_values_changed_ = true;}
+
         virtual
         bool compute_pf(const Eigen::SparseMatrix<cplx_type> & Ybus,
                         CplxVect & V,
@@ -66,6 +104,15 @@ class BaseNRAlgo : public BaseAlgo
                         real_type tol
                         ) ;
 
+        virtual
+        bool predict_V(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                       CplxVect & V,
+                       const CplxVect & Sbus,
+                       const Eigen::VectorXi & slack_ids,
+                       const RealVect & slack_weights,
+                       const Eigen::VectorXi & pv,
+                       const Eigen::VectorXi & pq);
+
         virtual void reset();
 
     protected:
@@ -76,6 +123,7 @@ class BaseNRAlgo : public BaseAlgo
             timer_Va_Vm_ = 0.;
             timer_pre_proc_ = 0.;
             timer_initialize_ = 0.;
+            nb_factorization_ = 0;
         }
         virtual
         void initialize(){
@@ -135,9 +183,8 @@ class BaseNRAlgo : public BaseAlgo
                                   const std::vector<int> & pvpq_inv
                                   );
         void fill_jacobian_matrix_kown_sparsity_pattern(
-                 Eigen::Index slack_bus_id,
-                 const Eigen::VectorXi & pq,
-                 const Eigen::VectorXi & pvpq
+                 const Eigen::SparseMatrix<cplx_type> & Ybus,
+                 const CplxVect & V
                  );
         void fill_jacobian_matrix_unkown_sparsity_pattern(
                  const Eigen::SparseMatrix<cplx_type> & Ybus,
@@ -150,10 +197,29 @@ class BaseNRAlgo : public BaseAlgo
                  const std::vector<int> & pvpq_inv
                  );
 
-        void fill_value_map(Eigen::Index slack_bus_id,
-                            const Eigen::VectorXi & pq,
-                            const Eigen::VectorXi & pvpq,
-                            bool reset_J);
+        void fill_scatter_map(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                              Eigen::Index slack_bus_id,  // -1 if J_ has no row for the ref slack bus
+                              Eigen::Index n_pvpq,
+                              const std::vector<int> & pq_inv,
+                              const std::vector<int> & pvpq_inv,
+                              Eigen::Index lag,  // 1 if the first row and column of J_ are for the slack bus, 0 otherwise
+                              bool reset_J);
+
+        // whether the last factorization of the jacobian can still be used (nothing changed
+        // in the grid, except the injections, since the last call to compute_pf). Whoever modifies
+        // the values of Ybus in place should tell it with tell_ybus_values_changed.
+        bool can_reuse_factorization() const{
+            return !need_factorize_ &&
+                   !ybus_values_changed_ &&
+                   !_solver_control.need_reset_solver() &&
+                   !_solver_control.has_dimension_changed() &&
+                   !_solver_control.ybus_change_sparsity_pattern() &&
+                   !_solver_control.has_ybus_some_coeffs_zero() &&
+                   !_solver_control.need_recompute_ybus() &&
+                   !_solver_control.has_slack_participate_changed() &&
+                   !_solver_control.has_pv_changed() &&
+                   !_solver_control.has_pq_changed();
+        }
 
         void reset_if_needed(){
             if(_solver_control.need_reset_solver() || 
@@ -173,15 +239,21 @@ class BaseNRAlgo : public BaseAlgo
 
         // solution of the problem
         Eigen::SparseMatrix<real_type> J_;  // the jacobian matrix
-        Eigen::SparseMatrix<cplx_type> dS_dVm_;
-        Eigen::SparseMatrix<cplx_type> dS_dVa_;
+        Eigen::SparseMatrix<cplx_type> dS_dVm_;  // only used to compute the sparsity pattern of J_
+        Eigen::SparseMatrix<cplx_type> dS_dVa_;  // only used to compute the sparsity pattern of J_
         bool need_factorize_;
 
-        // to store the mapping from the element of J_ in dS_dVm_ and dS_dVa_
-        // it does not own any memory at all !
-        std::vector<cplx_type*> value_map_;
-        // std::vector<int> col_map_;
-        // std::vector<int> row_map_;
+        // jacobian reuse (see set_jacobian_reuse)
+        int refactor_every_;
+        real_type refactor_ratio_;
+        int nb_iter_since_refactor_;  // number of iterations made with the current factorization
+        bool ybus_values_changed_;  // the current factorization was made with other values of Ybus (see tell_ybus_values_changed)
+        int nb_factorization_;  // number of (re)factorizations of the jacobian in the last call to compute_pf
+
+        // for each element of Ybus (in the order of its InnerIterator), the position in J_.valuePtr()
+        // of: real(dS_dVa), imag(dS_dVa), real(dS_dVm) and imag(dS_dVm) (-1 if not in J_)
+        // see fill_scatter_map and fill_jacobian_matrix_kown_sparsity_pattern
+        std::vector<int> j_scatter_;
 
         // timers
         double timer_initialize_;
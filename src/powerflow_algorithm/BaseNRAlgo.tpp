@@ -82,7 +82,8 @@ bool BaseNRAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<cplx_type> &
 
     // first check, if the problem is already solved, i stop there
     // compute a first time the mismatch to initialize the slack bus
-    RealVect F = _evaluate_Fx(Ybus, V, Sbus, slack_bus_id, slack_absorbed, slack_weights, my_pv, pq);
+    RealVect F;
+    _evaluate_Fx(Ybus, V, Sbus, slack_bus_id, slack_absorbed, slack_weights, my_pv, pq, F);
 
     bool converged = _check_for_convergence(F, tol);
     nr_iter_ = 0; //current step
@@ -102,29 +103,39 @@ bool BaseNRAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<cplx_type> &
        _solver_control.has_pq_changed()
        )
        {
-        value_map_.clear();  // TODO smarter solver: only needed if ybus has changed
-        // BaseNRAlgo<LinearSolver>::col_map_.clear();  // TODO smarter solver: only needed if ybus has changed
-        // BaseNRAlgo<LinearSolver>::row_map_.clear();  // TODO smarter solver: only needed if ybus has changed
-        dS_dVm_.resize(0,0);  // TODO smarter solver: only needed if ybus has changed
-        dS_dVa_.resize(0,0);  // TODO smarter solver: only needed if ybus has changed
-        // BaseNRAlgo<LinearSolver>::dS_dVm_.setZero();  // TODO smarter solver: only needed if ybus has changed
-        // BaseNRAlgo<LinearSolver>::dS_dVa_.setZero();  // TODO smarter solver: only needed if ybus has changed
+        j_scatter_.clear();  // TODO smarter solver: only needed if ybus has changed
 
        }
+    // the factorization of the last call can be reused (see set_jacobian_reuse) only if nothing but Sbus changed
+    bool need_refactor = !can_reuse_factorization();
+    real_type mismatch = F.lpNorm<Eigen::Infinity>();
+    // state before an iteration made with an older factorization (to revert it if needed)
+    CplxVect V_bak;
+    RealVect Vm_bak, Va_bak, F_bak;
+    real_type slack_absorbed_bak = slack_absorbed;
     while ((!converged) & (nr_iter_ < max_iter)){
         nr_iter_++;
-        fill_jacobian_matrix(Ybus, V_, slack_bus_id, slack_weights, pq, pvpq, pq_inv, pvpq_inv);
-
-        if(need_factorize_){
-            initialize();
-            if(err_ != ErrorType::NoError){
-                // I got an error during the initialization of the linear system, i need to stop here
-                res = false;
-                break;
+        const bool reuse_J = !need_refactor && !need_factorize_ && nb_iter_since_refactor_ < refactor_every_;
+        if(reuse_J){
+            V_bak = V_;
+            Vm_bak = Vm_;
+            Va_bak = Va_;
+            F_bak = F;
+            slack_absorbed_bak = slack_absorbed;
+        }else{
+            fill_jacobian_matrix(Ybus, V_, slack_bus_id, slack_weights, pq, pvpq, pq_inv, pvpq_inv);
+
+            if(need_factorize_){
+                initialize();
+                if(err_ != ErrorType::NoError){
+                    // I got an error during the initialization of the linear system, i need to stop here
+                    res = false;
+                    break;
+                }
+                has_just_been_initialized = true;
             }
-            has_just_been_initialized = true;
         }
-        solve(F, has_just_been_initialized);
+        solve(F, has_just_been_initialized || reuse_J);  // with reuse_J, the last factorization is used
 
         has_just_been_initialized = false;
         if(err_ != ErrorType::NoError){
@@ -132,6 +143,14 @@ bool BaseNRAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<cplx_type> &
             res = false;
             break;
         }
+        if(reuse_J){
+            ++nb_iter_since_refactor_;
+        }else{
+            nb_iter_since_refactor_ = 1;
+            ybus_values_changed_ = false;
+            ++nb_factorization_;
+        }
+        need_refactor = false;
         // const auto dx = -F;  // removed for speed optimization (-= used below)
 
         auto timer_va_vm = CustTimer();
@@ -160,12 +179,29 @@ bool BaseNRAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<cplx_type> &
         }
         timer_Va_Vm_ += timer_va_vm.duration();
 
-        F = _evaluate_Fx(Ybus, V_, Sbus, slack_bus_id, slack_absorbed, slack_weights, my_pv, pq);
+        _evaluate_Fx(Ybus, V_, Sbus, slack_bus_id, slack_absorbed, slack_weights, my_pv, pq, F);
         bool tmp = F.allFinite();
+        const real_type new_mismatch = tmp ? F.lpNorm<Eigen::Infinity>() : std::numeric_limits<real_type>::infinity();
+        if(reuse_J){
+            if(!(new_mismatch < mismatch)){
+                // the old factorization made things worse: this iteration is reverted
+                V_.swap(V_bak);
+                Vm_.swap(Vm_bak);
+                Va_.swap(Va_bak);
+                F.swap(F_bak);
+                slack_absorbed = slack_absorbed_bak;
+                need_refactor = true;
+                --nr_iter_;  // not counted in max_iter (the next iteration uses a new jacobian)
+                continue;
+            }
+            // the old factorization does not help enough anymore
+            if(new_mismatch > refactor_ratio_ * mismatch) need_refactor = true;
+        }
         if(!tmp){
             err_ = ErrorType::InifiniteValue;
             break; // divergence due to Nans
         }
+        mismatch = new_mismatch;
         converged = _check_for_convergence(F, tol);
     }
     if(!converged){
@@ -189,6 +225,54 @@ bool BaseNRAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<cplx_type> &
     return res;
 }
 
+template<class LinearSolver>
+bool BaseNRAlgo<LinearSolver>::predict_V(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                                         CplxVect & V,
+                                         const CplxVect & Sbus,
+                                         const Eigen::VectorXi & slack_ids,
+                                         const RealVect & slack_weights,
+                                         const Eigen::VectorXi & pv,
+                                         const Eigen::VectorXi & pq)
+{
+    /**
+    One newton step from V (typically the solution of the previous powerflow) for the new
+    injections Sbus, using the last factorized jacobian: no jacobian is computed nor factorized here.
+    V is updated only if this step reduces the mismatch.
+    **/
+    if(!can_reuse_factorization()) return false;
+    if(V.size() != Ybus.cols() || Sbus.size() != Ybus.cols()) return false;
+
+    Eigen::VectorXi my_pv = retrieve_pv_with_slack(slack_ids, pv);
+    const auto slack_bus_id = slack_ids(0);
+    const auto n_pv = my_pv.size();
+    const auto n_pq = pq.size();
+    if(J_.cols() != n_pv + 2 * n_pq + 1) return false;
+
+    // slack absorbed consistent with V (active power not balanced by Sbus)
+    const CplxVect tmp = Ybus * V;
+    real_type slack_absorbed = std::real(Sbus.sum()) - (V.array() * tmp.array().conjugate()).real().sum();
+    RealVect F;
+    _evaluate_Fx(Ybus, V, Sbus, slack_bus_id, slack_absorbed, slack_weights, my_pv, pq, F);
+    const real_type mismatch_init = F.lpNorm<Eigen::Infinity>();
+
+    if(_linear_solver.solve(J_, F, true) != ErrorType::NoError) return false;  // factorization is not modified
+
+    RealVect Va = V.array().arg();
+    RealVect Vm = V.array().abs();
+    slack_absorbed -= F(0);
+    if (n_pv > 0) Va(my_pv) -= F.segment(1, n_pv);
+    if (n_pq > 0){
+        Va(pq) -= F.segment(n_pv + 1, n_pq);
+        Vm(pq) -= F.segment(n_pv + n_pq + 1, n_pq);
+    }
+    CplxVect V_pred = Vm.array() * (Va.array().cos().template cast<cplx_type>() + my_i * Va.array().sin().template cast<cplx_type>() );
+
+    _evaluate_Fx(Ybus, V_pred, Sbus, slack_bus_id, slack_absorbed, slack_weights, my_pv, pq, F);
+    if(!F.allFinite() || F.lpNorm<Eigen::Infinity>() >= mismatch_init) return false;
+    V = V_pred;
+    return true;
+}
+
 template<class LinearSolver>
 void BaseNRAlgo<LinearSolver>::reset(){
     BaseAlgo::reset();
@@ -196,7 +280,9 @@ void BaseNRAlgo<LinearSolver>::reset(){
     J_ = Eigen::SparseMatrix<real_type>();  // the jacobian matrix
     dS_dVm_ = Eigen::SparseMatrix<cplx_type>();
     dS_dVa_ = Eigen::SparseMatrix<cplx_type>();
+    j_scatter_.clear();
     need_factorize_ = true;
+    ybus_values_changed_ = false;
     n_ = -1;
     // reset linear solver
     ErrorType reset_status = _linear_solver.reset();
@@ -360,24 +446,24 @@ void BaseNRAlgo<LinearSolver>::fill_jacobian_matrix(const Eigen::SparseMatrix<cp
     `slack` is the representation of the equation connecting together the slack buses (represented by slack_weights)
     the remaining pq components are all 0.
     **/
-    _dSbus_dV(Ybus, V);
-
-    auto timer = CustTimer();
     const auto n_pvpq = pvpq.size();
     const auto n_pq = pq.size();
     const auto size_j = n_pvpq + n_pq + 1;   // +1 because i add the slack bus
 
-    // TODO to gain a bit more time below, try to compute directly, in _dSbus_dV(Ybus, V);
-    // TODO the `dS_dVa_[pvpq, pvpq]`
-    // TODO so that it's easier to retrieve in the next few lines !
     if(J_.cols() != size_j)
     {
         #ifdef __COUT_TIMES
             auto timer2 = CustTimer();
         #endif  // __COUT_TIMES
         // first time i initialized the matrix, so i need to compute its sparsity pattern
+        _dSbus_dV(Ybus, V);
+        auto timer = CustTimer();
         fill_jacobian_matrix_unkown_sparsity_pattern(Ybus, V, slack_bus_id, slack_weights, pq, pvpq, pq_inv, pvpq_inv);
-        fill_value_map(slack_bus_id, pq, pvpq, false);
+        fill_scatter_map(Ybus, slack_bus_id, n_pvpq, pq_inv, pvpq_inv, 1, false);
+        // dS_dVm_ and dS_dVa_ are not used once the sparsity pattern is known
+        dS_dVm_ = Eigen::SparseMatrix<cplx_type>();
+        dS_dVa_ = Eigen::SparseMatrix<cplx_type>();
+        timer_fillJ_ += timer.duration();
         #ifdef __COUT_TIMES
             std::cout << "\t\t fill_jacobian_matrix_unkown_sparsity_pattern : " << timer2.duration() << std::endl;
         #endif  // __COUT_TIMES
@@ -387,15 +473,16 @@ void BaseNRAlgo<LinearSolver>::fill_jacobian_matrix(const Eigen::SparseMatrix<cp
         #ifdef __COUT_TIMES
             auto timer3 = CustTimer();
         #endif  // 
-        if (BaseNRAlgo<LinearSolver>::value_map_.size() == 0) fill_value_map(slack_bus_id, pq, pvpq, true);
-        fill_jacobian_matrix_kown_sparsity_pattern(slack_bus_id,
-                                                   pq, pvpq
-                                                   );
+        if (j_scatter_.size() != 4 * static_cast<size_t>(Ybus.nonZeros())){
+            auto timer = CustTimer();
+            fill_scatter_map(Ybus, slack_bus_id, n_pvpq, pq_inv, pvpq_inv, 1, true);
+            timer_fillJ_ += timer.duration();
+        }
+        fill_jacobian_matrix_kown_sparsity_pattern(Ybus, V);
         #ifdef __COUT_TIMES
             std::cout << "\t\t fill_jacobian_matrix_kown_sparsity_pattern : " << timer3.duration() << std::endl;
         #endif  // __COUT_TIMES
     }
-    timer_fillJ_ += timer.duration();;
 }
 
 template<class LinearSolver>
@@ -564,138 +651,118 @@ void BaseNRAlgo<LinearSolver>::fill_jacobian_matrix_unkown_sparsity_pattern(
 }
 
 /**
-fill the value of the `value_map_` that stores pointers to the elements of
-dS_dVa_ and dS_dVm_ to be used to fill J_
-it requires that J_ is initialized, in compressed mode.
+fill `j_scatter_`: for each element of Ybus, the position in J_.valuePtr() of the
+real and imaginary parts of its derivatives (dS_dVa and dS_dVm), -1 if they are not in J_.
+It requires that J_ is initialized, in compressed mode.
+The column (slack_weights) and row (ref slack bus, slack_bus_id) of the slack bus are
+present only if lag is 1.
 **/
 template<class LinearSolver>
-void BaseNRAlgo<LinearSolver>::fill_value_map(
+void BaseNRAlgo<LinearSolver>::fill_scatter_map(
+        const Eigen::SparseMatrix<cplx_type> & Ybus,
         Eigen::Index slack_bus_id,
-        const Eigen::VectorXi & pq,
-        const Eigen::VectorXi & pvpq,
+        Eigen::Index n_pvpq,
+        const std::vector<int> & pq_inv,
+        const std::vector<int> & pvpq_inv,
+        Eigen::Index lag,
         bool reset_J
         )
 {
-    const int n_pvpq = static_cast<int>(pvpq.size());
-    value_map_ = std::vector<cplx_type*> ();
-    value_map_.reserve(BaseNRAlgo<LinearSolver>::J_.nonZeros());
-    // col_map_ = std::vector<int> (J_.nonZeros());
-    // row_map_ = std::vector<int> (J_.nonZeros());
-
-    const auto n_row = J_.cols();
-    // unsigned int pos_el = 0;
-    for (Eigen::Index col_=1; col_ < n_row; ++col_){  // last column is never updated (slack equation)
-        for (Eigen::SparseMatrix<real_type>::InnerIterator it(J_, col_); it; ++it)
+    typedef Eigen::SparseMatrix<real_type>::StorageIndex StorageIndex;
+    const Eigen::Index n_col = J_.cols();
+    if(reset_J){
+        // "forget" previous J value: some elements of J_ might not be in Ybus anymore
+        // (the column of the slack bus, if any, is never updated)
+        for (Eigen::Index col_id=lag; col_id < n_col; ++col_id){
+            for (Eigen::SparseMatrix<real_type>::InnerIterator it(J_, col_id); it; ++it) it.valueRef() = 0.;
+        }
+    }
+
+    const StorageIndex * outer_ptr = J_.outerIndexPtr();
+    const StorageIndex * inner_ptr = J_.innerIndexPtr();
+    // position of element (row_id, col_id) in J_.valuePtr(), -1 if not present
+    auto get_pos = [outer_ptr, inner_ptr](Eigen::Index row_id, Eigen::Index col_id) -> int {
+        if((row_id < 0) || (col_id < 0)) return -1;
+        const StorageIndex * beg = inner_ptr + outer_ptr[col_id];
+        const StorageIndex * end = inner_ptr + outer_ptr[col_id + 1];
+        const StorageIndex * el = std::lower_bound(beg, end, static_cast<StorageIndex>(row_id));
+        if((el == end) || (*el != row_id)) return -1;
+        return static_cast<int>(el - inner_ptr);
+    };
+
+    j_scatter_.clear();
+    j_scatter_.reserve(4 * static_cast<size_t>(Ybus.nonZeros()));
+    for (Eigen::Index col_id=0; col_id < Ybus.cols(); ++col_id){
+        // columns of J_ for the derivatives with respect to Va[col_id] and Vm[col_id]
+        const Eigen::Index J_col_va = pvpq_inv[col_id] >= 0 ? pvpq_inv[col_id] + lag : -1;
+        const Eigen::Index J_col_vm = pq_inv[col_id] >= 0 ? pq_inv[col_id] + n_pvpq + lag : -1;
+        for (Eigen::SparseMatrix<cplx_type>::InnerIterator it(Ybus, col_id); it; ++it)
         {
-            auto row_id = it.row();
-            const auto col_id = it.col() - 1;  // it's equal to "col_"
-            if(reset_J) it.valueRef() = 0.; // "forget" previous J value in this setting
-
-            if(row_id==0){
-                // this is the row of the slack bus
-                const Eigen::Index row_id_dS_dVx_r = slack_bus_id;  // same for both matrices
-                if(col_id < n_pvpq){
-                    const int col_id_dS_dVa_r = pvpq[col_id];
-                    value_map_.push_back(&dS_dVa_.coeffRef(row_id_dS_dVx_r, col_id_dS_dVa_r));
-                }
-                else{
-                    const int col_id_dS_dVm_r = pq[col_id - n_pvpq];
-                    value_map_.push_back(&dS_dVm_.coeffRef(row_id_dS_dVx_r, col_id_dS_dVm_r));
-                }
-            }else{
-                row_id -= 1;  // "do not consider" the row for slack bus (handled above)
-                // this is consistent with the "+1" added in fill_jacobian_matrix_unkown_sparsity_pattern
-                if((col_id < n_pvpq) && (row_id < n_pvpq)){
-                    // this is the J11 part (dS_dVa_r)
-                    const int row_id_dS_dVa_r = pvpq[row_id];
-                    const int col_id_dS_dVa_r = pvpq[col_id];
-                    // this_el = dS_dVa_r.coeff(row_id_dS_dVa_r, col_id_dS_dVa_r);
-                    value_map_.push_back(&dS_dVa_.coeffRef(row_id_dS_dVa_r, col_id_dS_dVa_r));
-
-                    // I don't need to perform these checks: if they failed, the element would not be in J_ in the first place
-                    // const int is_row_non_null = pq_inv[row_id_dS_dVa_r];
-                    // const int is_col_non_null = pq_inv[col_id_dS_dVa_r];
-                    // if(is_row_non_null >= 0 && is_col_non_null >= 0)
-                    //     this_el = dS_dVa_r.coeff(row_id_dS_dVa_r, col_id_dS_dVa_r);
-                    // else
-                    //     std::cout << "dS_dVa_r: missed" << std::endl;
-                }else if((col_id < n_pvpq) && (row_id >= n_pvpq)){
-                    // this is the J21 part (dS_dVa_i)
-                    const int row_id_dS_dVa_i = pq[row_id - n_pvpq];
-                    const int col_id_dS_dVa_i = pvpq[col_id];
-                    // this_el = dS_dVa_i.coeff(row_id_dS_dVa_i, col_id_dS_dVa_i);
-                    value_map_.push_back(&dS_dVa_.coeffRef(row_id_dS_dVa_i, col_id_dS_dVa_i));
-                }else if((col_id >= n_pvpq) && (row_id < n_pvpq)){
-                    // this is the J12 part (dS_dVm_r)
-                    const int row_id_dS_dVm_r = pvpq[row_id];
-                    const int col_id_dS_dVm_r = pq[col_id - n_pvpq];
-                    // this_el = dS_dVm_r.coeff(row_id_dS_dVm_r, col_id_dS_dVm_r);
-                    value_map_.push_back(&dS_dVm_.coeffRef(row_id_dS_dVm_r, col_id_dS_dVm_r));
-                }else if((col_id >= n_pvpq) && (row_id >= n_pvpq)){
-                    // this is the J22 part (dS_dVm_i)
-                    const int row_id_dS_dVm_i = pq[row_id - n_pvpq];
-                    const int col_id_dS_dVm_i = pq[col_id - n_pvpq];
-                    // this_el = dS_dVm_i.coeff(row_id_dS_dVm_i, col_id_dS_dVm_i);
-                    value_map_.push_back(&dS_dVm_.coeffRef(row_id_dS_dVm_i, col_id_dS_dVm_i));
-                }
-            }
-            // go to the next element
-            // ++pos_el;
+            const Eigen::Index row_id = it.row();
+            // rows of J_ for the real (resp. imaginary) part of Sbus[row_id]
+            Eigen::Index J_row_r = -1;
+            if(pvpq_inv[row_id] >= 0) J_row_r = pvpq_inv[row_id] + lag;
+            else if(row_id == slack_bus_id) J_row_r = 0;  // the row of the ref slack bus
+            const Eigen::Index J_row_i = pq_inv[row_id] >= 0 ? pq_inv[row_id] + n_pvpq + lag : -1;
+
+            j_scatter_.push_back(get_pos(J_row_r, J_col_va));
+            j_scatter_.push_back(get_pos(J_row_i, J_col_va));
+            j_scatter_.push_back(get_pos(J_row_r, J_col_vm));
+            j_scatter_.push_back(get_pos(J_row_i, J_col_vm));
         }
     }
-    dS_dVa_.makeCompressed();
-    dS_dVm_.makeCompressed();
 }
 
 template<class LinearSolver>
 void BaseNRAlgo<LinearSolver>::fill_jacobian_matrix_kown_sparsity_pattern(
-        Eigen::Index slack_bus_id,
-        const Eigen::VectorXi & pq,
-        const Eigen::VectorXi & pvpq
+        const Eigen::SparseMatrix<cplx_type> & Ybus,
+        const CplxVect & V
     )
 {
     /**
     This functions fills the jacobian matrix when its sparsity pattern is KNOWN in advance (typically
     the second and next iterations of the Newton Raphson)
-    We don't need to perform heavy computation but just to read the right data from the right matrix!
-    This function is optimized for speed. In particular, it does not "uncompress" the J_ matrix and only
-    change the value pointer (not the inner nor outer pointer)
-    It is optimized only if J_ is in default Eigen format (column)
-
-    Remember, J has the shape:
-    
-    | s | slack_bus |               | (pvpq+1,1) |   (1, pvpq)  |  (1, pq)   |
-    | l |  -------  |               |            | ------------------------- |
-    | a | J11 | J12 | = dimensions: |            | (pvpq, pvpq) | (pvpq, pq) |
-    | c | --------- |               |   ------   | ------------------------- |
-    | k | J21 | J22 |               |  (pq, 1)   |  (pq, pvpq)  | (pq, pq)   |
-
-    python implementation:
-    `J11` = dS_dVa[array([pvpq]).T, pvpq].real
-    `J12` = dS_dVm[array([pvpq]).T, pq].real
-    `J21` = dS_dVa[array([pq]).T, pvpq].imag
-    `J22` = dS_dVm[array([pq]).T, pq].imag
-
-    `slack_bus` = is the representation of the equation for the reference slack bus dS_dVa[slack_bus_id, pvpq].real
-    and dS_dVm[slack_bus_id, pq].real
-
-    `slack` is the representation of the equation connecting together the slack buses (represented by slack_weights)
-    the remaining pq components are all 0.
+    It computes dS_dVa and dS_dVm (same formula as in `_dSbus_dV`) walking Ybus only once and writes
+    them directly in the value pointer of J_ (using `j_scatter_`), without storing them
+    in any intermediate matrix. The inner and outer pointers of J_ are not modified.
 
+    It is used by both the distributed slack and the single slack algorithms (only the
+    `j_scatter_` differs, see `fill_scatter_map`)
     **/
+    auto timer = CustTimer();
+    const CplxVect Vnorm = V.array() / V.array().abs();
+    compute_Ibus(Ybus, V, Ibus_);
+    const CplxVect & Ibus = Ibus_;
+    const CplxVect conjIbus_Vnorm = Ibus.array().conjugate() * Vnorm.array();
+    timer_dSbus_ += timer.duration();
 
-    const auto n_pvpq_1 = pvpq.size() + 1;
-    const auto n_cols = J_.cols();  // equal to nrow
-    unsigned int pos_el = 0;
-    for (Eigen::Index col_id=1; col_id < n_cols; ++col_id){  // last column is not updated (slack equation)
-        for (Eigen::SparseMatrix<real_type>::InnerIterator it(J_, col_id); it; ++it)
+    auto timer_fill = CustTimer();
+    real_type * J_x_ptr = J_.valuePtr();
+    const int * scatter = j_scatter_.data();
+    const Eigen::Index n_col = Ybus.cols();
+    for (Eigen::Index col_id=0; col_id < n_col; ++col_id){
+        for (Eigen::SparseMatrix<cplx_type>::InnerIterator it(Ybus, col_id); it; ++it, scatter += 4)
         {
-            const auto row_id = it.row();
-            // only one if is necessary (magic !)
-            // top rows are "real" part and bottom rows are imaginary part (you can check)
-            it.valueRef() = row_id < n_pvpq_1 ? std::real(*value_map_[pos_el]) : std::imag(*value_map_[pos_el]);
-            // go to the next element
-            ++pos_el;
+            // this element of Ybus is not used in J_ (for example row and column of the ref slack bus)
+            if((scatter[0] < 0) && (scatter[1] < 0) && (scatter[2] < 0) && (scatter[3] < 0)) continue;
+
+            const Eigen::Index row_id = it.row();
+            const cplx_type el_ybus = it.value();
+            cplx_type ds_dvm_el = std::conj(el_ybus * Vnorm(col_id)) * V(row_id);  // dS_dVm[k] = conj(Ybus[k] * Vnorm[Yj[k]]) * V[r]
+            cplx_type ds_dva_el = el_ybus * V(col_id);  // dS_dVa[k] = Ybus[k] * V[Yj[k]]
+            if(col_id == row_id)
+            {
+                ds_dvm_el += conjIbus_Vnorm(row_id); // dS_dVm[k] += conj(Ibus) * Vnorm
+                ds_dva_el -= Ibus(row_id);  // dS_dVa[k] = dS_dVa[k] - Ibus[r]
+            }
+            ds_dva_el = std::conj(-ds_dva_el) * (my_i * V(row_id));  // dS_dVa[k] = conj(-dS_dVa[k]) * (1j * V[r])
+
+            // top rows of J_ are "real" part and bottom rows are imaginary part
+            if(scatter[0] >= 0) J_x_ptr[scatter[0]] = std::real(ds_dva_el);
+            if(scatter[1] >= 0) J_x_ptr[scatter[1]] = std::imag(ds_dva_el);
+            if(scatter[2] >= 0) J_x_ptr[scatter[2]] = std::real(ds_dvm_el);
+            if(scatter[3] >= 0) J_x_ptr[scatter[3]] = std::imag(ds_dvm_el);
         }
     }
+    timer_fillJ_ += timer_fill.duration();
 }
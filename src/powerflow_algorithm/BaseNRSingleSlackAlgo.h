@@ -34,6 +34,15 @@ class BaseNRSingleSlackAlgo : public BaseNRAlgo<LinearSolver>
                         real_type tol
                         );
 
+        virtual
+        bool predict_V(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                       CplxVect & V,
+                       const CplxVect & Sbus,
+                       const Eigen::VectorXi & slack_ids,
+                       const RealVect & slack_weights,
+                       const Eigen::VectorXi & pv,
+                       const Eigen::VectorXi & pq);
+
 
     protected:
         void fill_jacobian_matrix(const Eigen::SparseMatrix<cplx_type> & Ybus,
@@ -43,11 +52,6 @@ class BaseNRSingleSlackAlgo : public BaseNRAlgo<LinearSolver>
                                   const std::vector<int> & pq_inv,
                                   const std::vector<int> & pvpq_inv);
 
-        void fill_jacobian_matrix_kown_sparsity_pattern(
-                 const Eigen::VectorXi & pq,
-                 const Eigen::VectorXi & pvpq
-                 );
-
         void fill_jacobian_matrix_unkown_sparsity_pattern(
                  const Eigen::SparseMatrix<cplx_type> & Ybus,
                  const CplxVect & V,
@@ -57,10 +61,6 @@ class BaseNRSingleSlackAlgo : public BaseNRAlgo<LinearSolver>
                  const std::vector<int> & pvpq_inv
                  );
 
-        void fill_value_map(const Eigen::VectorXi & pq,
-                            const Eigen::VectorXi & pvpq,
-                            bool reset_J);
-
 };
 
 #include "BaseNRSingleSlackAlgo.tpp"
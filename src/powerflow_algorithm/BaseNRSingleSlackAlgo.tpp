@@ -70,7 +70,8 @@ bool BaseNRSingleSlackAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<c
     BaseNRAlgo<LinearSolver>::timer_pre_proc_ += timer_pre_proc.duration();
 
     // first check, if the problem is already solved, i stop there
-    RealVect F = BaseNRAlgo<LinearSolver>::_evaluate_Fx(Ybus, V, Sbus, my_pv, pq);
+    RealVect F;
+    BaseNRAlgo<LinearSolver>::_evaluate_Fx(Ybus, V, Sbus, my_pv, pq, F);
     bool converged = BaseNRAlgo<LinearSolver>::_check_for_convergence(F, tol);
     BaseNRAlgo<LinearSolver>::nr_iter_ = 0; //current step
     bool res = true;  // have i converged or not
@@ -89,34 +90,42 @@ bool BaseNRSingleSlackAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<c
        BaseNRAlgo<LinearSolver>::_solver_control.has_pq_changed()
        )
        {
-        BaseNRAlgo<LinearSolver>::value_map_.clear();  // TODO smarter solver: only needed if ybus has changed
-        // BaseNRAlgo<LinearSolver>::col_map_.clear();  // TODO smarter solver: only needed if ybus has changed
-        // BaseNRAlgo<LinearSolver>::row_map_.clear();  // TODO smarter solver: only needed if ybus has changed
-        BaseNRAlgo<LinearSolver>::dS_dVm_.resize(0,0);  // TODO smarter solver: only needed if ybus has changed
-        BaseNRAlgo<LinearSolver>::dS_dVa_.resize(0,0);  // TODO smarter solver: only needed if ybus has changed
-        // BaseNRAlgo<LinearSolver>::dS_dVm_.setZero();  // TODO smarter solver: only needed if ybus has changed
-        // BaseNRAlgo<LinearSolver>::dS_dVa_.setZero();  // TODO smarter solver: only needed if ybus has changed
+        BaseNRAlgo<LinearSolver>::j_scatter_.clear();  // TODO smarter solver: only needed if ybus has changed
 
        }
+    // the factorization of the last call can be reused (see set_jacobian_reuse) only if nothing but Sbus changed
+    bool need_refactor = !BaseNRAlgo<LinearSolver>::can_reuse_factorization();
+    real_type mismatch = F.lpNorm<Eigen::Infinity>();
+    // state before an iteration made with an older factorization (to revert it if needed)
+    CplxVect V_bak;
+    RealVect F_bak;
     while ((!converged) & (BaseNRAlgo<LinearSolver>::nr_iter_ < max_iter)){
         BaseNRAlgo<LinearSolver>::nr_iter_++;
         // std::cout << "\tnr_iter_ " << BaseNRAlgo<LinearSolver>::nr_iter_ << std::endl;
-        fill_jacobian_matrix(Ybus, BaseNRAlgo<LinearSolver>::V_, pq, pvpq, pq_inv, pvpq_inv);
-        if(BaseNRAlgo<LinearSolver>::need_factorize_){
-            BaseNRAlgo<LinearSolver>::initialize();
-            if(BaseNRAlgo<LinearSolver>::err_ != ErrorType::NoError){
-                // I got an error during the initialization of the linear system, i need to stop here
-                // std::cout << BaseNRAlgo<LinearSolver>::err_ << std::endl;
-                res = false;
-                break;
-            }
-            has_just_been_initialized = true;
-            // std::cout << "I just factorized" << std::endl;
+        const bool reuse_J = !need_refactor && 
+                             !BaseNRAlgo<LinearSolver>::need_factorize_ && 
+                             BaseNRAlgo<LinearSolver>::nb_iter_since_refactor_ < BaseNRAlgo<LinearSolver>::refactor_every_;
+        if(reuse_J){
+            V_bak = BaseNRAlgo<LinearSolver>::V_;
+            F_bak = F;
         }else{
-            // std::cout << "no need to factorize" << std::endl;
+            fill_jacobian_matrix(Ybus, BaseNRAlgo<LinearSolver>::V_, pq, pvpq, pq_inv, pvpq_inv);
+            if(BaseNRAlgo<LinearSolver>::need_factorize_){
+                BaseNRAlgo<LinearSolver>::initialize();
+                if(BaseNRAlgo<LinearSolver>::err_ != ErrorType::NoError){
+                    // I got an error during the initialization of the linear system, i need to stop here
+                    // std::cout << BaseNRAlgo<LinearSolver>::err_ << std::endl;
+                    res = false;
+                    break;
+                }
+                has_just_been_initialized = true;
+                // std::cout << "I just factorized" << std::endl;
+            }else{
+                // std::cout << "no need to factorize" << std::endl;
+            }
         }
 
-        BaseNRAlgo<LinearSolver>::solve(F, has_just_been_initialized);
+        BaseNRAlgo<LinearSolver>::solve(F, has_just_been_initialized || reuse_J);  // with reuse_J, the last factorization is used
 
         has_just_been_initialized = false;
         if(BaseNRAlgo<LinearSolver>::err_ != ErrorType::NoError){
@@ -125,6 +134,14 @@ bool BaseNRSingleSlackAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<c
             res = false;
             break;
         }
+        if(reuse_J){
+            ++BaseNRAlgo<LinearSolver>::nb_iter_since_refactor_;
+        }else{
+            BaseNRAlgo<LinearSolver>::nb_iter_since_refactor_ = 1;
+            BaseNRAlgo<LinearSolver>::ybus_values_changed_ = false;
+            ++BaseNRAlgo<LinearSolver>::nb_factorization_;
+        }
+        need_refactor = false;
         // auto dx = -F;
         auto timer_va_vm = CustTimer();
         BaseNRAlgo<LinearSolver>::Vm_ = BaseNRAlgo<LinearSolver>::V_.array().abs();  // update Vm and Va again in case
@@ -150,13 +167,28 @@ bool BaseNRSingleSlackAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<c
         }
         BaseNRAlgo<LinearSolver>::timer_Va_Vm_ += timer_va_vm.duration();
 
-        F = BaseNRAlgo<LinearSolver>::_evaluate_Fx(Ybus, BaseNRAlgo<LinearSolver>::V_, Sbus, my_pv, pq);
+        BaseNRAlgo<LinearSolver>::_evaluate_Fx(Ybus, BaseNRAlgo<LinearSolver>::V_, Sbus, my_pv, pq, F);
         bool tmp = F.allFinite();
+        const real_type new_mismatch = tmp ? F.lpNorm<Eigen::Infinity>() : std::numeric_limits<real_type>::infinity();
+        if(reuse_J){
+            if(!(new_mismatch < mismatch)){
+                // the old factorization made things worse: this iteration is reverted
+                // (Vm_ and Va_ are computed from V_ at the next iteration)
+                BaseNRAlgo<LinearSolver>::V_.swap(V_bak);
+                F.swap(F_bak);
+                need_refactor = true;
+                --BaseNRAlgo<LinearSolver>::nr_iter_;  // not counted in max_iter (the next iteration uses a new jacobian)
+                continue;
+            }
+            // the old factorization does not help enough anymore
+            if(new_mismatch > BaseNRAlgo<LinearSolver>::refactor_ratio_ * mismatch) need_refactor = true;
+        }
         if(!tmp){
             BaseNRAlgo<LinearSolver>::err_ = ErrorType::InifiniteValue;
             // std::cout << BaseNRAlgo<LinearSolver>::err_ << std::endl;
             break; // divergence due to Nans
         }
+        mismatch = new_mismatch;
         converged = BaseNRAlgo<LinearSolver>::_check_for_convergence(F, tol);
     }
     if(!converged){
@@ -182,6 +214,48 @@ bool BaseNRSingleSlackAlgo<LinearSolver>::compute_pf(const Eigen::SparseMatrix<c
     return res;
 }
 
+template<class LinearSolver>
+bool BaseNRSingleSlackAlgo<LinearSolver>::predict_V(const Eigen::SparseMatrix<cplx_type> & Ybus,
+                                                    CplxVect & V,
+                                                    const CplxVect & Sbus,
+                                                    const Eigen::VectorXi & slack_ids,  // unused here
+                                                    const RealVect & slack_weights,  // unused here
+                                                    const Eigen::VectorXi & pv,
+                                                    const Eigen::VectorXi & pq)
+{
+    /**
+    Same as BaseNRAlgo::predict_V, with the jacobian of the single slack formulation
+    **/
+    if(!BaseNRAlgo<LinearSolver>::can_reuse_factorization()) return false;
+    if(V.size() != Ybus.cols() || Sbus.size() != Ybus.cols()) return false;
+
+    const auto n_pv = pv.size();
+    const auto n_pq = pq.size();
+    if(BaseNRAlgo<LinearSolver>::J_.cols() != n_pv + 2 * n_pq) return false;
+
+    RealVect F;
+    BaseNRAlgo<LinearSolver>::_evaluate_Fx(Ybus, V, Sbus, pv, pq, F);
+    const real_type mismatch_init = F.lpNorm<Eigen::Infinity>();
+
+    // factorization is not modified
+    if(BaseNRAlgo<LinearSolver>::_linear_solver.solve(BaseNRAlgo<LinearSolver>::J_, F, true) != ErrorType::NoError) return false;
+
+    RealVect Va = V.array().arg();
+    RealVect Vm = V.array().abs();
+    if (n_pv > 0) Va(pv) -= F.segment(0, n_pv);
+    if (n_pq > 0){
+        Va(pq) -= F.segment(n_pv, n_pq);
+        Vm(pq) -= F.segment(n_pv + n_pq, n_pq);
+    }
+    const cplx_type m_i = BaseNRAlgo<LinearSolver>::my_i;  // otherwise it does not compile
+    CplxVect V_pred = Vm.array() * (Va.array().cos().template cast<cplx_type>() + m_i * Va.array().sin().template cast<cplx_type>() );
+
+    BaseNRAlgo<LinearSolver>::_evaluate_Fx(Ybus, V_pred, Sbus, pv, pq, F);
+    if(!F.allFinite() || F.lpNorm<Eigen::Infinity>() >= mismatch_init) return false;
+    V = V_pred;
+    return true;
+}
+
 template<class LinearSolver>
 void BaseNRSingleSlackAlgo<LinearSolver>::fill_jacobian_matrix(const Eigen::SparseMatrix<cplx_type> & Ybus,
                                                                  const CplxVect & V,
@@ -203,45 +277,42 @@ void BaseNRSingleSlackAlgo<LinearSolver>::fill_jacobian_matrix(const Eigen::Spar
     J22 = dS_dVm[array([pq]).T, pq].imag
     **/
 
-    BaseNRAlgo<LinearSolver>::_dSbus_dV(Ybus, V);
-
-    auto timer = CustTimer();
     const int n_pvpq = static_cast<int>(pvpq.size());
     const int n_pq = static_cast<int>(pq.size());
     const int size_j = n_pvpq + n_pq;
-    // TODO to gain a bit more time below, try to compute directly, in _dSbus_dV(Ybus, V);
-    // TODO the `dS_dVa_[pvpq, pvpq]`
-    // TODO so that it's easier to retrieve in the next few lines !
     if(BaseNRAlgo<LinearSolver>::J_.cols() != size_j)
-    // if(true)
     {
         #ifdef __COUT_TIMES
             auto timer2 = CustTimer();
         #endif  // __COUT_TIMES
         // first time i initialized the matrix, so i need to compute its sparsity pattern
+        BaseNRAlgo<LinearSolver>::_dSbus_dV(Ybus, V);
+        auto timer = CustTimer();
         fill_jacobian_matrix_unkown_sparsity_pattern(Ybus, V, pq, pvpq, pq_inv, pvpq_inv);
-        fill_value_map(pq, pvpq, false);
-        // std::cout << "\t\tfill_jacobian_matrix_unkown_sparsity_pattern" << std::endl;
+        BaseNRAlgo<LinearSolver>::fill_scatter_map(Ybus, -1, n_pvpq, pq_inv, pvpq_inv, 0, false);
+        // dS_dVm_ and dS_dVa_ are not used once the sparsity pattern is known
+        BaseNRAlgo<LinearSolver>::dS_dVm_ = Eigen::SparseMatrix<cplx_type>();
+        BaseNRAlgo<LinearSolver>::dS_dVa_ = Eigen::SparseMatrix<cplx_type>();
+        BaseNRAlgo<LinearSolver>::timer_fillJ_ += timer.duration();
         #ifdef __COUT_TIMES
             std::cout << "\t\t fill_jacobian_matrix_unkown_sparsity_pattern : " << timer2.duration() << std::endl;
         #endif  // __COUT_TIMES
     }else{
         // the sparsity pattern of J_ is already known, i can reuse it to fill it
-        // properly and faster (or not...)
+        // properly and faster
         #ifdef __COUT_TIMES
             auto timer3 = CustTimer();
         #endif  // __COUT_TIMES
-        if (BaseNRAlgo<LinearSolver>::value_map_.size() == 0){
-            // std::cout << "\t\tfill_value_map called" << std::endl;
-            fill_value_map(pq, pvpq, true);
+        if (BaseNRAlgo<LinearSolver>::j_scatter_.size() != 4 * static_cast<size_t>(Ybus.nonZeros())){
+            auto timer = CustTimer();
+            BaseNRAlgo<LinearSolver>::fill_scatter_map(Ybus, -1, n_pvpq, pq_inv, pvpq_inv, 0, true);
+            BaseNRAlgo<LinearSolver>::timer_fillJ_ += timer.duration();
         }
-        fill_jacobian_matrix_kown_sparsity_pattern(pq, pvpq);
-        // std::cout << "\t\tfill_jacobian_matrix_kown_sparsity_pattern" << std::endl;
+        BaseNRAlgo<LinearSolver>::fill_jacobian_matrix_kown_sparsity_pattern(Ybus, V);
         #ifdef __COUT_TIMES
             std::cout << "\t\t fill_jacobian_matrix_kown_sparsity_pattern : " << timer3.duration() << std::endl;
         #endif  // __COUT_TIMES
     }
-    BaseNRAlgo<LinearSolver>::timer_fillJ_ += timer.duration();
 }
 
 template<class LinearSolver>
@@ -374,115 +445,3 @@ void BaseNRSingleSlackAlgo<LinearSolver>::fill_jacobian_matrix_unkown_sparsity_p
     // J_.setFromTriplets(coeffs.begin(), coeffs.end());  // HERE FOR PERF OPTIM (3)
     BaseNRAlgo<LinearSolver>::J_.makeCompressed();
 }
-
-/**
-fill the value of the `value_map_` that stores pointers to the elements of
-dS_dVa_ and dS_dVm_ to be used to fill J_
-it requires that J_ is initialized, in compressed mode.
-**/
-template<class LinearSolver>
-void BaseNRSingleSlackAlgo<LinearSolver>::fill_value_map(
-        const Eigen::VectorXi & pq,
-        const Eigen::VectorXi & pvpq,
-        bool reset_J
-        )
-{
-    const int n_pvpq = static_cast<int>(pvpq.size());
-    BaseNRAlgo<LinearSolver>::value_map_.clear();
-    // std::cout << "BaseNRAlgo<LinearSolver>::J_.nonZeros(): " << BaseNRAlgo<LinearSolver>::J_.nonZeros() << std::endl;
-    BaseNRAlgo<LinearSolver>::value_map_.reserve(BaseNRAlgo<LinearSolver>::J_.nonZeros());
-
-    const int n_col = static_cast<int>(BaseNRAlgo<LinearSolver>::J_.cols());
-    // unsigned int pos_el = 0;
-    for (int col_=0; col_ < n_col; ++col_){
-        for (Eigen::SparseMatrix<real_type>::InnerIterator it(BaseNRAlgo<LinearSolver>::J_, col_); it; ++it)
-        {
-            const int row_id = static_cast<int>(it.row());
-            const int col_id = static_cast<int>(it.col());  // it's equal to "col_"
-            if(reset_J) it.valueRef() = 0.; // "forget" previous J value in this setting
-            // real_type & this_el = J_x_ptr[pos_el];
-            if((col_id < n_pvpq) && (row_id < n_pvpq)){
-                // this is the J11 part (dS_dVa_r)
-                const int row_id_dS_dVa_r = pvpq[row_id];
-                const int col_id_dS_dVa_r = pvpq[col_id];
-                // this_el = dS_dVa_r.coeff(row_id_dS_dVa_r, col_id_dS_dVa_r);
-                BaseNRAlgo<LinearSolver>::value_map_.push_back(&BaseNRAlgo<LinearSolver>::dS_dVa_.coeffRef(row_id_dS_dVa_r, col_id_dS_dVa_r));
-
-                // I don't need to perform these checks: if they failed, the element would not be in J_ in the first place
-                // const int is_row_non_null = pq_inv[row_id_dS_dVa_r];
-                // const int is_col_non_null = pq_inv[col_id_dS_dVa_r];
-                // if(is_row_non_null >= 0 && is_col_non_null >= 0)
-                //     this_el = dS_dVa_r.coeff(row_id_dS_dVa_r, col_id_dS_dVa_r);
-                // else
-                //     std::cout << "dS_dVa_r: missed" << std::endl;
-
-            }else if((col_id < n_pvpq) && (row_id >= n_pvpq)){
-                // this is the J21 part (dS_dVa_i)
-                const int row_id_dS_dVa_i = pq[row_id - n_pvpq];
-                const int col_id_dS_dVa_i = pvpq[col_id];
-                // this_el = dS_dVa_i.coeff(row_id_dS_dVa_i, col_id_dS_dVa_i);
-                BaseNRAlgo<LinearSolver>::value_map_.push_back(&BaseNRAlgo<LinearSolver>::dS_dVa_.coeffRef(row_id_dS_dVa_i, col_id_dS_dVa_i));
-            }else if((col_id >= n_pvpq) && (row_id < n_pvpq)){
-                // this is the J12 part (dS_dVm_r)
-                const int row_id_dS_dVm_r = pvpq[row_id];
-                const int col_id_dS_dVm_r = pq[col_id - n_pvpq];
-                // this_el = dS_dVm_r.coeff(row_id_dS_dVm_r, col_id_dS_dVm_r);
-                BaseNRAlgo<LinearSolver>::value_map_.push_back(&BaseNRAlgo<LinearSolver>::dS_dVm_.coeffRef(row_id_dS_dVm_r, col_id_dS_dVm_r));
-            }else if((col_id >= n_pvpq) && (row_id >= n_pvpq)){
-                // this is the J22 part (dS_dVm_i)
-                const int row_id_dS_dVm_i = pq[row_id - n_pvpq];
-                const int col_id_dS_dVm_i = pq[col_id - n_pvpq];
-                // this_el = dS_dVm_i.coeff(row_id_dS_dVm_i, col_id_dS_dVm_i);
-                BaseNRAlgo<LinearSolver>::value_map_.push_back(&BaseNRAlgo<LinearSolver>::dS_dVm_.coeffRef(row_id_dS_dVm_i, col_id_dS_dVm_i));
-            }
-
-            // go to the next element
-            // ++pos_el;
-        }
-    }
-    // BaseNRAlgo<LinearSolver>::dS_dVa_.makeCompressed();
-    // BaseNRAlgo<LinearSolver>::dS_dVm_.makeCompressed();
-}
-
-template<class LinearSolver>
-void BaseNRSingleSlackAlgo<LinearSolver>::fill_jacobian_matrix_kown_sparsity_pattern(
-        const Eigen::VectorXi & pq,
-        const Eigen::VectorXi & pvpq
-    )
-{
-    /**
-    This functions fills the jacobian matrix when its sparsity pattern is KNOWN in advance (typically
-    the second and next iterations of the Newton Raphson)
-    We don't need to perform heavy computation but just to read the right data from the right matrix!
-    This function is optimized for speed. In particular, it does not "uncompress" the J_ matrix and only
-    change the value pointer (not the inner nor outer pointer)
-    It is optimized only if J_ is in default Eigen format (column)
-    Remember:
-    J has the shape
-    | J11 | J12 |               | (pvpq, pvpq) | (pvpq, pq) |
-    | --------- | = dimensions: | ------------------------- |
-    | J21 | J22 |               |  (pq, pvpq)  | (pq, pq) |
-    python implementation:
-    J11 = dS_dVa[array([pvpq]).T, pvpq].real
-    J12 = dS_dVm[array([pvpq]).T, pq].real
-    J21 = dS_dVa[array([pq]).T, pvpq].imag
-    J22 = dS_dVm[array([pq]).T, pq].imag
-    **/
-
-    const int n_pvpq = static_cast<int>(pvpq.size());
-
-    // real_type * J_x_ptr = J_.valuePtr();
-    const int n_cols = static_cast<int>(BaseNRAlgo<LinearSolver>::J_.cols());  // equal to nrow
-    unsigned int pos_el = 0;
-    for (int col_id=0; col_id < n_cols; ++col_id){
-        for (Eigen::SparseMatrix<real_type>::InnerIterator it(BaseNRAlgo<LinearSolver>::J_, col_id); it; ++it)
-        {
-            const auto row_id = it.row();
-            // only one if is necessary (magic !)
-            // top rows are "real" part and bottom rows are imaginary part (you can check)
-            it.valueRef() = row_id < n_pvpq ? std::real(*BaseNRAlgo<LinearSolver>::value_map_[pos_el]) : std::imag(*BaseNRAlgo<LinearSolver>::value_map_[pos_el]);
-            // go to the next element
-            ++pos_el;
-        }
-    }
-}
@@ -38,7 +38,8 @@ bool GaussSeidelAlgo::compute_pf(const Eigen::SparseMatrix<cplx_type> & Ybus,
     Va_ = V_.array().arg();  // we wrapped around with a negative Vm
 
     // first check, if the problem is already solved, i stop there
-    RealVect F = _evaluate_Fx(Ybus, V, Sbus, my_pv, pq);
+    RealVect F;
+    _evaluate_Fx(Ybus, V, Sbus, my_pv, pq, F);
     bool converged = _check_for_convergence(F, tol);
     nr_iter_ = 0; //current step
     bool res = true;  // have i converged or not
@@ -60,7 +61,7 @@ bool GaussSeidelAlgo::compute_pf(const Eigen::SparseMatrix<cplx_type> & Ybus,
         // #####################
         // stopping criteria
         // #####################
-        F = _evaluate_Fx(Ybus, V_, tmp_Sbus, my_pv, pq);
+        _evaluate_Fx(Ybus, V_, tmp_Sbus, my_pv, pq, F);
         bool tmp = F.allFinite();
         if(!tmp){
             err_ = ErrorType::InifiniteValue;